@@ -5,6 +5,10 @@ int main(int argc, char** argv) {
     // Initialize GTK first
     gtk_init(&argc, &argv);
 
+    // The splash reads the application ID from the program name, the
+    // application is only created afterwards
+    g_set_prgname(APPLICATION_ID);
+
     // So can safely show the splash screen
     show_splash_screen();
 
@@ -2,6 +2,8 @@
 set(SPLASH_SCREEN_FILE_DEBUG "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_debug.cc")
 set(SPLASH_SCREEN_FILE_RELEASE "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_release.cc")
 set(SPLASH_SCREEN_FILE_PROFILE "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_profile.cc")
+set(SPLASH_SCREEN_FILE_TILES "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_tiles.cc")
+set(SPLASH_SCREEN_FILE_FLAVORS "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_flavors.cc")
 
 # Validate that all expected files exist
 foreach(CONFIG_TYPE IN ITEMS DEBUG RELEASE PROFILE)
@@ -27,6 +29,56 @@ target_sources(native_splash_screen_linux
     "$<IF:$<CONFIG:Debug>,${SPLASH_SCREEN_FILE_DEBUG},$<IF:$<CONFIG:Profile>,${SPLASH_SCREEN_FILE_PROFILE},${SPLASH_SCREEN_FILE_RELEASE}>>"
 )
 
+# Tiles shared by every flavor, only generated when they make the images smaller
+if(EXISTS "${SPLASH_SCREEN_FILE_TILES}")
+  target_sources(native_splash_screen_linux PRIVATE "${SPLASH_SCREEN_FILE_TILES}")
+endif()
+
+# Flavors selected when the app starts, only generated with runtime_flavors.
+# Compiled into the plugin itself rather than archived: the plugin has a weak
+# default for their index, so the linker would never pull them from the
+# library
+if(EXISTS "${SPLASH_SCREEN_FILE_FLAVORS}")
+  target_sources(native_splash_screen_linux INTERFACE "${SPLASH_SCREEN_FILE_FLAVORS}")
+endif()
+
+# Compile-time copy of the settings of the built flavor, read by the plugin
+# instead of the generated globals. Sources generated by older versions of
+# native_splash_screen_cli do not come with it.
+set(SPLASH_SCREEN_CONFIG_HEADERS_FOUND TRUE)
+foreach(CONFIG_TYPE IN ITEMS debug profile release)
+  if(NOT EXISTS "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_${CONFIG_TYPE}.h")
+    set(SPLASH_SCREEN_CONFIG_HEADERS_FOUND FALSE)
+  endif()
+endforeach()
+if(SPLASH_SCREEN_CONFIG_HEADERS_FOUND)
+  target_compile_definitions(native_splash_screen_linux INTERFACE
+    "NATIVE_SPLASH_SCREEN_CONFIG_HEADER=\"native_splash_screen_$<IF:$<CONFIG:Debug>,debug,$<IF:$<CONFIG:Profile>,profile,release>>.h\""
+  )
+endif()
+
+# Image assets of the flavors storing their image in a file, installed in the
+# bundle data directory where the plugin maps them from
+foreach(CONFIG_TYPE IN ITEMS Debug Profile Release)
+  string(TOLOWER "${CONFIG_TYPE}" CONFIG_TYPE_LOWER)
+  set(SPLASH_SCREEN_ASSET "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_${CONFIG_TYPE_LOWER}.nss")
+  if(EXISTS "${SPLASH_SCREEN_ASSET}")
+    install(FILES "${SPLASH_SCREEN_ASSET}" DESTINATION "data"
+      RENAME "splash.nss" CONFIGURATIONS ${CONFIG_TYPE} COMPONENT Runtime)
+  endif()
+
+  # HiDPI variants, e.g. native_splash_screen_release@2x.nss as splash@2x.nss
+  file(GLOB SPLASH_SCREEN_VARIANTS
+    "${CMAKE_CURRENT_SOURCE_DIR}/native_splash_screen_${CONFIG_TYPE_LOWER}@*x.nss")
+  foreach(SPLASH_SCREEN_VARIANT IN LISTS SPLASH_SCREEN_VARIANTS)
+    get_filename_component(SPLASH_SCREEN_VARIANT_NAME "${SPLASH_SCREEN_VARIANT}" NAME)
+    string(REGEX REPLACE "^native_splash_screen_[a-z]+" "splash"
+      SPLASH_SCREEN_VARIANT_NAME "${SPLASH_SCREEN_VARIANT_NAME}")
+    install(FILES "${SPLASH_SCREEN_VARIANT}" DESTINATION "data"
+      RENAME "${SPLASH_SCREEN_VARIANT_NAME}" CONFIGURATIONS ${CONFIG_TYPE} COMPONENT Runtime)
+  endforeach()
+endforeach()
+
 # Set properties for the library
 set_target_properties(native_splash_screen_linux PROPERTIES
   CXX_STANDARD 17
@@ -26,6 +26,12 @@ bool native_splash_screen_with_animation = true;
 int native_splash_screen_image_width = 500;
 int native_splash_screen_image_height = 250;
 
+// Image placement inside its untrimmed canvas
+int native_splash_screen_image_offset_x = 0;
+int native_splash_screen_image_offset_y = 0;
+int native_splash_screen_image_canvas_width = 500;
+int native_splash_screen_image_canvas_height = 250;
+
 // Raw image data in (ARGB) format
 const uint32_t native_splash_screen_image_data[125000] = {
   0xFF000000,  0xFF000000,  0xFF000000,  0xFF000000,
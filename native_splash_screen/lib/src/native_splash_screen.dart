@@ -47,3 +47,52 @@ NativeSplashScreenPlatform get _platform => NativeSplashScreenPlatform.instance;
 Future<void> close({required CloseAnimation animation}) async {
   return _platform.close(animation: animation);
 }
+
+/// Returns the metrics recorded by the native splash screen.
+///
+/// Values are keyed by name, platforms that do not record metrics return an
+/// empty map. On Linux, once the splash screen is closed:
+///
+/// - `rss_before_release`: resident memory of the process in bytes, before
+///   the splash image resources were released.
+/// - `rss_after_release`: resident memory of the process in bytes, after
+///   they were released.
+///
+/// And while it is shown:
+///
+/// - `flavor_index`: index of the embedded flavor selected at runtime, when
+///   one was requested and found.
+/// - `dark_theme`: 1 if the desktop prefers a dark appearance, only checked
+///   when the splash has a dark image.
+/// - `cache_hit`: 1 if the splash composed by a previous launch was reused.
+/// - `opaque_visual`: 1 if the window skipped its alpha channel on a
+///   compositing screen, because the splash is fully opaque.
+/// - `image_scale`: scale factor of the image variant that was loaded.
+/// - `image_resample_us`: time spent resampling that variant to the scale of
+///   the display, when none matched it.
+/// - `image_rasterize_us`: time spent drawing an SVG image at the scale of
+///   the display.
+/// - `image_effects_us`: time spent drawing the blur and the drop shadow of
+///   the image, when it has any.
+/// - `animation_frames`: number of frames of the animation, when the splash
+///   has one.
+/// - `animation_decode_us`: time spent parsing the animation and inflating
+///   its first frame.
+/// - `spinner_atlas_us`: time spent drawing the pre-rotated frames of the
+///   spinner.
+///
+/// When the `NATIVE_SPLASH_SCREEN_VISUAL_BENCHMARK` environment variable
+/// holds a number of frames, on a compositing screen, the splash repaints
+/// its whole window for that many frames with the visual it picked, then
+/// again with the other one, and records for each `<visual>`, `rgba` or
+/// `system`:
+///
+/// - `visual_benchmark_<visual>_frames`: frames whose presentation time the
+///   compositor reported.
+/// - `visual_benchmark_<visual>_latency_us`: mean time from the start of a
+///   frame to its presentation.
+/// - `visual_benchmark_<visual>_interval_us`: mean time between two
+///   presented frames.
+Future<Map<String, int>> getMetrics() async {
+  return _platform.getMetrics();
+}
@@ -85,6 +85,11 @@ void main(List<String> arguments) async {
       abbr: 'f',
       help: 'Build flavor to use (replaces release flavor)',
       defaultsTo: 'release',
+    )
+    ..addFlag(
+      'force',
+      negatable: false,
+      help: 'Regenerate the sources even if their inputs did not change.',
     );
 
   // Logger setup
@@ -175,8 +180,9 @@ void main(List<String> arguments) async {
         customFlavor = flavorName;
       }
 
+      final force = argResults.command!['force'] as bool? ?? false;
       final config = generator.parse(configPath, customFlavor);
-      final _ = await generator.generate(config: config);
+      final _ = await generator.generate(config: config, force: force);
       return;
     }
     throw Exception('Unknown subcommand: ${argResults.command!.name}');
@@ -1,3 +1,7 @@
 const RELEASE = 'release';
 const PROFILE = 'profile';
 const DEBUG = 'debug';
+
+/// Version of the generator, part of the hash of the generated sources so
+/// upgrading the CLI regenerates them. Keep in sync with pubspec.yaml.
+const GENERATOR_VERSION = '3.0.0';
@@ -215,6 +215,29 @@ String colorHex(Color color) {
       .toUpperCase();
 }
 
+/// Offset basis of [fnv1a64], 0xCBF29CE484222325 as a signed 64-bit integer
+const int fnv1a64Offset = -0x340D631B7BDDDCDB;
+
+/// 64-bit FNV-1a hash of [bytes]
+///
+/// Pass the result of a previous call as [hash] to hash several inputs
+/// as one.
+int fnv1a64(List<int> bytes, [int hash = fnv1a64Offset]) {
+  for (final byte in bytes) {
+    hash = (hash ^ (byte & 0xFF)) * 0x100000001B3;
+  }
+  return hash;
+}
+
+/// Formats a 64-bit integer as 16 unsigned hexadecimal digits
+String hex64(int value) {
+  return BigInt.from(value)
+      .toUnsigned(64)
+      .toRadixString(16)
+      .padLeft(16, '0')
+      .toUpperCase();
+}
+
 extension StringCasingExtension on String {
   /// Capitalizes the first letter of the string.
   ///
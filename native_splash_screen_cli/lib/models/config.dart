@@ -7,13 +7,16 @@ class SplashScreenConfig {
   final Flavor debug;
   final Flavor profile;
   Flavor fallback;
-  // final List<Flavor>? custom;
+
+  /// Custom flavors of the `flavors` section, only parsed when a platform
+  /// embeds them all
+  final List<Flavor> custom;
   SplashScreenConfig({
     required this.platforms,
     required this.release,
     required this.debug,
     required this.profile,
     required this.fallback,
-    // this.custom,
+    this.custom = const [],
   });
 }
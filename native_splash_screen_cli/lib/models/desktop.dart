@@ -1,4 +1,13 @@
-import 'package:image/image.dart' show Color;
+import 'package:image/image.dart' show Color, ColorRgba8;
+
+import '../common/utils.dart';
+
+/// Gradient applied to the background rectangle.
+enum BackgroundGradient { none, linear, radial }
+
+/// Where the image pixels are stored, either compiled into the binary or in
+/// an asset file loaded at runtime.
+enum ImageStorage { embedded, file }
 
 class DesktopSplashConfig {
   final bool withAnimation;
@@ -8,15 +17,57 @@ class DesktopSplashConfig {
   final String windowClass;
   final Color windowColor;
   final String imagePath;
+
+  /// Image shown instead of [imagePath] when the desktop prefers a dark
+  /// appearance (Linux only)
+  final String? imagePathDark;
+
+  /// Animation played over the splash (Linux only): a single animated
+  /// GIF, APNG or WebP file, or the frames of an image sequence in order
+  final List<String> animationPaths;
+
+  /// Milliseconds each frame of [animationPaths] is shown when it does not
+  /// come with a duration of its own
+  final int animationFrameDuration;
+  final int animationWidth;
+  final int animationHeight;
+  final bool animationLoop;
+
+  /// Size of the loading spinner drawn by the plugin (Linux only), 0 for
+  /// none. It is centered horizontally in the background rectangle,
+  /// [spinnerOffsetY] below its center, or below the image when null
+  final int spinnerSize;
+  final Color spinnerColor;
+  final int? spinnerOffsetY;
+
+  /// Milliseconds per revolution of the spinner
+  final int spinnerPeriod;
+
+  /// Number of pre-rotated frames of the spinner
+  final int spinnerFrames;
   final int imageWidth;
   final int imageHeight;
   final double imageBorderRadius;
   final double imageBlurRadius;
+
+  /// Drop shadow of the image drawn by the plugin from its alpha (Linux
+  /// only), none when fully transparent. A glow is a light shadow that is
+  /// not offset
+  final Color imageShadowColor;
+  final double imageShadowRadius;
+  final int imageShadowOffsetX;
+  final int imageShadowOffsetY;
+  final int imageQuantizeTolerance;
+  final ImageStorage imageStorage;
+  final List<int> imageScales;
   final bool imageScaling;
   final Color backgroundColor;
   final int backgroundWidth;
   final int backgroundHeight;
   final double backgroundBorderRadius;
+  final BackgroundGradient backgroundGradient;
+  final Color backgroundGradientColor;
+  final double backgroundGradientAngle;
   DesktopSplashConfig({
     required this.windowWidth,
     required this.windowHeight,
@@ -24,6 +75,17 @@ class DesktopSplashConfig {
     required this.windowClass,
     required this.windowColor,
     required this.imagePath,
+    this.imagePathDark,
+    this.animationPaths = const [],
+    this.animationFrameDuration = 100,
+    this.animationWidth = 0,
+    this.animationHeight = 0,
+    this.animationLoop = true,
+    this.spinnerSize = 0,
+    Color? spinnerColor,
+    this.spinnerOffsetY,
+    this.spinnerPeriod = 1000,
+    this.spinnerFrames = 30,
     required this.imageWidth,
     required this.imageHeight,
     required this.imageBorderRadius,
@@ -34,7 +96,20 @@ class DesktopSplashConfig {
     required this.backgroundBorderRadius,
     required this.withAnimation,
     required this.imageBlurRadius,
-  });
+    Color? imageShadowColor,
+    this.imageShadowRadius = 0.0,
+    this.imageShadowOffsetX = 0,
+    this.imageShadowOffsetY = 0,
+    this.imageQuantizeTolerance = 0,
+    this.imageStorage = ImageStorage.embedded,
+    this.imageScales = const [1],
+    this.backgroundGradient = BackgroundGradient.none,
+    Color? backgroundGradientColor,
+    this.backgroundGradientAngle = 90.0,
+  })  : backgroundGradientColor =
+            backgroundGradientColor ?? ColorRgba8(0, 0, 0, 0),
+        spinnerColor = spinnerColor ?? ColorRgba8(0x80, 0x80, 0x80, 0xFF),
+        imageShadowColor = imageShadowColor ?? ColorRgba8(0, 0, 0, 0);
   DesktopSplashConfig copyWith({
     int? windowWidth,
     int? windowHeight,
@@ -42,16 +117,37 @@ class DesktopSplashConfig {
     String? windowClass,
     Color? windowColor,
     String? imagePath,
+    String? imagePathDark,
+    List<String>? animationPaths,
+    int? animationFrameDuration,
+    int? animationWidth,
+    int? animationHeight,
+    bool? animationLoop,
+    int? spinnerSize,
+    Color? spinnerColor,
+    int? spinnerOffsetY,
+    int? spinnerPeriod,
+    int? spinnerFrames,
     int? imageWidth,
     int? imageHeight,
     double? imageBorderRadius,
     double? imageBlurRadius,
+    Color? imageShadowColor,
+    double? imageShadowRadius,
+    int? imageShadowOffsetX,
+    int? imageShadowOffsetY,
+    int? imageQuantizeTolerance,
+    ImageStorage? imageStorage,
+    List<int>? imageScales,
     bool? imageScaling,
     Color? backgroundColor,
     int? backgroundWidth,
     int? backgroundHeight,
     double? backgroundBorderRadius,
     bool? withAnimation,
+    BackgroundGradient? backgroundGradient,
+    Color? backgroundGradientColor,
+    double? backgroundGradientAngle,
   }) {
     return DesktopSplashConfig(
       windowWidth: windowWidth ?? this.windowWidth,
@@ -60,6 +156,18 @@ class DesktopSplashConfig {
       windowClass: windowClass ?? this.windowClass,
       windowColor: windowColor ?? this.windowColor,
       imagePath: imagePath ?? this.imagePath,
+      imagePathDark: imagePathDark ?? this.imagePathDark,
+      animationPaths: animationPaths ?? this.animationPaths,
+      animationFrameDuration:
+          animationFrameDuration ?? this.animationFrameDuration,
+      animationWidth: animationWidth ?? this.animationWidth,
+      animationHeight: animationHeight ?? this.animationHeight,
+      animationLoop: animationLoop ?? this.animationLoop,
+      spinnerSize: spinnerSize ?? this.spinnerSize,
+      spinnerColor: spinnerColor ?? this.spinnerColor,
+      spinnerOffsetY: spinnerOffsetY ?? this.spinnerOffsetY,
+      spinnerPeriod: spinnerPeriod ?? this.spinnerPeriod,
+      spinnerFrames: spinnerFrames ?? this.spinnerFrames,
       imageWidth: imageWidth ?? this.imageWidth,
       imageHeight: imageHeight ?? this.imageHeight,
       imageBorderRadius: imageBorderRadius ?? this.imageBorderRadius,
@@ -71,6 +179,61 @@ class DesktopSplashConfig {
           backgroundBorderRadius ?? this.backgroundBorderRadius,
       withAnimation: withAnimation ?? this.withAnimation,
       imageBlurRadius: imageBlurRadius ?? this.imageBlurRadius,
+      imageShadowColor: imageShadowColor ?? this.imageShadowColor,
+      imageShadowRadius: imageShadowRadius ?? this.imageShadowRadius,
+      imageShadowOffsetX: imageShadowOffsetX ?? this.imageShadowOffsetX,
+      imageShadowOffsetY: imageShadowOffsetY ?? this.imageShadowOffsetY,
+      imageQuantizeTolerance:
+          imageQuantizeTolerance ?? this.imageQuantizeTolerance,
+      imageStorage: imageStorage ?? this.imageStorage,
+      imageScales: imageScales ?? this.imageScales,
+      backgroundGradient: backgroundGradient ?? this.backgroundGradient,
+      backgroundGradientColor:
+          backgroundGradientColor ?? this.backgroundGradientColor,
+      backgroundGradientAngle:
+          backgroundGradientAngle ?? this.backgroundGradientAngle,
     );
   }
+
+  /// Every setting as text, one per line, identifying the generated output
+  /// along with the image bytes
+  String get fingerprint => [
+        withAnimation,
+        windowWidth,
+        windowHeight,
+        windowTitle,
+        windowClass,
+        colorHex(windowColor),
+        imagePath,
+        imagePathDark ?? '',
+        animationPaths.join(','),
+        animationFrameDuration,
+        animationWidth,
+        animationHeight,
+        animationLoop,
+        spinnerSize,
+        colorHex(spinnerColor),
+        spinnerOffsetY ?? '',
+        spinnerPeriod,
+        spinnerFrames,
+        imageWidth,
+        imageHeight,
+        imageBorderRadius,
+        imageBlurRadius,
+        colorHex(imageShadowColor),
+        imageShadowRadius,
+        imageShadowOffsetX,
+        imageShadowOffsetY,
+        imageQuantizeTolerance,
+        imageStorage.name,
+        imageScales.join(','),
+        imageScaling,
+        colorHex(backgroundColor),
+        backgroundWidth,
+        backgroundHeight,
+        backgroundBorderRadius,
+        backgroundGradient.name,
+        colorHex(backgroundGradientColor),
+        backgroundGradientAngle,
+      ].join('\n');
 }
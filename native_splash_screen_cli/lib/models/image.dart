@@ -1,20 +1,97 @@
-import 'dart:typed_data' show Uint8List;
+import 'dart:typed_data' show Uint8List, Uint32List;
 
 import 'package:image/image.dart' as img;
 
 /// A wrapper for an BGRA image with metadata.
+///
+/// When the transparent borders of the image were trimmed away, [data] only
+/// holds the visible rectangle, placed at ([offsetX], [offsetY]) inside a
+/// canvas of [canvasWidth] x [canvasHeight] pixels.
+///
+/// [original] is only available when the image went through the Dart
+/// pipeline, the native asset compiler only returns the pixels.
 class BGRAImage {
   final Uint8List data;
   final int width;
   final int height;
-  final img.Image original;
+  final img.Image? original;
+  final int offsetX;
+  final int offsetY;
+  final int canvasWidth;
+  final int canvasHeight;
 
   BGRAImage({
     required this.data,
     required this.width,
     required this.height,
-    required this.original,
+    this.original,
+    this.offsetX = 0,
+    this.offsetY = 0,
+    int? canvasWidth,
+    int? canvasHeight,
+  })  : canvasWidth = canvasWidth ?? width,
+        canvasHeight = canvasHeight ?? height;
+}
+
+/// A frame of an animation, shown for [duration] milliseconds.
+///
+/// Every frame covers the whole animation, whatever the source format
+/// stores.
+class AnimationFrame {
+  final BGRAImage image;
+  final int duration;
+
+  AnimationFrame(this.image, this.duration);
+}
+
+/// An SVG image compiled to the display list of vector operations the Linux
+/// plugin draws at the scale of the display, [width] x [height] logical
+/// pixels large.
+class VectorImage {
+  final Uint8List data;
+  final int width;
+  final int height;
+
+  VectorImage({required this.data, required this.width, required this.height});
+}
+
+/// An image stored as one byte per pixel indexing an ARGB [palette].
+class IndexedImage {
+  final Uint8List indices;
+  final Uint32List palette;
+
+  IndexedImage({required this.indices, required this.palette});
+}
+
+/// Images split into square tiles, each unique tile being stored once.
+///
+/// [tiles] holds the BGRA pixels of every unique tile, one after the other.
+/// [maps] has one entry per tile of each image, row by row: either the index
+/// of the tile in [tiles], or [solidTile] ored with the index of its color
+/// in [colors] when the whole tile has a single color.
+class TileSet {
+  static const int solidTile = 0x80000000;
+
+  final int tileSize;
+  final Uint8List tiles;
+  final Uint32List colors;
+  final List<Uint32List> maps;
+
+  TileSet({
+    required this.tileSize,
+    required this.tiles,
+    required this.colors,
+    required this.maps,
   });
+
+  /// Number of unique tiles in [tiles]
+  int get tileCount => tiles.length ~/ (tileSize * tileSize * 4);
+
+  /// Number of bytes embedded for all the images together
+  int get byteSize =>
+      tiles.length +
+      colors.length * 4 +
+      maps.fold(0, (size, map) => size + map.length * 4);
 }
 
 /// Position class for placement calculations
@@ -45,7 +45,16 @@ class Platform {
   final String path;
   final bool? fallback;
 
-  Platform({this.enabled = false, required this.path, this.fallback = false});
+  /// Whether every custom flavor is embedded in the binary, selected when the
+  /// app starts instead of when it is built (Linux only)
+  final bool runtimeFlavors;
+
+  Platform({
+    this.enabled = false,
+    required this.path,
+    this.fallback = false,
+    this.runtimeFlavors = false,
+  });
 
   bool get canFall {
     return fallback ?? false;
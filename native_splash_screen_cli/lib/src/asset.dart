@@ -0,0 +1,201 @@
+import 'dart:io' show ZLibCodec;
+import 'dart:math' show max, min;
+import 'dart:typed_data';
+
+import '../models/image.dart';
+
+/// Version of the `.nss` splash asset layout written by [encodeSplashAsset]
+const int splashAssetVersion = 1;
+
+/// Size of the fixed header at the start of a splash asset
+const int splashAssetHeaderSize = 64;
+
+/// Alignment of the pixel data, so the plugin can use it from a mapping
+const int splashAssetDataAlignment = 4096;
+
+/// Encodes [image] as a `.nss` splash asset loaded by the Linux plugin.
+///
+/// The file holds a 64 bytes little-endian header (magic "NSSA", version,
+/// format, compression, dimensions, placement, palette size, data offset and
+/// sizes, checksum), the palette of [indexed] images, then the pixel data at
+/// a page aligned offset.
+///
+/// The pixel data is zlib compressed when that at least halves its size, or
+/// always when [compress] is set, otherwise it is stored as is so the plugin
+/// can hand the mapping to cairo without a copy. Assets that are never
+/// mapped can use a smaller data [alignment].
+Uint8List encodeSplashAsset(
+  BGRAImage image,
+  IndexedImage? indexed, {
+  bool compress = false,
+  int alignment = splashAssetDataAlignment,
+}) {
+  final raw = indexed != null ? indexed.indices : image.data;
+  final palette = indexed?.palette ?? Uint32List(0);
+
+  final compressed = ZLibCodec(level: 9).encode(raw);
+  final useZlib = compress || compressed.length * 2 <= raw.length;
+  final data = useZlib ? Uint8List.fromList(compressed) : raw;
+
+  final paletteEnd = splashAssetHeaderSize + palette.length * 4;
+  final dataOffset = (paletteEnd + alignment - 1) ~/ alignment * alignment;
+
+  final output = Uint8List(dataOffset + data.length);
+  final header = ByteData.sublistView(output, 0, splashAssetHeaderSize);
+  output.setRange(0, 4, 'NSSA'.codeUnits);
+
+  final fields = [
+    splashAssetVersion,
+    indexed != null ? 1 : 0, // Pixel format
+    useZlib ? 1 : 0, // Compression
+    image.width,
+    image.height,
+    image.offsetX,
+    image.offsetY,
+    image.canvasWidth,
+    image.canvasHeight,
+    palette.length,
+    dataOffset,
+    data.length,
+    raw.length,
+    _fnv1a32(data),
+  ];
+  for (int i = 0; i < fields.length; i++) {
+    header.setUint32(4 + i * 4, fields[i], Endian.little);
+  }
+
+  final paletteView = ByteData.sublistView(output, splashAssetHeaderSize);
+  for (int i = 0; i < palette.length; i++) {
+    paletteView.setUint32(i * 4, palette[i], Endian.little);
+  }
+
+  output.setRange(dataOffset, output.length, data);
+  return output;
+}
+
+/// 32-bit FNV-1a hash of [data]
+int _fnv1a32(List<int> data) {
+  int hash = 0x811C9DC5;
+  for (final byte in data) {
+    hash = ((hash ^ byte) * 0x01000193) & 0xFFFFFFFF;
+  }
+  return hash;
+}
+
+/// Version of the animation layout written by [encodeSplashAnimation]
+const int splashAnimationVersion = 1;
+
+/// Size of the fixed header at the start of an animation
+const int _animationHeaderSize = 32;
+
+/// Size of every entry of the frame table of an animation
+const int _animationFrameSize = 32;
+
+/// Encodes [frames] as the animation played by the Linux plugin.
+///
+/// The blob holds a 32 bytes little-endian header (magic "NSSM", version,
+/// dimensions, frame count, loop count, frame table offset, reserved), one
+/// 32 bytes entry per frame (duration, flags, dirty rectangle, data offset
+/// and size), then the data of the frames: the zlib compressed rows of their
+/// dirty rectangle, the bounding box of the pixels that differ from the
+/// frame before. The first frame is a keyframe covering the whole animation,
+/// like any frame where everything changed.
+///
+/// Frames identical to the one before only extend its duration. The
+/// animation plays [loopCount] times, or forever when it is 0.
+Uint8List encodeSplashAnimation(
+  List<AnimationFrame> frames, {
+  int loopCount = 0,
+}) {
+  final width = frames.first.image.width;
+  final height = frames.first.image.height;
+  final codec = ZLibCodec(level: 9);
+
+  final entries = <List<int>>[];
+  final chunks = <List<int>>[];
+  Uint32List? previous;
+  for (final frame in frames) {
+    final data = frame.image.data;
+    final pixels = data.buffer.asUint32List(data.offsetInBytes, width * height);
+    final rect = previous == null
+        ? (0, 0, width, height)
+        : _dirtyRect(previous, pixels, width, height);
+    previous = pixels;
+    if (rect == null) {
+      entries.last[0] += frame.duration;
+      continue;
+    }
+
+    final (x, y, w, h) = rect;
+    final rows = BytesBuilder(copy: false);
+    for (int row = y; row < y + h; row++) {
+      final start = (row * width + x) * 4;
+      rows.add(Uint8List.sublistView(data, start, start + w * 4));
+    }
+    final compressed = codec.encode(rows.takeBytes());
+
+    final keyframe = w == width && h == height;
+    entries.add([frame.duration, keyframe ? 1 : 0, x, y, w, h, 0, 0]);
+    chunks.add(compressed);
+  }
+
+  int offset = _animationHeaderSize + entries.length * _animationFrameSize;
+  final size = chunks.fold(offset, (size, chunk) => size + chunk.length);
+  final output = Uint8List(size);
+  final view = ByteData.sublistView(output);
+  output.setRange(0, 4, 'NSSM'.codeUnits);
+
+  final fields = [
+    splashAnimationVersion,
+    width,
+    height,
+    entries.length,
+    loopCount,
+    _animationHeaderSize, // Frame table offset
+  ];
+  for (int i = 0; i < fields.length; i++) {
+    view.setUint32(4 + i * 4, fields[i], Endian.little);
+  }
+
+  for (int i = 0; i < entries.length; i++) {
+    final entry = entries[i];
+    entry[6] = offset;
+    entry[7] = chunks[i].length;
+    for (int j = 0; j < entry.length; j++) {
+      view.setUint32(
+        _animationHeaderSize + i * _animationFrameSize + j * 4,
+        entry[j],
+        Endian.little,
+      );
+    }
+    output.setRange(offset, offset + chunks[i].length, chunks[i]);
+    offset += chunks[i].length;
+  }
+  return output;
+}
+
+/// Bounding box of the pixels that differ between [a] and [b], as (x, y,
+/// width, height), or null when they are identical
+(int, int, int, int)? _dirtyRect(
+  Uint32List a,
+  Uint32List b,
+  int width,
+  int height,
+) {
+  int left = width, top = height, right = -1, bottom = -1;
+  for (int y = 0; y < height; y++) {
+    final row = y * width;
+    for (int x = 0; x < width; x++) {
+      if (a[row + x] != b[row + x]) {
+        left = min(left, x);
+        right = max(right, x);
+        top = min(top, y);
+        bottom = y;
+      }
+    }
+  }
+  if (right < 0) {
+    return null;
+  }
+  return (left, top, right - left + 1, bottom - top + 1);
+}
@@ -93,7 +93,9 @@ class SplashScreenGenerator {
 
     // Parse custom flavors if they exist
     List<Flavor> customFlavors = [];
-    if (custom != null &&
+    final runtimeFlavors =
+        platforms.hasLinux && platforms.linux!.runtimeFlavors;
+    if ((custom != null || runtimeFlavors) &&
         yaml.containsKey('flavors') &&
         yaml['flavors'] is YamlMap) {
       // if (custom != null && yaml.containsKey('flavors')) {
@@ -180,6 +182,7 @@ class SplashScreenGenerator {
       debug: debug,
       profile: profile,
       fallback: fallback,
+      custom: runtimeFlavors ? customFlavors : const [],
     );
   }
 
@@ -200,6 +203,7 @@ class SplashScreenGenerator {
         enabled: map['enabled'] as bool? ?? false,
         fallback: map['fallback'] as bool? ?? false,
         path: map['path'] as String? ?? path,
+        runtimeFlavors: map['runtime_flavors'] as bool? ?? false,
       );
     }
 
@@ -281,10 +285,21 @@ class SplashScreenGenerator {
   }
 
   /// Generate code for all build modes (release, debug, profile)
-  Future<void> generate({required SplashScreenConfig config}) async {
-    await handleLinux(config, verbose);
-    await handleWindows(config, verbose);
-    await handleMacos(config, verbose);
+  ///
+  /// Sources generated from the same inputs are kept as they are, unless
+  /// [force] is set.
+  ///
+  /// The platforms are generated concurrently, sharing the decoded images and
+  /// the processed outputs they have in common.
+  Future<void> generate({
+    required SplashScreenConfig config,
+    bool force = false,
+  }) async {
+    await Future.wait([
+      handleLinux(config, verbose, force: force),
+      handleWindows(config, verbose, force: force),
+      handleMacos(config, verbose),
+    ]);
     return;
     // TODO: Additional platforms can be added here in the future
   }
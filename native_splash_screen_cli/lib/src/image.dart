@@ -1,11 +1,31 @@
+import 'dart:async' show Completer;
+import 'dart:collection' show Queue;
 import 'dart:io';
-import 'dart:typed_data' show Uint8List;
+import 'dart:isolate' show Isolate;
+import 'dart:math' show min;
+import 'dart:typed_data' show Uint8List, Uint32List;
 
 import 'package:image/image.dart' as img;
 
 import '../models/image.dart';
 
+import '../common/utils.dart';
+
+import 'native_compiler.dart';
+
+/// Processed images, keyed by source path and options, so flavors and
+/// platforms asking for the same output share it
+final Map<String, Future<BGRAImage>> _processedImages = {};
+
+/// Decoded source images, keyed by path, so each one is only decoded once
+final Map<String, Future<img.Image>> _decodedImages = {};
+
 /// Main function to load an image with various options
+///
+/// Decoding and processing run in background isolates, at most one per core,
+/// so the outputs of every flavor and platform can be generated concurrently.
+/// The returned image is shared by every caller asking for the same output
+/// and must not be modified.
 Future<BGRAImage> loadImageAsBGRA(
   String path, {
   // Image sizing options
@@ -29,10 +49,140 @@ Future<BGRAImage> loadImageAsBGRA(
   // creating a transparent canvas if no background color is provided.
   // This is essential for the macOS asset pipeline.
   bool ensureCanvasSize = false,
+}) {
+  final key = [
+    path,
+    targetWidth,
+    targetHeight,
+    resizeToFit,
+    blurRadius,
+    backgroundColor != null ? colorHex(backgroundColor) : '',
+    backgroundWidth,
+    backgroundHeight,
+    imageBorderRadius,
+    backgroundBorderRadius,
+    alignment.name,
+    ensureCanvasSize,
+  ].join('|');
+
+  return _processedImages[key] ??= _loadImageAsBGRA(
+    path,
+    targetWidth: targetWidth,
+    targetHeight: targetHeight,
+    resizeToFit: resizeToFit,
+    blurRadius: blurRadius,
+    backgroundColor: backgroundColor,
+    backgroundWidth: backgroundWidth,
+    backgroundHeight: backgroundHeight,
+    imageBorderRadius: imageBorderRadius,
+    backgroundBorderRadius: backgroundBorderRadius,
+    alignment: alignment,
+    ensureCanvasSize: ensureCanvasSize,
+  );
+}
+
+Future<BGRAImage> _loadImageAsBGRA(
+  String path, {
+  required int targetWidth,
+  required int targetHeight,
+  required bool resizeToFit,
+  required double blurRadius,
+  required img.Color? backgroundColor,
+  required int backgroundWidth,
+  required int backgroundHeight,
+  required double imageBorderRadius,
+  required double backgroundBorderRadius,
+  required ImageAlignment alignment,
+  required bool ensureCanvasSize,
 }) async {
+  // The native asset compiler runs the same steps, much faster
+  final compiled = await compileImageNatively(
+    path,
+    targetWidth: targetWidth,
+    targetHeight: targetHeight,
+    resizeToFit: resizeToFit,
+    blurRadius: blurRadius,
+    backgroundColor: backgroundColor,
+    backgroundWidth: backgroundWidth,
+    backgroundHeight: backgroundHeight,
+    imageBorderRadius: imageBorderRadius,
+    backgroundBorderRadius: backgroundBorderRadius,
+    alignment: alignment,
+    ensureCanvasSize: ensureCanvasSize,
+  );
+  if (compiled != null) return compiled;
+
   // Load and decode the image
-  final img.Image decodedImage = await _decodeImageFromPath(path);
+  final img.Image decodedImage =
+      await (_decodedImages[path] ??= _decodeImageFromPath(path));
 
+  return _processInIsolate(
+    decodedImage,
+    targetWidth: targetWidth,
+    targetHeight: targetHeight,
+    resizeToFit: resizeToFit,
+    blurRadius: blurRadius,
+    backgroundColor: backgroundColor,
+    backgroundWidth: backgroundWidth,
+    backgroundHeight: backgroundHeight,
+    imageBorderRadius: imageBorderRadius,
+    backgroundBorderRadius: backgroundBorderRadius,
+    alignment: alignment,
+    ensureCanvasSize: ensureCanvasSize,
+  );
+}
+
+/// Runs [_processAndCompose] in a background isolate
+///
+/// The closure sent to the isolate is created in this synchronous function
+/// so it captures nothing but the arguments.
+Future<BGRAImage> _processInIsolate(
+  img.Image decodedImage, {
+  required int targetWidth,
+  required int targetHeight,
+  required bool resizeToFit,
+  required double blurRadius,
+  required img.Color? backgroundColor,
+  required int backgroundWidth,
+  required int backgroundHeight,
+  required double imageBorderRadius,
+  required double backgroundBorderRadius,
+  required ImageAlignment alignment,
+  required bool ensureCanvasSize,
+}) {
+  return _runInIsolate(
+    () => _processAndCompose(
+      decodedImage,
+      targetWidth: targetWidth,
+      targetHeight: targetHeight,
+      resizeToFit: resizeToFit,
+      blurRadius: blurRadius,
+      backgroundColor: backgroundColor,
+      backgroundWidth: backgroundWidth,
+      backgroundHeight: backgroundHeight,
+      imageBorderRadius: imageBorderRadius,
+      backgroundBorderRadius: backgroundBorderRadius,
+      alignment: alignment,
+      ensureCanvasSize: ensureCanvasSize,
+    ),
+  );
+}
+
+/// Resizes, blurs and composes [decodedImage] over its background
+BGRAImage _processAndCompose(
+  img.Image decodedImage, {
+  required int targetWidth,
+  required int targetHeight,
+  required bool resizeToFit,
+  required double blurRadius,
+  required img.Color? backgroundColor,
+  required int backgroundWidth,
+  required int backgroundHeight,
+  required double imageBorderRadius,
+  required double backgroundBorderRadius,
+  required ImageAlignment alignment,
+  required bool ensureCanvasSize,
+}) {
   // Process the image (resize, blur)
   final img.Image processedImage = _processImage(
     decodedImage,
@@ -82,7 +232,7 @@ Future<BGRAImage> loadImageAsBGRA(
 /// Decodes an image from a file path
 Future<img.Image> _decodeImageFromPath(String path) async {
   final bytes = await File(path).readAsBytes();
-  img.Image? image = img.decodeImage(bytes);
+  img.Image? image = await _decodeInIsolate(bytes);
 
   if (image == null) {
     throw Exception('Failed to decode image at $path');
@@ -91,6 +241,138 @@ Future<img.Image> _decodeImageFromPath(String path) async {
   return image;
 }
 
+/// Runs `img.decodeImage` in a background isolate, see [_processInIsolate]
+Future<img.Image?> _decodeInIsolate(Uint8List bytes) {
+  return _runInIsolate(() => img.decodeImage(bytes));
+}
+
+/// Number of isolates currently running a computation
+int _runningIsolates = 0;
+
+/// Computations waiting for a free core, in order
+final Queue<Completer<void>> _waitingIsolates = Queue();
+
+/// Runs [computation] in a new isolate, at most one per core at a time
+///
+/// The result is passed back without being copied.
+Future<R> _runInIsolate<R>(R Function() computation) async {
+  if (_runningIsolates < Platform.numberOfProcessors) {
+    _runningIsolates++;
+  } else {
+    final turn = Completer<void>();
+    _waitingIsolates.add(turn);
+    await turn.future;
+  }
+
+  try {
+    return await Isolate.run(computation);
+  } finally {
+    // Hand the core over to the next computation
+    if (_waitingIsolates.isNotEmpty) {
+      _waitingIsolates.removeFirst().complete();
+    } else {
+      _runningIsolates--;
+    }
+  }
+}
+
+/// Reads the dimensions of the image at [path] from its header, without
+/// decoding the pixels
+Future<(int, int)> readImageSize(String path) async {
+  final bytes = await File(path).readAsBytes();
+  final info = img.findDecoderForData(bytes)?.startDecode(bytes);
+
+  if (info == null) {
+    throw Exception('Failed to decode image at $path');
+  }
+
+  return (info.width, info.height);
+}
+
+/// Decodes the frames of the animation made of [paths]: the frames of a
+/// single animated GIF, APNG or WebP file, or one frame per file of an image
+/// sequence
+///
+/// Frames are resized to [width] x [height] when set, to the size of the
+/// first frame otherwise. Frames without a duration of their own, or with
+/// one browsers would not honor either, are shown for [frameDuration]
+/// milliseconds.
+Future<List<AnimationFrame>> loadAnimationFrames(
+  List<String> paths, {
+  int width = 0,
+  int height = 0,
+  int frameDuration = 100,
+}) async {
+  if (width <= 0 || height <= 0) {
+    (width, height) = await readImageSize(paths.first);
+  }
+
+  final decoded = await Future.wait([
+    for (final path in paths)
+      File(path).readAsBytes().then(
+            (bytes) => _decodeAnimationInIsolate(
+              bytes,
+              width,
+              height,
+              frameDuration,
+            ),
+          ),
+  ]);
+
+  final frames = <AnimationFrame>[];
+  for (int i = 0; i < paths.length; i++) {
+    final sequence = decoded[i];
+    if (sequence == null) {
+      throw Exception('Failed to decode animation at ${paths[i]}');
+    }
+    frames.addAll(sequence);
+  }
+  return frames;
+}
+
+/// Runs [_decodeAnimation] in a background isolate, see [_processInIsolate]
+Future<List<AnimationFrame>?> _decodeAnimationInIsolate(
+  Uint8List bytes,
+  int width,
+  int height,
+  int frameDuration,
+) {
+  return _runInIsolate(
+    () => _decodeAnimation(bytes, width, height, frameDuration),
+  );
+}
+
+/// Decodes every frame of [bytes], composed over the ones before it by the
+/// decoder, at [width] x [height]
+List<AnimationFrame>? _decodeAnimation(
+  Uint8List bytes,
+  int width,
+  int height,
+  int frameDuration,
+) {
+  final image = img.decodeImage(bytes);
+  if (image == null) {
+    return null;
+  }
+
+  return [
+    for (final frame in image.frames)
+      AnimationFrame(
+        _convertToGBRA(
+          frame.width == width && frame.height == height
+              ? frame
+              : img.copyResize(
+                  frame,
+                  width: width,
+                  height: height,
+                  interpolation: img.Interpolation.average,
+                ),
+        ),
+        frame.frameDuration > 10 ? frame.frameDuration : frameDuration,
+      ),
+  ];
+}
+
 /// Processes an image with the specified options
 img.Image _processImage(
   img.Image image, {
@@ -323,3 +605,248 @@ BGRAImage _convertToGBRA(img.Image image) {
 
   return BGRAImage(data: output, width: width, height: height, original: image);
 }
+
+/// Crops the fully transparent borders of an image.
+///
+/// Computes the tight bounding box of the pixels with a non-zero alpha and
+/// returns an image holding only that rectangle, along with its offset in the
+/// original canvas. A fully transparent image is reduced to a single pixel.
+BGRAImage trimTransparentBorders(BGRAImage image) {
+  final width = image.width;
+  final height = image.height;
+  final pixels = image.data.buffer.asUint32List(
+    image.data.offsetInBytes,
+    width * height,
+  );
+
+  // BGRA bytes read as a little-endian word put the alpha in the high byte
+  bool opaqueRow(int y, int from, int to) {
+    final row = y * width;
+    for (int x = from; x < to; x++) {
+      if (pixels[row + x] >> 24 != 0) return true;
+    }
+    return false;
+  }
+
+  bool opaqueColumn(int x, int from, int to) {
+    for (int y = from; y < to; y++) {
+      if (pixels[y * width + x] >> 24 != 0) return true;
+    }
+    return false;
+  }
+
+  int top = 0;
+  while (top < height && !opaqueRow(top, 0, width)) {
+    top++;
+  }
+  if (top == height) {
+    return BGRAImage(
+      data: Uint8List(4),
+      width: 1,
+      height: 1,
+      original: image.original,
+      offsetX: image.offsetX,
+      offsetY: image.offsetY,
+      canvasWidth: image.canvasWidth,
+      canvasHeight: image.canvasHeight,
+    );
+  }
+
+  int bottom = height;
+  while (!opaqueRow(bottom - 1, 0, width)) {
+    bottom--;
+  }
+  int left = 0;
+  while (!opaqueColumn(left, top, bottom)) {
+    left++;
+  }
+  int right = width;
+  while (!opaqueColumn(right - 1, top, bottom)) {
+    right--;
+  }
+
+  if (left == 0 && top == 0 && right == width && bottom == height) {
+    return image;
+  }
+
+  final trimmedWidth = right - left;
+  final trimmedHeight = bottom - top;
+  final output = Uint32List(trimmedWidth * trimmedHeight);
+  for (int y = 0; y < trimmedHeight; y++) {
+    final src = (top + y) * width + left;
+    output.setRange(y * trimmedWidth, (y + 1) * trimmedWidth, pixels, src);
+  }
+
+  return BGRAImage(
+    data: output.buffer.asUint8List(),
+    width: trimmedWidth,
+    height: trimmedHeight,
+    original: image.original,
+    offsetX: image.offsetX + left,
+    offsetY: image.offsetY + top,
+    canvasWidth: image.canvasWidth,
+    canvasHeight: image.canvasHeight,
+  );
+}
+
+/// Encodes an image as 8-bit palette indices when it has at most 256 colors.
+///
+/// When the image has more colors and [tolerance] is positive, a quantized
+/// version is used instead, as long as no channel of any pixel moved further
+/// than [tolerance] from its original value.
+///
+/// Returns null if the image can not be indexed.
+IndexedImage? encodeIndexed(BGRAImage image, {int tolerance = 0}) {
+  final pixels = image.data.buffer.asUint32List(
+    image.data.offsetInBytes,
+    image.width * image.height,
+  );
+
+  final exact = _indexPixels(pixels);
+  if (exact != null || tolerance <= 0) {
+    return exact;
+  }
+
+  final source = img.Image.fromBytes(
+    width: image.width,
+    height: image.height,
+    bytes: image.data.buffer,
+    bytesOffset: image.data.offsetInBytes,
+    numChannels: 4,
+    order: img.ChannelOrder.bgra,
+  );
+  final quantized = img.quantize(
+    source,
+    numberOfColors: 256,
+    method: img.QuantizeMethod.octree,
+    dither: img.DitherKernel.none,
+  );
+
+  final approximated = Uint32List(pixels.length);
+  int i = 0;
+  for (final pixel in quantized) {
+    final argb = (pixel.a.toInt() << 24) |
+        (pixel.r.toInt() << 16) |
+        (pixel.g.toInt() << 8) |
+        pixel.b.toInt();
+
+    for (int shift = 0; shift < 32; shift += 8) {
+      final delta = ((argb >> shift) & 0xFF) - ((pixels[i] >> shift) & 0xFF);
+      if (delta.abs() > tolerance) return null;
+    }
+    approximated[i++] = argb;
+  }
+
+  return _indexPixels(approximated);
+}
+
+/// Builds the palette of [pixels], or returns null past 256 colors.
+IndexedImage? _indexPixels(Uint32List pixels) {
+  final colors = <int, int>{};
+  final indices = Uint8List(pixels.length);
+
+  for (int i = 0; i < pixels.length; i++) {
+    final index = colors.putIfAbsent(pixels[i], () => colors.length);
+    if (index > 255) return null;
+    indices[i] = index;
+  }
+
+  return IndexedImage(
+    indices: indices,
+    palette: Uint32List.fromList(colors.keys.toList()),
+  );
+}
+
+/// Splits [images] into [tileSize] x [tileSize] tiles shared between them.
+///
+/// Identical tiles, within an image or across images, are stored once, and
+/// tiles of a single color are only recorded by their color. Tiles on the
+/// right and bottom edges are padded with transparent pixels.
+TileSet encodeTiles(List<BGRAImage> images, {int tileSize = 32}) {
+  final tileLength = tileSize * tileSize;
+  final tiles = <Uint32List>[];
+  final tilesByHash = <int, List<int>>{};
+  final colors = <int, int>{};
+  final maps = <Uint32List>[];
+
+  for (final image in images) {
+    final width = image.width;
+    final height = image.height;
+    final pixels = image.data.buffer.asUint32List(
+      image.data.offsetInBytes,
+      width * height,
+    );
+
+    final columns = (width + tileSize - 1) ~/ tileSize;
+    final rows = (height + tileSize - 1) ~/ tileSize;
+    final map = Uint32List(columns * rows);
+
+    for (int ty = 0; ty < rows; ty++) {
+      for (int tx = 0; tx < columns; tx++) {
+        final x0 = tx * tileSize;
+        final y0 = ty * tileSize;
+        final w = min(tileSize, width - x0);
+        final h = min(tileSize, height - y0);
+
+        final tile = Uint32List(tileLength);
+        final first = pixels[y0 * width + x0];
+        bool solid = true;
+        for (int y = 0; y < h; y++) {
+          final src = (y0 + y) * width + x0;
+          tile.setRange(y * tileSize, y * tileSize + w, pixels, src);
+          for (int x = 0; solid && x < w; x++) {
+            solid = pixels[src + x] == first;
+          }
+        }
+
+        if (solid) {
+          final index = colors.putIfAbsent(first, () => colors.length);
+          map[ty * columns + tx] = TileSet.solidTile | index;
+          continue;
+        }
+
+        // FNV-1a over the pixels, collisions are resolved by comparing them
+        int hash = 0x811C9DC5;
+        for (int i = 0; i < tileLength; i++) {
+          hash = ((hash ^ tile[i]) * 0x01000193) & 0xFFFFFFFF;
+        }
+
+        final candidates = tilesByHash.putIfAbsent(hash, () => <int>[]);
+        int index = -1;
+        for (final candidate in candidates) {
+          if (_sameTile(tiles[candidate], tile)) {
+            index = candidate;
+            break;
+          }
+        }
+        if (index < 0) {
+          index = tiles.length;
+          tiles.add(tile);
+          candidates.add(index);
+        }
+        map[ty * columns + tx] = index;
+      }
+    }
+
+    maps.add(map);
+  }
+
+  final blob = Uint32List(tiles.length * tileLength);
+  for (int i = 0; i < tiles.length; i++) {
+    blob.setRange(i * tileLength, (i + 1) * tileLength, tiles[i]);
+  }
+
+  return TileSet(
+    tileSize: tileSize,
+    tiles: blob.buffer.asUint8List(),
+    colors: Uint32List.fromList(colors.keys.toList()),
+    maps: maps,
+  );
+}
+
+bool _sameTile(Uint32List a, Uint32List b) {
+  for (int i = 0; i < a.length; i++) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
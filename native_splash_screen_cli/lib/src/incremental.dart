@@ -0,0 +1,93 @@
+import 'dart:convert' show utf8;
+import 'dart:io';
+import 'dart:typed_data' show Uint8List;
+
+import '../models/desktop.dart';
+
+import '../common/const.dart';
+import '../common/utils.dart';
+
+import 'native_compiler.dart';
+
+/// Prefix of the comment line holding the generation hash, written in the
+/// header of every generated source
+const String generationHashPrefix = '// Generation hash: ';
+
+/// Number of bytes read from a generated source to find its hash
+const int _headerBytes = 512;
+
+/// Hashes everything the generated sources of [configs] depend on: the
+/// generator version, every setting of each flavor, the bytes of their
+/// images and animation frames, and whether the native asset compiler
+/// processes them.
+///
+/// Returns the same value as long as generating again would produce the
+/// same output.
+Future<int> hashGenerationInputs(Iterable<DesktopSplashConfig> configs) async {
+  int hash = fnv1a64(utf8.encode(GENERATOR_VERSION));
+  hash = fnv1a64(utf8.encode('${assetCompilerPath != null}'), hash);
+
+  // Flavors usually share their image, only read it once
+  final imageHashes = <String, int>{};
+  for (final config in configs) {
+    hash = fnv1a64(utf8.encode(config.fingerprint), hash);
+
+    final imagePaths = [
+      config.imagePath,
+      if (config.imagePathDark != null) config.imagePathDark!,
+      ...config.animationPaths,
+    ];
+    for (final imagePath in imagePaths) {
+      final imageHash = imageHashes[imagePath] ??= fnv1a64(
+        await File(imagePath).readAsBytes(),
+      );
+      hash = fnv1a64(utf8.encode(hex64(imageHash)), hash);
+    }
+  }
+  return hash;
+}
+
+/// The comment line embedding [hash] in a generated source
+String generationHashLine(int hash) => '$generationHashPrefix${hex64(hash)}';
+
+/// The first bytes of [file], where the generated sources put their header
+/// comments, or an empty string when it can not be read
+///
+/// Only the header is read, generated sources can weigh several megabytes.
+String readGeneratedHeader(File file) {
+  if (!file.existsSync()) return '';
+
+  try {
+    final input = file.openSync();
+    try {
+      return String.fromCharCodes(input.readSync(_headerBytes));
+    } finally {
+      input.closeSync();
+    }
+  } on FileSystemException {
+    return '';
+  }
+}
+
+/// Whether [file] was generated from inputs of the given [hash]
+bool hasGenerationHash(File file, int hash) {
+  return readGeneratedHeader(file).contains(generationHashLine(hash));
+}
+
+/// Writes [bytes] to [file] unless it already holds them, so unchanged
+/// outputs keep their timestamp and the build does not compile them again
+///
+/// Returns [true] if the file was written.
+Future<bool> writeIfChanged(File file, List<int> bytes) async {
+  if (file.existsSync() && await file.length() == bytes.length) {
+    final Uint8List current = await file.readAsBytes();
+    int i = 0;
+    while (i < bytes.length && current[i] == bytes[i]) {
+      i++;
+    }
+    if (i == bytes.length) return false;
+  }
+
+  await file.writeAsBytes(bytes);
+  return true;
+}
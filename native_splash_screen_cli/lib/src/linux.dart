@@ -1,4 +1,5 @@
 import 'dart:io';
+import 'dart:math' show min;
 
 import 'package:yaml/yaml.dart';
 
@@ -13,6 +14,7 @@ import '../templates/linux.dart';
 import '../templates/linux_build.dart';
 
 import '../src/logger.dart';
+import '../src/svg.dart';
 
 /// Parse Linux platform specific configuration with input validation
 /// Returns null if Linux configuration does not exist
@@ -77,6 +79,42 @@ DesktopSplashConfig? parseLinuxConfig(YamlMap yaml) {
     linuxYaml['background_color'] as String? ?? '#00000000',
   );
 
+  // Optional gradient drawn over the background rectangle at runtime
+  final gradientName = linuxYaml['background_gradient'] as String? ?? 'none';
+  final gradient = BackgroundGradient.values.firstWhere(
+    (g) => g.name == gradientName,
+    orElse: () => throw Exception(
+      'Linux configuration error: '
+      'background_gradient should be one of "none", "linear" or "radial"',
+    ),
+  );
+  final gradientColor = parseColor(
+    linuxYaml['background_gradient_color'] as String? ?? '#00000000',
+  );
+
+  // Image pixels compiled into the binary or loaded from the bundle
+  final storageName = linuxYaml['image_storage'] as String? ?? 'embedded';
+  final storage = ImageStorage.values.firstWhere(
+    (s) => s.name == storageName,
+    orElse: () => throw Exception(
+      'Linux configuration error: '
+      'image_storage should be one of "embedded" or "file"',
+    ),
+  );
+
+  // Scale factors to generate the image for, 1x is always generated
+  final scalesYaml = linuxYaml['image_scales'];
+  if (scalesYaml != null &&
+      (scalesYaml is! YamlList ||
+          scalesYaml.any((s) => s is! int || s < 1 || s > 3))) {
+    throw Exception(
+      'Linux configuration error: '
+      'image_scales should be a list of scale factors between 1 and 3',
+    );
+  }
+  final imageScales = {1, ...?(scalesYaml as YamlList?)?.cast<int>()}.toList()
+    ..sort();
+
   // Get image path and validate existence
   final String imagePath = linuxYaml['image_path'] as String? ?? "";
   final imageFile = File(imagePath);
@@ -87,6 +125,99 @@ DesktopSplashConfig? parseLinuxConfig(YamlMap yaml) {
     );
   }
 
+  // Optional image for dark desktops, processed like the main one
+  final imagePathDark = linuxYaml['image_path_dark'] as String?;
+  if (imagePathDark != null && !File(imagePathDark).existsSync()) {
+    throw Exception(
+      'Linux configuration error: '
+      'dark image not found at: $imagePathDark',
+    );
+  }
+
+  // SVG images are compiled to vector operations drawn by the plugin
+  if (isSvgPath(imagePath)) {
+    if (storage != ImageStorage.embedded) {
+      throw Exception(
+        'Linux configuration error: '
+        'SVG images can only use the "embedded" image_storage',
+      );
+    }
+    if (linuxYaml['image_border_radius'] != null) {
+      logger.w('image_border_radius does not apply to SVG images');
+    }
+  }
+  if (imagePathDark != null && isSvgPath(imagePathDark)) {
+    throw Exception(
+      'Linux configuration error: '
+      'image_path_dark can not be an SVG image',
+    );
+  }
+
+  // Optional animation, one animated file or a sequence of frames
+  final animationPath = linuxYaml['animation_path'] as String?;
+  final framesYaml = linuxYaml['animation_frames'];
+  if (framesYaml != null &&
+      (framesYaml is! YamlList || framesYaml.any((f) => f is! String))) {
+    throw Exception(
+      'Linux configuration error: '
+      'animation_frames should be a list of image paths',
+    );
+  }
+  if (animationPath != null && framesYaml != null) {
+    throw Exception(
+      'Linux configuration error: '
+      'only one of animation_path and animation_frames can be set',
+    );
+  }
+  final animationPaths = animationPath != null
+      ? [animationPath]
+      : (framesYaml as YamlList?)?.cast<String>().toList() ?? <String>[];
+  for (final framePath in animationPaths) {
+    if (!File(framePath).existsSync()) {
+      throw Exception(
+        'Linux configuration error: '
+        'animation frame not found at: $framePath',
+      );
+    }
+  }
+  final frameDuration = linuxYaml['animation_frame_duration'] as int? ?? 100;
+  if (frameDuration <= 0) {
+    throw Exception(
+      'Linux configuration error: '
+      'animation_frame_duration should be a positive number of milliseconds',
+    );
+  }
+
+  // Optional loading spinner, drawn by the plugin
+  final spinnerSize = linuxYaml['spinner_size'] as int? ?? 0;
+  final spinnerFrames = linuxYaml['spinner_frames'] as int? ?? 30;
+  final spinnerPeriod = linuxYaml['spinner_period'] as int? ?? 1000;
+  if (spinnerSize < 0 || spinnerSize > min(validWidth, validHeight)) {
+    throw Exception(
+      'Linux configuration error: '
+      'spinner_size should fit in the background rectangle',
+    );
+  }
+  if (spinnerFrames < 4 || spinnerFrames > 120 || spinnerPeriod <= 0) {
+    throw Exception(
+      'Linux configuration error: '
+      'spinner_frames should be between 4 and 120 and spinner_period '
+      'a positive number of milliseconds',
+    );
+  }
+
+  // Blur and drop shadow of the image, drawn by the plugin from its pixels
+  final blurRadius = linuxYaml['blur_radius'] as double? ?? 0.0;
+  final shadowRadius =
+      (linuxYaml['image_shadow_radius'] as num?)?.toDouble() ?? 0.0;
+  if (blurRadius < 0 || blurRadius > 100 || shadowRadius < 0 ||
+      shadowRadius > 100) {
+    throw Exception(
+      'Linux configuration error: '
+      'blur_radius and image_shadow_radius should be between 0 and 100',
+    );
+  }
+
   return DesktopSplashConfig(
     windowWidth: windowWidth,
     windowHeight: windowHeight,
@@ -94,10 +225,33 @@ DesktopSplashConfig? parseLinuxConfig(YamlMap yaml) {
     windowClass: linuxYaml['window_class'] as String? ?? 'splash_window',
     windowColor: windowColor,
     imagePath: imageFile.path,
+    imagePathDark: imagePathDark,
+    animationPaths: animationPaths,
+    animationFrameDuration: frameDuration,
+    animationWidth: linuxYaml['animation_width'] as int? ?? 0,
+    animationHeight: linuxYaml['animation_height'] as int? ?? 0,
+    animationLoop: linuxYaml['animation_loop'] as bool? ?? true,
+    spinnerSize: spinnerSize,
+    spinnerColor: parseColor(
+      linuxYaml['spinner_color'] as String? ?? '#808080',
+    ),
+    spinnerOffsetY: linuxYaml['spinner_offset_y'] as int?,
+    spinnerPeriod: spinnerPeriod,
+    spinnerFrames: spinnerFrames,
     imageWidth: imageWidth,
     imageHeight: imageHeight,
     imageBorderRadius: linuxYaml['image_border_radius'] as double? ?? 0.0,
-    imageBlurRadius: linuxYaml['blur_radius'] as double? ?? 0.0,
+    imageBlurRadius: blurRadius,
+    imageShadowColor: parseColor(
+      linuxYaml['image_shadow_color'] as String? ?? '#00000000',
+    ),
+    imageShadowRadius: shadowRadius,
+    imageShadowOffsetX: linuxYaml['image_shadow_offset_x'] as int? ?? 0,
+    imageShadowOffsetY: linuxYaml['image_shadow_offset_y'] as int? ?? 0,
+    imageQuantizeTolerance:
+        linuxYaml['image_quantize_tolerance'] as int? ?? 0,
+    imageStorage: storage,
+    imageScales: imageScales,
     imageScaling: linuxYaml['image_scaling'] as bool? ?? false,
     backgroundColor: backgroundColor,
     backgroundWidth: validWidth,
@@ -105,6 +259,10 @@ DesktopSplashConfig? parseLinuxConfig(YamlMap yaml) {
     backgroundBorderRadius:
         linuxYaml['background_border_radius'] as double? ?? 0.0,
     withAnimation: linuxYaml['with_animation'] as bool? ?? true,
+    backgroundGradient: gradient,
+    backgroundGradientColor: gradientColor,
+    backgroundGradientAngle:
+        (linuxYaml['background_gradient_angle'] as num?)?.toDouble() ?? 90.0,
   );
 }
 
@@ -149,7 +307,11 @@ DesktopSplashConfig? checkLinux(
   return result;
 }
 
-Future<void> handleLinux(SplashScreenConfig config, bool verbose) async {
+Future<void> handleLinux(
+  SplashScreenConfig config,
+  bool verbose, {
+  bool force = false,
+}) async {
   if (!config.platforms.hasLinux) {
     if (verbose) {
       logger.w("Linux platform is not enabled.");
@@ -178,15 +340,6 @@ Future<void> handleLinux(SplashScreenConfig config, bool verbose) async {
     verbose,
     RELEASE,
   );
-  final r2 = await generateLinuxCode(
-    config: r1!,
-    flavor: RELEASE,
-    outputDir: distDir,
-  );
-  if (r2 && verbose) {
-    logger.success("Generated Linux $RELEASE configuration.");
-  }
-
   final p1 = checkLinux(
     config.platforms.linux!,
     config.profile.linux,
@@ -194,15 +347,6 @@ Future<void> handleLinux(SplashScreenConfig config, bool verbose) async {
     verbose,
     PROFILE,
   );
-  final p2 = await generateLinuxCode(
-    config: p1!,
-    flavor: PROFILE,
-    outputDir: distDir,
-  );
-  if (p2 && verbose) {
-    logger.success("Generated Linux $PROFILE configuration.");
-  }
-
   final d1 = checkLinux(
     config.platforms.linux!,
     config.debug.linux,
@@ -210,15 +354,28 @@ Future<void> handleLinux(SplashScreenConfig config, bool verbose) async {
     verbose,
     DEBUG,
   );
-  final d2 = await generateLinuxCode(
-    config: d1!,
-    flavor: DEBUG,
+
+  // Custom flavors embedded together, selected when the app starts
+  final runtimeFlavors = <String, DesktopSplashConfig>{
+    if (config.platforms.linux!.runtimeFlavors)
+      for (final flavor in config.custom)
+        flavor.name: checkLinux(
+          config.platforms.linux!,
+          flavor.linux,
+          config.fallback.linux,
+          verbose,
+          flavor.name,
+        )!,
+  };
+
+  // All flavors are generated together so they can share their tiles
+  final generated = await generateLinuxCode(
+    flavors: {RELEASE: r1!, PROFILE: p1!, DEBUG: d1!},
+    runtimeFlavors: runtimeFlavors,
     outputDir: distDir,
+    force: force,
   );
-  if (d2 && verbose) {
-    logger.success("Generated Linux $DEBUG configuration.");
-  }
-  if (r2 && p2 && d2) {
+  if (generated) {
     logger.success("Generated Linux configuration successfully.");
   }
 
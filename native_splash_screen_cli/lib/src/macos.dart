@@ -176,15 +176,6 @@ Future<void> handleMacos(SplashScreenConfig config, bool verbose) async {
     verbose,
     RELEASE,
   );
-  final r2 = await generateMacosCode(
-    config: r1!,
-    flavor: RELEASE,
-    outputDir: distDir,
-  );
-  if (r2 && verbose) {
-    logger.success("Generated Macos $RELEASE configuration.");
-  }
-
   final p1 = checkMacos(
     config.platforms.macos!,
     config.profile.macos,
@@ -192,15 +183,6 @@ Future<void> handleMacos(SplashScreenConfig config, bool verbose) async {
     verbose,
     PROFILE,
   );
-  final p2 = await generateMacosCode(
-    config: p1!,
-    flavor: PROFILE,
-    outputDir: distDir,
-  );
-  if (p2 && verbose) {
-    logger.success("Generated Macos $PROFILE configuration.");
-  }
-
   final d1 = checkMacos(
     config.platforms.macos!,
     config.debug.macos,
@@ -208,15 +190,25 @@ Future<void> handleMacos(SplashScreenConfig config, bool verbose) async {
     verbose,
     DEBUG,
   );
-  final d2 = await generateMacosCode(
-    config: d1!,
-    flavor: DEBUG,
-    outputDir: distDir,
-  );
-  if (d2 && verbose) {
-    logger.success("Generated Macos $DEBUG configuration.");
+
+  // The flavors are independent, generate them concurrently
+  final flavors = {RELEASE: r1!, PROFILE: p1!, DEBUG: d1!};
+  final results = await Future.wait([
+    for (final MapEntry(key: flavor, value: flavorConfig) in flavors.entries)
+      generateMacosCode(
+        config: flavorConfig,
+        flavor: flavor,
+        outputDir: distDir,
+      ),
+  ]);
+
+  final names = flavors.keys.toList();
+  for (int i = 0; i < names.length; i++) {
+    if (results[i] && verbose) {
+      logger.success("Generated Macos ${names[i]} configuration.");
+    }
   }
-  if (r2 && p2 && d2) {
+  if (!results.contains(false)) {
     logger.success("Generated Macos configuration successfully.");
   }
 
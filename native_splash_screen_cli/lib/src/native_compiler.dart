@@ -0,0 +1,126 @@
+import 'dart:io';
+import 'dart:typed_data' show ByteData, Endian, Uint8List;
+
+import 'package:image/image.dart' show Color;
+
+import '../common/utils.dart';
+import '../models/image.dart';
+import 'logger.dart';
+
+/// Name of the native asset compiler executable (tool/nss_asset_compiler)
+const String assetCompilerName = 'nss-asset-compiler';
+
+/// Environment variable pointing to the native asset compiler, which is
+/// otherwise looked up on the PATH
+const String assetCompilerEnv = 'NSS_ASSET_COMPILER';
+
+/// Exit code of the compiler for inputs it does not handle (non PNG)
+const int _exitUnsupported = 3;
+
+/// Header of the images written by the compiler: "NSSB", width, height and a
+/// reserved word, as little-endian 32-bit integers
+const int _headerSize = 16;
+
+bool _resolved = false;
+String? _executable;
+
+/// Path of the native asset compiler, or null when it is not installed.
+/// Resolved once per run.
+String? get assetCompilerPath {
+  if (_resolved) return _executable;
+  _resolved = true;
+
+  final override = Platform.environment[assetCompilerEnv];
+  if (override != null && override.isNotEmpty) {
+    if (File(override).existsSync()) return _executable = override;
+    logger.w('$assetCompilerEnv points to a missing file: $override');
+    return null;
+  }
+
+  final name =
+      Platform.isWindows ? '$assetCompilerName.exe' : assetCompilerName;
+  final separator = Platform.isWindows ? ';' : ':';
+  for (final dir in (Platform.environment['PATH'] ?? '').split(separator)) {
+    if (dir.isEmpty) continue;
+    final candidate = '$dir${Platform.pathSeparator}$name';
+    if (File(candidate).existsSync()) return _executable = candidate;
+  }
+  return null;
+}
+
+/// Loads, resizes, blurs and composes the image at [path] with the native
+/// asset compiler. Takes the same options as `loadImageAsBGRA`.
+///
+/// Returns null when the compiler is not installed, does not handle the
+/// image or fails, so the caller falls back to the Dart pipeline.
+Future<BGRAImage?> compileImageNatively(
+  String path, {
+  required int targetWidth,
+  required int targetHeight,
+  required bool resizeToFit,
+  required double blurRadius,
+  required Color? backgroundColor,
+  required int backgroundWidth,
+  required int backgroundHeight,
+  required double imageBorderRadius,
+  required double backgroundBorderRadius,
+  required ImageAlignment alignment,
+  required bool ensureCanvasSize,
+}) async {
+  final executable = assetCompilerPath;
+  if (executable == null) return null;
+
+  final arguments = [
+    path,
+    '--width', '$targetWidth',
+    '--height', '$targetHeight',
+    if (resizeToFit) '--fit',
+    '--blur', '$blurRadius',
+    '--radius', '$imageBorderRadius',
+    if (backgroundColor != null) ...['--background', colorHex(backgroundColor)],
+    '--background-width', '$backgroundWidth',
+    '--background-height', '$backgroundHeight',
+    '--background-radius', '$backgroundBorderRadius',
+    if (ensureCanvasSize) '--canvas',
+    '--align', alignment.name,
+  ];
+
+  final ProcessResult result;
+  try {
+    result = await Process.run(executable, arguments, stdoutEncoding: null);
+  } on ProcessException catch (e) {
+    logger.w('Cannot run $assetCompilerName: ${e.message}');
+    return null;
+  }
+
+  if (result.exitCode == _exitUnsupported) return null;
+  if (result.exitCode != 0) {
+    logger.w(
+      '$assetCompilerName failed on $path (${result.exitCode}): '
+      '${result.stderr.toString().trim()}',
+    );
+    return null;
+  }
+
+  final bytes = result.stdout as List<int>;
+  final data = bytes is Uint8List ? bytes : Uint8List.fromList(bytes);
+  if (data.length < _headerSize ||
+      String.fromCharCodes(data, 0, 4) != 'NSSB') {
+    logger.w('$assetCompilerName returned an invalid image for $path');
+    return null;
+  }
+
+  final header = ByteData.sublistView(data, 0, _headerSize);
+  final width = header.getUint32(4, Endian.little);
+  final height = header.getUint32(8, Endian.little);
+  if (data.length != _headerSize + width * height * 4) {
+    logger.w('$assetCompilerName returned an invalid image for $path');
+    return null;
+  }
+
+  return BGRAImage(
+    data: Uint8List.sublistView(data, _headerSize),
+    width: width,
+    height: height,
+  );
+}
@@ -0,0 +1,1193 @@
+import 'dart:math' as math;
+import 'dart:typed_data' show BytesBuilder, ByteData, Endian, Uint8List;
+
+import 'package:xml/xml.dart';
+
+import '../models/image.dart';
+
+import 'logger.dart';
+
+/// Version of the display list layout, checked by the plugin
+const int splashVectorVersion = 1;
+
+// Operations of the display list, must match SplashVectorOp of the plugin
+const int _opMoveTo = 1;
+const int _opLineTo = 2;
+const int _opCurveTo = 3;
+const int _opClosePath = 4;
+const int _opSave = 5;
+const int _opRestore = 6;
+const int _opTransform = 7;
+const int _opSolid = 8;
+const int _opLinear = 9;
+const int _opRadial = 10;
+const int _opFill = 11;
+const int _opStroke = 12;
+const int _opPushGroup = 13;
+const int _opPopGroup = 14;
+
+// Flags of the fill operation
+const int _fillEvenOdd = 1;
+const int _fillPreserve = 2;
+
+// Gradient extend modes, valued like cairo_extend_t
+const int _extendRepeat = 1;
+const int _extendReflect = 2;
+const int _extendPad = 3;
+
+/// Whether [path] names an SVG file, compiled by [compileSvg] instead of
+/// being decoded to pixels
+bool isSvgPath(String path) => path.toLowerCase().endsWith('.svg');
+
+/// Compiles an SVG document to the display list the Linux plugin replays
+/// with cairo, at [width] x [height] logical pixels
+///
+/// Without a size, the one of the `width` and `height` attributes of the
+/// document is used, or else the size of its `viewBox`.
+///
+/// Shapes, paths, groups, `use` references, transforms, solid colors and
+/// linear or radial gradients are supported, along with the fill, stroke
+/// and opacity properties, as attributes or inline styles. Text, images,
+/// clip paths, masks and filters are skipped with a warning.
+///
+/// Throws a [FormatException] if the document can not be compiled.
+VectorImage compileSvg(String source, {int width = 0, int height = 0}) {
+  final XmlDocument document;
+  try {
+    document = XmlDocument.parse(source);
+  } on XmlException catch (e) {
+    throw FormatException('Invalid SVG document: ${e.message}');
+  }
+
+  final root = document.rootElement;
+  if (root.name.local != 'svg') {
+    throw const FormatException('The root element is not <svg>');
+  }
+
+  final compiler = _SvgCompiler(document);
+  final (viewWidth, viewHeight, transform) =
+      compiler.viewport(root, width, height);
+  compiler.list.transform(transform);
+  compiler.renderChildren(root, _Style.initial, 0);
+
+  final ops = compiler.list.takeBytes();
+  final header = ByteData(24)
+    ..setUint8(0, 0x4E) // N
+    ..setUint8(1, 0x53) // S
+    ..setUint8(2, 0x53) // S
+    ..setUint8(3, 0x56) // V
+    ..setUint32(4, splashVectorVersion, Endian.little)
+    ..setInt32(8, viewWidth, Endian.little)
+    ..setInt32(12, viewHeight, Endian.little)
+    ..setUint32(16, ops.length, Endian.little);
+
+  final data = Uint8List(header.lengthInBytes + ops.length)
+    ..setAll(0, header.buffer.asUint8List())
+    ..setAll(header.lengthInBytes, ops);
+  return VectorImage(data: data, width: viewWidth, height: viewHeight);
+}
+
+/// Writer of the display list operations and their little-endian operands
+class _DisplayList {
+  final BytesBuilder _bytes = BytesBuilder();
+  final ByteData _scratch = ByteData(4);
+
+  void op(int code) => _bytes.addByte(code);
+
+  void u8(int value) => _bytes.addByte(value);
+
+  void u32(int value) {
+    _scratch.setUint32(0, value, Endian.little);
+    _bytes.add(_scratch.buffer.asUint8List());
+  }
+
+  void f32(double value) {
+    _scratch.setFloat32(0, value, Endian.little);
+    _bytes.add(_scratch.buffer.asUint8List());
+  }
+
+  void floats(Iterable<double> values) => values.forEach(f32);
+
+  void transform(_Matrix matrix) {
+    if (matrix.isIdentity) return;
+    op(_opTransform);
+    floats(matrix.values);
+  }
+
+  Uint8List takeBytes() => _bytes.takeBytes();
+}
+
+/// An affine transform mapping (x, y) to (a x + c y + e, b x + d y + f),
+/// the same as an SVG `matrix()` or a cairo_matrix_t
+class _Matrix {
+  final double a, b, c, d, e, f;
+
+  const _Matrix(this.a, this.b, this.c, this.d, this.e, this.f);
+
+  static const _Matrix identity = _Matrix(1, 0, 0, 1, 0, 0);
+
+  const _Matrix.translate(double x, double y) : this(1, 0, 0, 1, x, y);
+
+  const _Matrix.scale(double x, double y) : this(x, 0, 0, y, 0, 0);
+
+  List<double> get values => [a, b, c, d, e, f];
+
+  bool get isIdentity =>
+      a == 1 && b == 0 && c == 0 && d == 1 && e == 0 && f == 0;
+
+  bool get isInvertible => (a * d - b * c).abs() > 1e-12;
+
+  /// The transform applying [other] first, then this one
+  _Matrix operator *(_Matrix other) => _Matrix(
+        a * other.a + c * other.b,
+        b * other.a + d * other.b,
+        a * other.c + c * other.d,
+        b * other.c + d * other.d,
+        a * other.e + c * other.f + e,
+        b * other.e + d * other.f + f,
+      );
+}
+
+/// Paint of a fill or a stroke: a color, or the id of a gradient with a
+/// color to fall back to when it can not be found
+class _Paint {
+  final int? color;
+  final String? gradient;
+
+  const _Paint.color(int this.color) : gradient = null;
+
+  const _Paint.gradient(String this.gradient, this.color);
+}
+
+/// The inherited properties of an element
+class _Style {
+  final _Paint? fill;
+  final _Paint? stroke;
+  final int color;
+  final double fillOpacity;
+  final double strokeOpacity;
+  final double strokeWidth;
+  final bool evenOdd;
+  final int lineCap;
+  final int lineJoin;
+  final double miterLimit;
+
+  const _Style({
+    required this.fill,
+    required this.stroke,
+    required this.color,
+    required this.fillOpacity,
+    required this.strokeOpacity,
+    required this.strokeWidth,
+    required this.evenOdd,
+    required this.lineCap,
+    required this.lineJoin,
+    required this.miterLimit,
+  });
+
+  /// Defaults of the SVG specification: black fills and no stroke
+  static const _Style initial = _Style(
+    fill: _Paint.color(0xFF000000),
+    stroke: null,
+    color: 0xFF000000,
+    fillOpacity: 1,
+    strokeOpacity: 1,
+    strokeWidth: 1,
+    evenOdd: false,
+    lineCap: 0,
+    lineJoin: 0,
+    miterLimit: 4,
+  );
+}
+
+/// A path in absolute coordinates, along with the bounds of its geometry
+class _Path {
+  final List<(int, List<double>)> _segments = [];
+  double _x = 0, _y = 0;
+  double _startX = 0, _startY = 0;
+  double _minX = double.infinity, _minY = double.infinity;
+  double _maxX = double.negativeInfinity, _maxY = double.negativeInfinity;
+
+  bool get isEmpty => _segments.isEmpty;
+
+  double get x => _x;
+  double get y => _y;
+
+  /// Bounds of the geometry as (x, y, width, height)
+  (double, double, double, double) get bounds =>
+      (_minX, _minY, _maxX - _minX, _maxY - _minY);
+
+  void _include(double x, double y) {
+    _minX = math.min(_minX, x);
+    _minY = math.min(_minY, y);
+    _maxX = math.max(_maxX, x);
+    _maxY = math.max(_maxY, y);
+  }
+
+  void moveTo(double x, double y) {
+    _segments.add((_opMoveTo, [x, y]));
+    _x = _startX = x;
+    _y = _startY = y;
+    _include(x, y);
+  }
+
+  void lineTo(double x, double y) {
+    if (isEmpty) moveTo(_x, _y);
+    _segments.add((_opLineTo, [x, y]));
+    _x = x;
+    _y = y;
+    _include(x, y);
+  }
+
+  void curveTo(
+    double x1,
+    double y1,
+    double x2,
+    double y2,
+    double x,
+    double y,
+  ) {
+    if (isEmpty) moveTo(_x, _y);
+
+    // The curve lies within its control points, sample it for tight bounds
+    for (int i = 1; i <= 8; i++) {
+      final t = i / 8;
+      final u = 1 - t;
+      final (w0, w1) = (u * u * u, 3 * u * u * t);
+      final (w2, w3) = (3 * u * t * t, t * t * t);
+      _include(
+        w0 * _x + w1 * x1 + w2 * x2 + w3 * x,
+        w0 * _y + w1 * y1 + w2 * y2 + w3 * y,
+      );
+    }
+    _segments.add((_opCurveTo, [x1, y1, x2, y2, x, y]));
+    _x = x;
+    _y = y;
+  }
+
+  void quadTo(double x1, double y1, double x, double y) {
+    curveTo(
+      _x + 2 / 3 * (x1 - _x),
+      _y + 2 / 3 * (y1 - _y),
+      x + 2 / 3 * (x1 - x),
+      y + 2 / 3 * (y1 - y),
+      x,
+      y,
+    );
+  }
+
+  /// Adds an elliptical arc to ([x], [y]) as cubic curves, following the
+  /// endpoint to center conversion of the SVG specification
+  void arcTo(
+    double rx,
+    double ry,
+    double rotation,
+    bool largeArc,
+    bool sweep,
+    double x,
+    double y,
+  ) {
+    final x1 = _x, y1 = _y;
+    if (x1 == x && y1 == y) return;
+    rx = rx.abs();
+    ry = ry.abs();
+    if (rx == 0 || ry == 0) {
+      lineTo(x, y);
+      return;
+    }
+
+    final phi = rotation * math.pi / 180;
+    final cosPhi = math.cos(phi), sinPhi = math.sin(phi);
+    final dx = (x1 - x) / 2, dy = (y1 - y) / 2;
+    final x1p = cosPhi * dx + sinPhi * dy;
+    final y1p = -sinPhi * dx + cosPhi * dy;
+
+    // Radii too small to join the endpoints are scaled up
+    final lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+    if (lambda > 1) {
+      rx *= math.sqrt(lambda);
+      ry *= math.sqrt(lambda);
+    }
+
+    final numerator =
+        rx * rx * ry * ry - rx * rx * y1p * y1p - ry * ry * x1p * x1p;
+    final denominator = rx * rx * y1p * y1p + ry * ry * x1p * x1p;
+    final coefficient = (largeArc == sweep ? -1 : 1) *
+        math.sqrt(math.max(0.0, numerator / denominator));
+    final cxp = coefficient * rx * y1p / ry;
+    final cyp = -coefficient * ry * x1p / rx;
+    final cx = cosPhi * cxp - sinPhi * cyp + (x1 + x) / 2;
+    final cy = sinPhi * cxp + cosPhi * cyp + (y1 + y) / 2;
+
+    double angle(double ux, double uy, double vx, double vy) =>
+        math.atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+
+    final theta = angle(1, 0, (x1p - cxp) / rx, (y1p - cyp) / ry);
+    var delta = angle(
+      (x1p - cxp) / rx,
+      (y1p - cyp) / ry,
+      (-x1p - cxp) / rx,
+      (-y1p - cyp) / ry,
+    );
+    if (!sweep && delta > 0) delta -= 2 * math.pi;
+    if (sweep && delta < 0) delta += 2 * math.pi;
+
+    // At most a quarter turn per curve
+    final count = math.max(1, (delta.abs() / (math.pi / 2)).ceil());
+    final step = delta / count;
+    final k = 4 / 3 * math.tan(step / 4);
+
+    (double, double) point(double t) => (
+          cx + rx * math.cos(t) * cosPhi - ry * math.sin(t) * sinPhi,
+          cy + rx * math.cos(t) * sinPhi + ry * math.sin(t) * cosPhi,
+        );
+    (double, double) tangent(double t) => (
+          -rx * math.sin(t) * cosPhi - ry * math.cos(t) * sinPhi,
+          -rx * math.sin(t) * sinPhi + ry * math.cos(t) * cosPhi,
+        );
+
+    for (int i = 0; i < count; i++) {
+      final t1 = theta + i * step;
+      final t2 = t1 + step;
+      final (px1, py1) = point(t1);
+      final (tx1, ty1) = tangent(t1);
+      final (px2, py2) = i == count - 1 ? (x, y) : point(t2);
+      final (tx2, ty2) = tangent(t2);
+      curveTo(
+        px1 + k * tx1,
+        py1 + k * ty1,
+        px2 - k * tx2,
+        py2 - k * ty2,
+        px2,
+        py2,
+      );
+    }
+  }
+
+  void close() {
+    if (isEmpty) return;
+    _segments.add((_opClosePath, const []));
+    _x = _startX;
+    _y = _startY;
+  }
+
+  void writeTo(_DisplayList list) {
+    for (final (op, operands) in _segments) {
+      list.op(op);
+      list.floats(operands);
+    }
+  }
+}
+
+/// Compiles the elements of an SVG document into a [_DisplayList]
+class _SvgCompiler {
+  final _DisplayList list = _DisplayList();
+  final Map<String, XmlElement> _ids = {};
+  final Set<String> _skipped = {};
+  double _viewWidth = 0, _viewHeight = 0;
+
+  /// Deepest nesting of groups and references followed
+  static const int _maxDepth = 32;
+
+  _SvgCompiler(XmlDocument document) {
+    for (final element in document.descendantElements) {
+      final id = element.getAttribute('id');
+      if (id != null) _ids[id] = element;
+    }
+  }
+
+  /// Returns the size of the image and the transform from the `viewBox` of
+  /// [root] to it, as `preserveAspectRatio` asks
+  (int, int, _Matrix) viewport(XmlElement root, int width, int height) {
+    final viewBox = _numbers(root.getAttribute('viewBox') ?? '');
+    final hasViewBox =
+        viewBox.length == 4 && viewBox[2] > 0 && viewBox[3] > 0;
+    // Percentages are relative to a viewport the splash does not have
+    double? absolute(String? value) =>
+        value == null || value.trim().endsWith('%') ? null : _length(value);
+    final intrinsicWidth = absolute(root.getAttribute('width')) ??
+        (hasViewBox ? viewBox[2] : null);
+    final intrinsicHeight = absolute(root.getAttribute('height')) ??
+        (hasViewBox ? viewBox[3] : null);
+
+    final w = width > 0 ? width.toDouble() : intrinsicWidth;
+    final h = height > 0 ? height.toDouble() : intrinsicHeight;
+    if (w == null || h == null || w < 1 || h < 1) {
+      throw const FormatException(
+        'The SVG document has no size, set image_width and image_height',
+      );
+    }
+    final imageWidth = w.round();
+    final imageHeight = h.round();
+
+    // Without a viewBox, the user space is the image itself, only stretched
+    // when another size than the intrinsic one is asked for
+    final vx = hasViewBox ? viewBox[0] : 0.0;
+    final vy = hasViewBox ? viewBox[1] : 0.0;
+    final vw = hasViewBox ? viewBox[2] : intrinsicWidth ?? w;
+    final vh = hasViewBox ? viewBox[3] : intrinsicHeight ?? h;
+    _viewWidth = vw;
+    _viewHeight = vh;
+
+    var sx = imageWidth / vw;
+    var sy = imageHeight / vh;
+    double tx = 0, ty = 0;
+    final aspect = (root.getAttribute('preserveAspectRatio') ?? '')
+        .trim()
+        .split(RegExp(r'\s+'));
+    final align = aspect.first.isEmpty ? 'xMidYMid' : aspect.first;
+    if (align != 'none') {
+      final slice = aspect.length > 1 && aspect[1] == 'slice';
+      sx = sy = slice ? math.max(sx, sy) : math.min(sx, sy);
+      final spareX = imageWidth - vw * sx;
+      final spareY = imageHeight - vh * sy;
+      if (align.contains('xMid')) tx = spareX / 2;
+      if (align.contains('xMax')) tx = spareX;
+      if (align.contains('YMid')) ty = spareY / 2;
+      if (align.contains('YMax')) ty = spareY;
+    }
+
+    return (
+      imageWidth,
+      imageHeight,
+      _Matrix.translate(tx, ty) *
+          _Matrix.scale(sx, sy) *
+          _Matrix.translate(-vx, -vy),
+    );
+  }
+
+  void renderChildren(XmlElement parent, _Style style, int depth) {
+    for (final child in parent.childElements) {
+      render(child, style, depth);
+    }
+  }
+
+  void render(XmlElement element, _Style parentStyle, int depth) {
+    final name = element.name.local;
+    const ignored = {
+      'defs',
+      'title',
+      'desc',
+      'metadata',
+      'style',
+      'symbol',
+      'stop',
+      'linearGradient',
+      'radialGradient',
+    };
+    if (ignored.contains(name) || depth > _maxDepth) return;
+    if (_property(element, 'display') == 'none' ||
+        _property(element, 'visibility') == 'hidden') {
+      return;
+    }
+
+    final style = _inherit(element, parentStyle);
+    final transform = _transform(element.getAttribute('transform'));
+    final opacity =
+        (_number(_property(element, 'opacity')) ?? 1.0).clamp(0.0, 1.0);
+    if (opacity == 0 || !transform.isInvertible) return;
+
+    final hasTransform = !transform.isIdentity;
+    if (hasTransform) {
+      list.op(_opSave);
+      list.transform(transform);
+    }
+    if (opacity < 1) list.op(_opPushGroup);
+
+    switch (name) {
+      case 'g' || 'a' || 'svg' || 'switch':
+        renderChildren(element, style, depth + 1);
+      case 'use':
+        _renderUse(element, style, depth);
+      case 'path':
+        _paint(_parsePath(element.getAttribute('d') ?? ''), style);
+      case 'rect':
+        _paint(_rect(element), style);
+      case 'circle':
+        final r = _attribute(element, 'r');
+        _paint(_ellipse(element, r, r), style);
+      case 'ellipse':
+        final rx = _attribute(element, 'rx');
+        _paint(_ellipse(element, rx, _attribute(element, 'ry')), style);
+      case 'line':
+        _paint(
+          _Path()
+            ..moveTo(_attribute(element, 'x1'), _attribute(element, 'y1'))
+            ..lineTo(_attribute(element, 'x2'), _attribute(element, 'y2')),
+          style,
+        );
+      case 'polyline' || 'polygon':
+        final points = _numbers(element.getAttribute('points') ?? '');
+        final path = _Path();
+        for (int i = 0; i + 1 < points.length; i += 2) {
+          if (i == 0) {
+            path.moveTo(points[i], points[i + 1]);
+          } else {
+            path.lineTo(points[i], points[i + 1]);
+          }
+        }
+        if (name == 'polygon') path.close();
+        _paint(path, style);
+      default:
+        if (_skipped.add(name)) {
+          logger.w('Skipping the unsupported SVG element <$name>');
+        }
+    }
+
+    if (opacity < 1) {
+      list.op(_opPopGroup);
+      list.f32(opacity);
+    }
+    if (hasTransform) list.op(_opRestore);
+  }
+
+  void _renderUse(XmlElement element, _Style style, int depth) {
+    final target = _ids[_reference(_href(element))];
+    if (target == null || target == element) return;
+
+    final offset = _Matrix.translate(
+      _attribute(element, 'x'),
+      _attribute(element, 'y'),
+    );
+    list.op(_opSave);
+    list.transform(offset);
+    if (target.name.local == 'symbol') {
+      renderChildren(target, style, depth + 1);
+    } else {
+      render(target, style, depth + 1);
+    }
+    list.op(_opRestore);
+  }
+
+  /// Fills then strokes [path] as [style] asks, skipping paints that can
+  /// not be drawn
+  void _paint(_Path path, _Style style) {
+    if (path.isEmpty) return;
+
+    final fill = _source(style.fill, style.fillOpacity, path, style.color);
+    final stroke = style.strokeWidth > 0
+        ? _source(style.stroke, style.strokeOpacity, path, style.color)
+        : null;
+    if (fill == null && stroke == null) return;
+
+    path.writeTo(list);
+    if (fill != null) {
+      fill();
+      list.op(_opFill);
+      list.u8(
+        (style.evenOdd ? _fillEvenOdd : 0) |
+            (stroke != null ? _fillPreserve : 0),
+      );
+    }
+    if (stroke != null) {
+      stroke();
+      list.op(_opStroke);
+      list.f32(style.strokeWidth);
+      list.u8(style.lineCap);
+      list.u8(style.lineJoin);
+      list.f32(style.miterLimit);
+    }
+  }
+
+  /// Returns the writer of the source operation of [paint] over [path], or
+  /// null when nothing would be drawn
+  void Function()? _source(
+    _Paint? paint,
+    double opacity,
+    _Path path,
+    int currentColor,
+  ) {
+    if (paint == null || opacity <= 0) return null;
+
+    final gradient = paint.gradient != null ? _ids[paint.gradient] : null;
+    if (gradient != null &&
+        (gradient.name.local == 'linearGradient' ||
+            gradient.name.local == 'radialGradient')) {
+      return _gradientSource(gradient, opacity, path);
+    }
+
+    final color = paint.color;
+    if (color == null) return null;
+    final argb = _withOpacity(
+      color == _currentColor ? currentColor : color,
+      opacity,
+    );
+    if (argb >>> 24 == 0) return null;
+    return () {
+      list.op(_opSolid);
+      list.u32(argb);
+    };
+  }
+
+  void Function()? _gradientSource(
+    XmlElement gradient,
+    double opacity,
+    _Path path,
+  ) {
+    final stops = _stops(gradient, opacity);
+    if (stops.isEmpty) return null;
+    if (stops.length == 1) {
+      final argb = stops.first.$2;
+      return () {
+        list.op(_opSolid);
+        list.u32(argb);
+      };
+    }
+
+    // Gradients of the bounding box are drawn over the geometry of the path
+    var matrix = _transform(_gradientAttribute(gradient, 'gradientTransform'));
+    final boxUnits =
+        _gradientAttribute(gradient, 'gradientUnits') != 'userSpaceOnUse';
+    if (boxUnits) {
+      final (x, y, width, height) = path.bounds;
+      if (width <= 0 || height <= 0) return null;
+      matrix = _Matrix(width, 0, 0, height, x, y) * matrix;
+    }
+    if (!matrix.isInvertible) return null;
+
+    double coordinate(String name, String fallback, double size) {
+      final value = _gradientAttribute(gradient, name) ?? fallback;
+      final number = _number(value) ?? 0.0;
+      if (value.trim().endsWith('%')) {
+        return number / 100 * (boxUnits ? 1 : size);
+      }
+      return number;
+    }
+
+    final diagonal = math.sqrt(
+          _viewWidth * _viewWidth + _viewHeight * _viewHeight,
+        ) /
+        math.sqrt2;
+    final extend = switch (_gradientAttribute(gradient, 'spreadMethod')) {
+      'reflect' => _extendReflect,
+      'repeat' => _extendRepeat,
+      _ => _extendPad,
+    };
+
+    final List<double> geometry;
+    final int op;
+    if (gradient.name.local == 'linearGradient') {
+      op = _opLinear;
+      geometry = [
+        coordinate('x1', '0%', _viewWidth),
+        coordinate('y1', '0%', _viewHeight),
+        coordinate('x2', '100%', _viewWidth),
+        coordinate('y2', '0%', _viewHeight),
+      ];
+    } else {
+      op = _opRadial;
+      final cx = coordinate('cx', '50%', _viewWidth);
+      final cy = coordinate('cy', '50%', _viewHeight);
+      final r = coordinate('r', '50%', diagonal);
+      if (r <= 0) return null;
+      geometry = [
+        _gradientAttribute(gradient, 'fx') != null
+            ? coordinate('fx', '50%', _viewWidth)
+            : cx,
+        _gradientAttribute(gradient, 'fy') != null
+            ? coordinate('fy', '50%', _viewHeight)
+            : cy,
+        cx,
+        cy,
+        r,
+      ];
+    }
+
+    return () {
+      list.op(op);
+      list.floats(geometry);
+      list.floats(matrix.values);
+      list.u8(extend);
+      list.u32(stops.length);
+      for (final (offset, argb) in stops) {
+        list.f32(offset);
+        list.u32(argb);
+      }
+    };
+  }
+
+  /// Returns the stops of [gradient] as (offset, ARGB) pairs, from the first
+  /// gradient of its `href` chain that has any
+  List<(double, int)> _stops(XmlElement gradient, double opacity) {
+    XmlElement? current = gradient;
+    for (int i = 0; current != null && i < _maxDepth; i++) {
+      final elements = current.childElements
+          .where((element) => element.name.local == 'stop')
+          .toList();
+      if (elements.isNotEmpty) {
+        final stops = <(double, int)>[];
+        double previous = 0;
+        for (final stop in elements) {
+          final value = stop.getAttribute('offset') ?? '0';
+          var offset = _number(value) ?? 0.0;
+          if (value.trim().endsWith('%')) offset /= 100;
+          // Offsets never go back, as the specification clamps them
+          offset = math.max(previous, offset.clamp(0.0, 1.0));
+          previous = offset;
+
+          final color = _color(_property(stop, 'stop-color') ?? 'black') ??
+              0xFF000000;
+          final stopOpacity =
+              (_number(_property(stop, 'stop-opacity')) ?? 1.0).clamp(0.0, 1.0);
+          stops.add((
+            offset,
+            _withOpacity(
+              color == _currentColor ? 0xFF000000 : color,
+              opacity * stopOpacity,
+            ),
+          ));
+        }
+        return stops;
+      }
+      current = _ids[_reference(_href(current))];
+    }
+    return const [];
+  }
+
+  /// Returns the attribute [name] of [gradient], or of the first gradient of
+  /// its `href` chain that sets it
+  String? _gradientAttribute(XmlElement gradient, String name) {
+    XmlElement? current = gradient;
+    for (int i = 0; current != null && i < _maxDepth; i++) {
+      final value = current.getAttribute(name);
+      if (value != null) return value;
+      current = _ids[_reference(_href(current))];
+    }
+    return null;
+  }
+
+  _Path _rect(XmlElement element) {
+    final x = _attribute(element, 'x');
+    final y = _attribute(element, 'y');
+    final width = _attribute(element, 'width');
+    final height = _attribute(element, 'height');
+    final path = _Path();
+    if (width <= 0 || height <= 0) return path;
+
+    // A missing radius takes the value of the other one
+    final rxValue = _length(element.getAttribute('rx'));
+    final ryValue = _length(element.getAttribute('ry'));
+    final rx = math.min(rxValue ?? ryValue ?? 0.0, width / 2);
+    final ry = math.min(ryValue ?? rxValue ?? 0.0, height / 2);
+
+    if (rx <= 0 || ry <= 0) {
+      return path
+        ..moveTo(x, y)
+        ..lineTo(x + width, y)
+        ..lineTo(x + width, y + height)
+        ..lineTo(x, y + height)
+        ..close();
+    }
+    return path
+      ..moveTo(x + rx, y)
+      ..lineTo(x + width - rx, y)
+      ..arcTo(rx, ry, 0, false, true, x + width, y + ry)
+      ..lineTo(x + width, y + height - ry)
+      ..arcTo(rx, ry, 0, false, true, x + width - rx, y + height)
+      ..lineTo(x + rx, y + height)
+      ..arcTo(rx, ry, 0, false, true, x, y + height - ry)
+      ..lineTo(x, y + ry)
+      ..arcTo(rx, ry, 0, false, true, x + rx, y)
+      ..close();
+  }
+
+  _Path _ellipse(XmlElement element, double rx, double ry) {
+    final cx = _attribute(element, 'cx');
+    final cy = _attribute(element, 'cy');
+    final path = _Path();
+    if (rx <= 0 || ry <= 0) return path;
+    return path
+      ..moveTo(cx + rx, cy)
+      ..arcTo(rx, ry, 0, false, true, cx - rx, cy)
+      ..arcTo(rx, ry, 0, false, true, cx + rx, cy)
+      ..close();
+  }
+
+  /// Returns the style of [element], inheriting what it does not set from
+  /// [parent]
+  _Style _inherit(XmlElement element, _Style parent) {
+    final color = _paintColor(_property(element, 'color'), parent.color);
+    final fillRule = _property(element, 'fill-rule');
+    final strokeWidth = _length(_property(element, 'stroke-width'));
+
+    return _Style(
+      fill: _parsePaint(_property(element, 'fill'), parent.fill),
+      stroke: _parsePaint(_property(element, 'stroke'), parent.stroke),
+      color: color,
+      fillOpacity: (_number(_property(element, 'fill-opacity')) ??
+              parent.fillOpacity)
+          .clamp(0.0, 1.0),
+      strokeOpacity: (_number(_property(element, 'stroke-opacity')) ??
+              parent.strokeOpacity)
+          .clamp(0.0, 1.0),
+      strokeWidth: strokeWidth ?? parent.strokeWidth,
+      evenOdd: fillRule != null ? fillRule == 'evenodd' : parent.evenOdd,
+      lineCap: switch (_property(element, 'stroke-linecap')) {
+        'butt' => 0,
+        'round' => 1,
+        'square' => 2,
+        _ => parent.lineCap,
+      },
+      lineJoin: switch (_property(element, 'stroke-linejoin')) {
+        'miter' => 0,
+        'round' => 1,
+        'bevel' => 2,
+        _ => parent.lineJoin,
+      },
+      miterLimit:
+          _number(_property(element, 'stroke-miterlimit')) ?? parent.miterLimit,
+    );
+  }
+
+  /// Returns the property [name] of [element], from its `style` attribute
+  /// or else from its presentation attribute
+  String? _property(XmlElement element, String name) {
+    final style = element.getAttribute('style');
+    if (style != null) {
+      for (final declaration in style.split(';')) {
+        final separator = declaration.indexOf(':');
+        if (separator < 0) continue;
+        if (declaration.substring(0, separator).trim() == name) {
+          final value = declaration.substring(separator + 1).trim();
+          return value == 'inherit' ? null : value;
+        }
+      }
+    }
+    final value = element.getAttribute(name)?.trim();
+    return value == 'inherit' ? null : value;
+  }
+
+  /// Returns the length attribute [name] of [element], 0 when missing
+  double _attribute(XmlElement element, String name) {
+    final value = element.getAttribute(name);
+    final length = _length(value) ?? 0.0;
+    if (value != null && value.trim().endsWith('%')) {
+      final size = switch (name) {
+        'x' || 'cx' || 'x1' || 'x2' || 'width' || 'rx' => _viewWidth,
+        'y' || 'cy' || 'y1' || 'y2' || 'height' || 'ry' => _viewHeight,
+        _ => math.sqrt(
+              _viewWidth * _viewWidth + _viewHeight * _viewHeight,
+            ) /
+            math.sqrt2,
+      };
+      return length / 100 * size;
+    }
+    return length;
+  }
+}
+
+/// Stands for `currentColor` until the color it resolves to is known
+const int _currentColor = -1;
+
+/// Parses a paint, null when it is `none`, [parent] when it is not set
+_Paint? _parsePaint(String? value, _Paint? parent) {
+  if (value == null || value.isEmpty) return parent;
+  if (value == 'none') return null;
+
+  final reference = RegExp(r'^url\(\s*#([^)\s]+)\s*\)\s*(.*)$').firstMatch(
+    value,
+  );
+  if (reference != null) {
+    final fallback = reference[2]!.trim();
+    return _Paint.gradient(
+      reference[1]!,
+      fallback.isEmpty || fallback == 'none' ? null : _color(fallback),
+    );
+  }
+
+  final color = _color(value);
+  return color != null ? _Paint.color(color) : parent;
+}
+
+int _paintColor(String? value, int parent) {
+  if (value == null) return parent;
+  final color = _color(value);
+  return color == null || color == _currentColor ? parent : color;
+}
+
+const Map<String, int> _namedColors = {
+  'transparent': 0x00000000,
+  'black': 0xFF000000,
+  'white': 0xFFFFFFFF,
+  'red': 0xFFFF0000,
+  'green': 0xFF008000,
+  'lime': 0xFF00FF00,
+  'blue': 0xFF0000FF,
+  'yellow': 0xFFFFFF00,
+  'cyan': 0xFF00FFFF,
+  'aqua': 0xFF00FFFF,
+  'magenta': 0xFFFF00FF,
+  'fuchsia': 0xFFFF00FF,
+  'gray': 0xFF808080,
+  'grey': 0xFF808080,
+  'silver': 0xFFC0C0C0,
+  'maroon': 0xFF800000,
+  'olive': 0xFF808000,
+  'navy': 0xFF000080,
+  'purple': 0xFF800080,
+  'teal': 0xFF008080,
+  'orange': 0xFFFFA500,
+};
+
+/// Parses a CSS color as ARGB, [_currentColor] for `currentColor`, or null
+/// when it is not understood
+int? _color(String value) {
+  value = value.trim().toLowerCase();
+  if (value == 'currentcolor') return _currentColor;
+
+  final named = _namedColors[value];
+  if (named != null) return named;
+
+  if (value.startsWith('#')) {
+    var hex = value.substring(1);
+    if (hex.length == 3 || hex.length == 4) {
+      hex = hex.split('').map((c) => '$c$c').join();
+    }
+    final value = int.tryParse(hex, radix: 16);
+    if (value == null) return null;
+    // #RRGGBBAA puts the alpha last
+    return switch (hex.length) {
+      6 => 0xFF000000 | value,
+      8 => (value & 0xFF) << 24 | value >>> 8,
+      _ => null,
+    };
+  }
+
+  final function = RegExp(r'^rgba?\(([^)]*)\)$').firstMatch(value);
+  if (function != null) {
+    final parts = function[1]!.split(RegExp(r'[\s,/]+'))
+      ..removeWhere((part) => part.isEmpty);
+    if (parts.length < 3) return null;
+    // Channels are numbers or percentages, the alpha a fraction or one
+    double fraction(String part, double unit) {
+      final number = _number(part) ?? 0.0;
+      return part.endsWith('%') ? number / 100 : number / unit;
+    }
+
+    int channel(String part, double unit) =>
+        (fraction(part, unit) * 255).round().clamp(0, 255);
+
+    final alpha = parts.length > 3 ? channel(parts[3], 1) : 255;
+    return alpha << 24 |
+        channel(parts[0], 255) << 16 |
+        channel(parts[1], 255) << 8 |
+        channel(parts[2], 255);
+  }
+  return null;
+}
+
+/// Multiplies the alpha of [argb] by [opacity]
+int _withOpacity(int argb, double opacity) {
+  final alpha = ((argb >>> 24) * opacity).round().clamp(0, 255);
+  return alpha << 24 | (argb & 0xFFFFFF);
+}
+
+final RegExp _numberPattern = RegExp(r'[+-]?(\d+\.?\d*|\.\d+)([eE][+-]?\d+)?');
+
+/// Parses the number at the start of [value], ignoring any unit
+double? _number(String? value) {
+  if (value == null) return null;
+  final match = _numberPattern.matchAsPrefix(value.trim());
+  return match != null ? double.parse(match[0]!) : null;
+}
+
+/// Parses a length in user units, converting absolute units
+double? _length(String? value) {
+  if (value == null) return null;
+  final number = _number(value);
+  if (number == null) return null;
+  final unit = value.trim().replaceFirst(_numberPattern, '').trim();
+  return switch (unit) {
+    'pt' => number * 4 / 3,
+    'pc' => number * 16,
+    'mm' => number * 96 / 25.4,
+    'cm' => number * 96 / 2.54,
+    'in' => number * 96,
+    _ => number,
+  };
+}
+
+/// Parses every number of a list, e.g. a `viewBox` or `points`
+List<double> _numbers(String value) => [
+      for (final match in _numberPattern.allMatches(value))
+        double.parse(match[0]!),
+    ];
+
+String? _href(XmlElement element) =>
+    element.getAttribute('href') ?? element.getAttribute('xlink:href');
+
+/// The id of a local `#id` reference
+String? _reference(String? href) =>
+    href != null && href.startsWith('#') ? href.substring(1) : null;
+
+/// Parses a `transform` attribute, applied right to left like SVG does
+_Matrix _transform(String? value) {
+  var matrix = _Matrix.identity;
+  if (value == null) return matrix;
+
+  final function = RegExp(r'(\w+)\s*\(([^)]*)\)');
+  for (final match in function.allMatches(value)) {
+    final args = _numbers(match[2]!);
+    double arg(int i, double fallback) => i < args.length ? args[i] : fallback;
+    final _Matrix step;
+    switch (match[1]) {
+      case 'matrix' when args.length == 6:
+        step = _Matrix(args[0], args[1], args[2], args[3], args[4], args[5]);
+      case 'translate':
+        step = _Matrix.translate(arg(0, 0), arg(1, 0));
+      case 'scale':
+        step = _Matrix.scale(arg(0, 1), arg(1, arg(0, 1)));
+      case 'rotate':
+        final angle = arg(0, 0) * math.pi / 180;
+        final cos = math.cos(angle), sin = math.sin(angle);
+        final cx = arg(1, 0), cy = arg(2, 0);
+        step = _Matrix.translate(cx, cy) *
+            _Matrix(cos, sin, -sin, cos, 0, 0) *
+            _Matrix.translate(-cx, -cy);
+      case 'skewX':
+        step = _Matrix(1, 0, math.tan(arg(0, 0) * math.pi / 180), 1, 0, 0);
+      case 'skewY':
+        step = _Matrix(1, math.tan(arg(0, 0) * math.pi / 180), 0, 1, 0, 0);
+      default:
+        throw FormatException('Invalid SVG transform: ${match[0]}');
+    }
+    matrix = matrix * step;
+  }
+  return matrix;
+}
+
+/// Scanner over the commands and numbers of path data
+class _PathScanner {
+  final String source;
+  int position = 0;
+
+  _PathScanner(this.source);
+
+  static final RegExp _separator = RegExp(r'[\s,]*');
+
+  static final RegExp _letter = RegExp(r'[A-Za-z]');
+
+  void _skip() {
+    position = _separator.matchAsPrefix(source, position)!.end;
+  }
+
+  bool get isDone {
+    _skip();
+    return position >= source.length;
+  }
+
+  /// Returns the command letter at the current position, if any
+  String? command() {
+    _skip();
+    if (position < source.length &&
+        _letter.hasMatch(source[position])) {
+      return source[position++];
+    }
+    return null;
+  }
+
+  double number() {
+    _skip();
+    final match = _numberPattern.matchAsPrefix(source, position);
+    if (match == null) {
+      throw FormatException('Invalid SVG path data', source, position);
+    }
+    position = match.end;
+    return double.parse(match[0]!);
+  }
+
+  /// Reads an arc flag, which needs no separator from what follows
+  bool flag() {
+    _skip();
+    if (position < source.length &&
+        (source[position] == '0' || source[position] == '1')) {
+      return source[position++] == '1';
+    }
+    throw FormatException('Invalid SVG arc flag', source, position);
+  }
+}
+
+/// Parses the `d` attribute of a path
+_Path _parsePath(String data) {
+  final path = _Path();
+  final scanner = _PathScanner(data);
+  String? command;
+  // Second control point of the previous curve, for the smooth ones
+  double? controlX, controlY;
+  String previous = '';
+
+  while (!scanner.isDone) {
+    final letter = scanner.command();
+    if (letter != null) {
+      command = letter;
+    } else if (command == null || command.toLowerCase() == 'z') {
+      throw FormatException('Invalid SVG path data', data, scanner.position);
+    }
+
+    final relative = command == command.toLowerCase();
+    final ox = relative ? path.x : 0.0;
+    final oy = relative ? path.y : 0.0;
+    final type = command.toUpperCase();
+
+    // Reflects the previous control point when the previous segment is of
+    // the same kind, else the current point is used
+    (double, double) reflected(String kinds) =>
+        kinds.contains(previous) && controlX != null
+            ? (2 * path.x - controlX!, 2 * path.y - controlY!)
+            : (path.x, path.y);
+
+    switch (type) {
+      case 'M':
+        path.moveTo(ox + scanner.number(), oy + scanner.number());
+        // Coordinates following a move are implicit lines
+        command = relative ? 'l' : 'L';
+      case 'L':
+        path.lineTo(ox + scanner.number(), oy + scanner.number());
+      case 'H':
+        path.lineTo(ox + scanner.number(), path.y);
+      case 'V':
+        path.lineTo(path.x, oy + scanner.number());
+      case 'C':
+        final x1 = ox + scanner.number(), y1 = oy + scanner.number();
+        final x2 = ox + scanner.number(), y2 = oy + scanner.number();
+        final x = ox + scanner.number(), y = oy + scanner.number();
+        path.curveTo(x1, y1, x2, y2, x, y);
+        (controlX, controlY) = (x2, y2);
+      case 'S':
+        final (x1, y1) = reflected('CS');
+        final x2 = ox + scanner.number(), y2 = oy + scanner.number();
+        final x = ox + scanner.number(), y = oy + scanner.number();
+        path.curveTo(x1, y1, x2, y2, x, y);
+        (controlX, controlY) = (x2, y2);
+      case 'Q':
+        final x1 = ox + scanner.number(), y1 = oy + scanner.number();
+        final x = ox + scanner.number(), y = oy + scanner.number();
+        path.quadTo(x1, y1, x, y);
+        (controlX, controlY) = (x1, y1);
+      case 'T':
+        final (x1, y1) = reflected('QT');
+        final x = ox + scanner.number(), y = oy + scanner.number();
+        path.quadTo(x1, y1, x, y);
+        (controlX, controlY) = (x1, y1);
+      case 'A':
+        final rx = scanner.number(), ry = scanner.number();
+        final rotation = scanner.number();
+        final largeArc = scanner.flag(), sweep = scanner.flag();
+        path.arcTo(
+          rx,
+          ry,
+          rotation,
+          largeArc,
+          sweep,
+          ox + scanner.number(),
+          oy + scanner.number(),
+        );
+      case 'Z':
+        path.close();
+      default:
+        throw FormatException('Invalid SVG path command $command', data);
+    }
+    previous = type;
+  }
+  return path;
+}
@@ -147,7 +147,11 @@ DesktopSplashConfig? checkWindows(
   return result;
 }
 
-Future<void> handleWindows(SplashScreenConfig config, bool verbose) async {
+Future<void> handleWindows(
+  SplashScreenConfig config,
+  bool verbose, {
+  bool force = false,
+}) async {
   if (!config.platforms.hasWindows) {
     if (verbose) {
       logger.w("Windows platform is not enabled.");
@@ -175,15 +179,6 @@ Future<void> handleWindows(SplashScreenConfig config, bool verbose) async {
     verbose,
     RELEASE,
   );
-  final r2 = await generateWindowsCode(
-    config: r1!,
-    flavor: RELEASE,
-    outputDir: distDir,
-  );
-  if (r2 && verbose) {
-    logger.success("Generated Windows $RELEASE configuration.");
-  }
-
   final p1 = checkWindows(
     config.platforms.windows!,
     config.profile.windows,
@@ -191,15 +186,6 @@ Future<void> handleWindows(SplashScreenConfig config, bool verbose) async {
     verbose,
     PROFILE,
   );
-  final p2 = await generateWindowsCode(
-    config: p1!,
-    flavor: PROFILE,
-    outputDir: distDir,
-  );
-  if (p2 && verbose) {
-    logger.success("Generated Windows $PROFILE configuration.");
-  }
-
   final d1 = checkWindows(
     config.platforms.windows!,
     config.debug.windows,
@@ -207,15 +193,26 @@ Future<void> handleWindows(SplashScreenConfig config, bool verbose) async {
     verbose,
     DEBUG,
   );
-  final d2 = await generateWindowsCode(
-    config: d1!,
-    flavor: DEBUG,
-    outputDir: distDir,
-  );
-  if (d2 && verbose) {
-    logger.success("Generated Windows $DEBUG configuration.");
+
+  // The flavors are independent, generate them concurrently
+  final flavors = {RELEASE: r1!, PROFILE: p1!, DEBUG: d1!};
+  final results = await Future.wait([
+    for (final MapEntry(key: flavor, value: flavorConfig) in flavors.entries)
+      generateWindowsCode(
+        config: flavorConfig,
+        flavor: flavor,
+        outputDir: distDir,
+        force: force,
+      ),
+  ]);
+
+  final names = flavors.keys.toList();
+  for (int i = 0; i < names.length; i++) {
+    if (results[i] && verbose) {
+      logger.success("Generated Windows ${names[i]} configuration.");
+    }
   }
-  if (r2 && p2 && d2) {
+  if (!results.contains(false)) {
     logger.success("Generated Windows configuration successfully.");
   }
 
@@ -88,15 +88,89 @@ Use the --force option to overwrite it.
 #   - background_width (int): Width of the background rectangle.
 #   - background_height (int): Height of the background rectangle.
 #   - background_border_radius (double): Radius for background corner rounding.
+#   - background_gradient (string): [Linux only] Gradient drawn over the
+#                                   background rectangle, one of "none",
+#                                   "linear" or "radial". Default to "none".
+#   - background_gradient_color (string): [Linux only] Gradient end color,
+#                                         it starts from `background_color`.
+#   - background_gradient_angle (double): [Linux only] Direction of a linear
+#                                         gradient in degrees.
+#                                         Default to 90.0 (top to bottom).
 #
 #   - image_path (string): Path to the splash image. This field is **required**.
 #                          Must point to an valid image file.
+#                          [Linux only] An .svg file is compiled to vector
+#                          drawing operations the plugin draws at the scale
+#                          of the display, sharp without image_scales.
+#                          Shapes, paths, transforms, colors and gradients
+#                          are supported, text, images, clip paths, masks
+#                          and filters are not. It can only be embedded.
+#   - image_path_dark (string): [Linux only] Image shown instead of image_path
+#                               when the desktop prefers a dark appearance,
+#                               processed the same way. It is embedded
+#                               compressed and only decoded on dark desktops.
+#   - animation_path (string): [Linux only] Animated GIF, APNG or WebP
+#                              played over the splash, centered in the
+#                              background. Only the pixels that change
+#                              between frames are embedded.
+#   - animation_frames (List<String>): [Linux only] Image sequence played
+#                                      instead of animation_path, one file
+#                                      per frame.
+#   - animation_frame_duration (int): [Linux only] Milliseconds per frame of
+#                                     a sequence, or of frames without a
+#                                     duration. Default to 100.
+#   - animation_width (int): [Linux only] Width of the animation.
+#   - animation_height (int): [Linux only] Height of the animation. Default to
+#                             the size of its first frame.
+#   - animation_loop (bool): [Linux only] Play the animation in a loop
+#                            instead of once. Default to true.
+#   - spinner_size (int): [Linux only] Size of an indeterminate loading
+#                         spinner drawn by the plugin. Default to 0 (none).
+#   - spinner_color (string): [Linux only] Color of the spinner.
+#                             Default to "#808080".
+#   - spinner_offset_y (int): [Linux only] Distance from the center of the
+#                             background to the center of the spinner.
+#                             Default to just below the image.
+#   - spinner_period (int): [Linux only] Milliseconds per turn. Default to
+#                           1000.
+#   - spinner_frames (int): [Linux only] Number of pre-rotated frames (4 to
+#                           120), more is smoother but takes more memory.
+#                           Default to 30.
 #   - image_width (int): Width of the image inside the splash window.
 #   - image_height (int): Height of the image inside the splash window.
 #   - image_scaling (bool): Whether to allow upscaling of the image to fit.
 #   - image_border_radius (double): Radius for image corners.
 #   - blur_radius (double): Apply blur effect to the image. 0.0 = no blur.
 #                           This may help if your image look so sharp.
+#                           [Linux only] Drawn by the plugin at startup, the
+#                           embedded image stays sharp and unpadded.
+#   - image_shadow_color (string): [Linux only] Color of a drop shadow drawn
+#                                  by the plugin from the alpha of the image.
+#                                  A light color without offset makes a glow.
+#                                  Default to "#00000000" (none).
+#   - image_shadow_radius (double): [Linux only] Blur radius of the shadow
+#                                   (0 to 100). Default to 0.0.
+#   - image_shadow_offset_x (int): [Linux only] Horizontal offset of the
+#                                  shadow. Default to 0.
+#   - image_shadow_offset_y (int): [Linux only] Vertical offset of the
+#                                  shadow. Default to 0.
+#   - image_quantize_tolerance (int): [Linux only] Images with at most 256
+#                                     colors are embedded as a palette, 4x
+#                                     smaller. Above that, allow quantizing
+#                                     the image to 256 colors when no channel
+#                                     moves by more than this value (0-255).
+#                                     Default to 0 (lossless only).
+#   - image_storage (String): [Linux only] "embedded" compiles the image into
+#                             the binary, "file" writes it to a splash.nss
+#                             asset in the bundle data directory instead, so
+#                             it can be replaced without rebuilding.
+#                             Default to "embedded".
+#   - image_scales (List<int>): [Linux only] Scale factors (1 to 3) to render
+#                               the image for, e.g. [1, 2]. The variant
+#                               matching the display is picked at runtime.
+#                               Without image_width/image_height, the source
+#                               image is taken as the largest scale.
+#                               Default to [1].
 #   - with_animation (bool): Whether to animate the splash screen showing.
 #                            Default to "true".
 
@@ -108,6 +182,17 @@ Use the --force option to overwrite it.
 #   - `flavors`: Define any number of custom build flavors
 #                (e.g., "meeting", "staging", "internal", etc.)
 #
+# On Linux, `runtime_flavors: true` under `platforms.linux` embeds every
+# custom flavor in the binary next to the build configuration, and picks one
+# when the app starts, from the first of:
+#   - the `--splash-flavor=<name>` command-line flag,
+#   - the NATIVE_SPLASH_SCREEN_FLAVOR environment variable,
+#   - the last component of the application ID, e.g. `meeting` for
+#     `com.example.app.meeting`, once linux/runner/main.cc calls
+#     `g_set_prgname(APPLICATION_ID)` before `show_splash_screen()`.
+# The build configuration is shown when none matches. The images of these
+# flavors are always embedded compressed, only the selected one is decoded.
+#
 # If a flavor is missing for a platform:
 #   - And `fallback: true` for that platform -> `release` is used.
 #   - Otherwise -> the splash screen will not be shown on that platform.
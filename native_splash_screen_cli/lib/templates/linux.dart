@@ -1,5 +1,9 @@
+import 'dart:convert' show utf8;
 import 'dart:io';
+import 'dart:math' show max, min, sqrt;
+import 'dart:typed_data' show Uint8List, Uint32List;
 
+import 'package:image/image.dart' show Color;
 import 'package:path/path.dart' as path;
 
 import '../models/image.dart';
@@ -8,66 +12,433 @@ import '../models/desktop.dart';
 import '../common/utils.dart';
 
 import '../src/logger.dart';
+import '../src/asset.dart';
 import '../src/image.dart';
+import '../src/incremental.dart';
+import '../src/svg.dart';
+
+/// Places the pixel arrays in their own page-aligned section, which the
+/// plugin prefetches when the splash is shown and releases once it is closed
+const String _pixelDataAttribute =
+    '__attribute__((aligned(4096), section("native_splash_screen_data")))';
+
+/// Name of the asset file in the bundle data directory
+const String linuxAssetFile = 'splash.nss';
+
+/// Name of the generated source holding the tiles shared by all flavors
+const String linuxTilesFile = 'native_splash_screen_tiles.cc';
+
+/// Name of the generated source holding the flavors selected at runtime
+const String linuxFlavorsFile = 'native_splash_screen_flavors.cc';
 
 /// Generates Linux platform-specific code for the native splash screen
 ///
-/// Takes a [config] object containing splash screen configuration,
-/// a [flavor] string to support multiple build flavors,
-/// and an output [outputDir] to override the default location.
+/// Takes the splash screen configuration of every build [flavors], keyed by
+/// flavor name, and the [outputDir] to write the sources to.
+///
+/// The images of all embedded flavors are encoded together: when splitting
+/// them into tiles shared through [linuxTilesFile] embeds fewer bytes than
+/// encoding each image on its own, every flavor only gets a tile map.
+///
+/// Flavors using [ImageStorage.file] get their image written to a `.nss`
+/// asset next to their source instead, installed in the bundle data directory
+/// by the CMake file.
+///
+/// The HiDPI variants of [DesktopSplashConfig.imageScales] are compressed
+/// `.nss` blobs embedded next to the 1x image, or `@<scale>x.nss` assets next
+/// to the 1x asset. The plugin only decodes the one matching the display.
+///
+/// The [DesktopSplashConfig.imagePathDark] image is embedded at every scale,
+/// 1x included, as compressed blobs only decoded on a dark desktop, so it
+/// costs nothing but their size otherwise.
+///
+/// SVG images are compiled to a display list of vector operations instead,
+/// which the plugin draws once at the scale of the display, so they need no
+/// HiDPI variant. They can only be embedded.
+///
+/// The frames of [DesktopSplashConfig.animationPaths] are embedded as one
+/// keyframe followed by frames only holding their dirty rectangle, which the
+/// plugin inflates one after the other into a single frame surface.
+///
+/// The [runtimeFlavors], keyed by name, are embedded together in
+/// [linuxFlavorsFile] with an index the plugin selects one from when the app
+/// starts. Their images are only stored as compressed variants, so the
+/// flavors that are not shown are never decoded. The plugin then reads the
+/// generated globals, no compile-time copy of the settings is written.
+///
+/// The sources embed the hash of their inputs. When it did not change they
+/// are left untouched, unless [force] is set, and outputs whose content did
+/// not change are not rewritten either, so the build skips compiling them.
 ///
 /// Returns [true] if generation was successful, [false] otherwise.
 Future<bool> generateLinuxCode({
-  required DesktopSplashConfig config,
-  required String flavor,
+  required Map<String, DesktopSplashConfig> flavors,
+  Map<String, DesktopSplashConfig> runtimeFlavors = const {},
   required Directory outputDir,
+  bool force = false,
 }) async {
-  // Validate image file exists
-  final imageFile = File(config.imagePath);
-  if (!imageFile.existsSync()) {
-    logger.e('Image file not found: ${config.imagePath}');
+  for (final config in [...flavors.values, ...runtimeFlavors.values]) {
+    // Validate image file exists
+    final imageFile = File(config.imagePath);
+    if (!imageFile.existsSync()) {
+      logger.e('Image file not found: ${config.imagePath}');
+      return false;
+    }
+  }
+
+  // Flavors selected at runtime only come as compressed pixel variants
+  for (final config in runtimeFlavors.values) {
+    if (isSvgPath(config.imagePath)) {
+      logger.e(
+        'SVG images can not be used by runtime flavors: ${config.imagePath}',
+      );
+      return false;
+    }
+  }
+
+  int hash = await hashGenerationInputs([
+    ...flavors.values,
+    ...runtimeFlavors.values,
+  ]);
+  hash = fnv1a64(utf8.encode(runtimeFlavors.keys.join(',')), hash);
+  if (!force &&
+      _isUpToDate(
+        outputDir.path,
+        flavors,
+        hash,
+        runtimeFlavors: runtimeFlavors.isNotEmpty,
+      )) {
+    logger.i('Linux splash sources are up to date.');
+    return true;
+  }
+
+  // SVG images are compiled once, they are drawn at any scale
+  final vectors = <VectorImage?>[];
+  for (final config in flavors.values) {
+    if (!isSvgPath(config.imagePath)) {
+      vectors.add(null);
+      continue;
+    }
+    final vector = await _compileVectorImage(config);
+    if (vector == null) {
+      return false;
+    }
+    vectors.add(vector);
+  }
+
+  // Load and process the images of every flavor at every scale, concurrently
+  final loading = Future.wait([
+    for (int i = 0; i < flavors.length; i++)
+      vectors[i] != null
+          ? Future.value({1: _vectorLayout(vectors[i]!)})
+          : _loadImageVariants(flavors.values.elementAt(i)),
+  ]);
+  final darkLoading = Future.wait(flavors.values.map(_loadDarkImageVariants));
+  final animationLoading = Future.wait(flavors.values.map(_loadAnimation));
+  final loaded = await loading;
+  final dark = await darkLoading;
+  final animations = await animationLoading;
+  if (dark.contains(null) || animations.contains(null)) {
     return false;
   }
 
-  // Load and process the image
-  final BGRAImage? imageData = await _loadAndProcessImage(config);
-  if (imageData == null) {
+  final images = <BGRAImage>[];
+  final variants = <Map<int, BGRAImage>>[];
+  for (final scaled in loaded) {
+    if (scaled == null) {
+      return false;
+    }
+    images.add(scaled.remove(1)!);
+    variants.add(scaled);
+  }
+
+  final configs = flavors.values.toList();
+  final indexed = [
+    for (int i = 0; i < images.length; i++)
+      vectors[i] == null
+          ? encodeIndexed(
+              images[i],
+              tolerance: configs[i].imageQuantizeTolerance,
+            )
+          : null,
+  ];
+
+  // Only the embedded pixel images can share their tiles
+  final embedded = [
+    for (int i = 0; i < images.length; i++)
+      if (configs[i].imageStorage == ImageStorage.embedded &&
+          vectors[i] == null)
+        i,
+  ];
+
+  int separateSize = 0;
+  for (final i in embedded) {
+    final palette = indexed[i];
+    separateSize += palette != null
+        ? palette.indices.length + palette.palette.length * 4
+        : images[i].data.length;
+  }
+
+  final shared = encodeTiles([for (final i in embedded) images[i]]);
+  final tiles =
+      embedded.isNotEmpty && shared.byteSize < separateSize ? shared : null;
+
+  if (!await _generateTilesFile(
+    outputDir: outputDir.path,
+    tiles: tiles,
+    hash: hash,
+  )) {
     return false;
   }
 
-  // Generate the C++ source file
-  return _generateSourceFile(
+  if (!await _generateFlavorsFile(
     outputDir: outputDir.path,
-    flavor: flavor,
-    config: config,
-    imageData: imageData,
-  );
+    flavors: runtimeFlavors,
+    hash: hash,
+  )) {
+    return false;
+  }
+
+  // Generate the C++ source files
+  final names = flavors.keys.toList();
+  for (int i = 0; i < names.length; i++) {
+    final asFile = configs[i].imageStorage == ImageStorage.file;
+    final tileIndex = embedded.indexOf(i);
+
+    final generated = await _generateAssetFile(
+          outputDir: outputDir.path,
+          flavor: names[i],
+          imageData: asFile ? images[i] : null,
+          indexed: indexed[i],
+          variants: asFile ? variants[i] : const {},
+          tolerance: configs[i].imageQuantizeTolerance,
+        ) &&
+        await _generateSourceFile(
+          outputDir: outputDir.path,
+          flavor: names[i],
+          config: configs[i],
+          imageData: images[i],
+          indexed: indexed[i],
+          vector: vectors[i],
+          tiles: tiles,
+          tileMap: tileIndex >= 0 ? tiles?.maps[tileIndex] : null,
+          variants: asFile ? const {} : variants[i],
+          darkVariants: dark[i]!,
+          animation: animations[i]!,
+          hash: hash,
+          configHeader: runtimeFlavors.isEmpty,
+        );
+    if (!generated) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Whether the sources of [flavors] in [outputDir] were generated from
+/// inputs of the given [hash], along with the files they depend on
+///
+/// With [runtimeFlavors], [linuxFlavorsFile] takes the place of the headers
+/// of constexpr settings.
+bool _isUpToDate(
+  String outputDir,
+  Map<String, DesktopSplashConfig> flavors,
+  int hash, {
+  bool runtimeFlavors = false,
+}) {
+  final flavorsFile = File(path.join(outputDir, linuxFlavorsFile));
+  if (runtimeFlavors
+      ? !hasGenerationHash(flavorsFile, hash)
+      : flavorsFile.existsSync()) {
+    return false;
+  }
+
+  for (final MapEntry(key: flavor, value: config) in flavors.entries) {
+    final source = File(path.join(outputDir, 'native_splash_screen_$flavor.cc'));
+    final header = readGeneratedHeader(source);
+    final configHeader = File(
+      path.join(outputDir, 'native_splash_screen_$flavor.h'),
+    );
+    if (!header.contains(generationHashLine(hash)) ||
+        (runtimeFlavors
+            ? configHeader.existsSync()
+            : !hasGenerationHash(configHeader, hash))) {
+      return false;
+    }
+
+    if (header.contains(linuxTilesFile) &&
+        !hasGenerationHash(File(path.join(outputDir, linuxTilesFile)), hash)) {
+      return false;
+    }
+
+    if (config.imageStorage == ImageStorage.file &&
+        !File(path.join(outputDir, 'native_splash_screen_$flavor.nss'))
+            .existsSync()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Loads the image of [config] at every scale of
+/// [DesktopSplashConfig.imageScales], keyed by scale
+///
+/// The variant of scale `s` is rendered at `s` times the 1x size, with its
+/// blur and border radius scaled along, so it looks the same on a display of
+/// that scale factor. Without a configured image size the source image is
+/// taken as the largest scale. Scales the source is too small for are
+/// skipped unless image scaling is enabled.
+///
+/// Returns null if processing failed
+Future<Map<int, BGRAImage>?> _loadImageVariants(
+  DesktopSplashConfig config,
+) async {
+  if (config.imageScales.length == 1) {
+    final image = await _loadAndProcessImage(config);
+    return image != null ? {1: image} : null;
+  }
+
+  final int sourceWidth, sourceHeight;
+  try {
+    (sourceWidth, sourceHeight) = await readImageSize(config.imagePath);
+  } catch (e) {
+    logger.e('Failed to load or process the image: $e');
+    return null;
+  }
+
+  final hasSize = config.imageWidth > 0 && config.imageHeight > 0;
+  final maxScale = config.imageScales.last;
+  final width = hasSize ? config.imageWidth : sourceWidth ~/ maxScale;
+  final height = hasSize ? config.imageHeight : sourceHeight ~/ maxScale;
+
+  final scales = <int>[];
+  for (final scale in config.imageScales) {
+    if (scale > 1 &&
+        !config.imageScaling &&
+        (sourceWidth < width * scale || sourceHeight < height * scale)) {
+      logger.w(
+        'Skipping the ${scale}x splash image, ${config.imagePath} is smaller '
+        'than ${width * scale}x${height * scale}',
+      );
+      continue;
+    }
+    scales.add(scale);
+  }
+
+  final images = await Future.wait([
+    for (final scale in scales)
+      _loadAndProcessImage(
+        config.copyWith(
+          imageWidth: width * scale,
+          imageHeight: height * scale,
+          imageBorderRadius: config.imageBorderRadius * scale,
+        ),
+      ),
+  ]);
+  if (images.contains(null)) {
+    return null;
+  }
+  return {
+    for (int i = 0; i < scales.length; i++) scales[i]: images[i]!,
+  };
+}
+
+/// Loads the [DesktopSplashConfig.imagePathDark] image of [config] like
+/// [_loadImageVariants], or nothing when it has none
+///
+/// Returns null if processing failed
+Future<Map<int, BGRAImage>?> _loadDarkImageVariants(
+  DesktopSplashConfig config,
+) async {
+  final imagePathDark = config.imagePathDark;
+  if (imagePathDark == null) {
+    return const {};
+  }
+  return _loadImageVariants(config.copyWith(imagePath: imagePathDark));
+}
+
+/// Loads the frames of the [DesktopSplashConfig.animationPaths] of
+/// [config], or nothing when it has no animation
+///
+/// Returns null if decoding failed
+Future<List<AnimationFrame>?> _loadAnimation(
+  DesktopSplashConfig config,
+) async {
+  if (config.animationPaths.isEmpty) {
+    return const [];
+  }
+
+  try {
+    return await loadAnimationFrames(
+      config.animationPaths,
+      width: config.animationWidth,
+      height: config.animationHeight,
+      frameDuration: config.animationFrameDuration,
+    );
+  } catch (e) {
+    logger.e('Failed to load the splash animation: $e');
+    return null;
+  }
+}
+
+/// Compiles the SVG image of [config], at its configured size if any
+///
+/// Returns null if compiling failed
+Future<VectorImage?> _compileVectorImage(DesktopSplashConfig config) async {
+  try {
+    return compileSvg(
+      await File(config.imagePath).readAsString(),
+      width: config.imageWidth,
+      height: config.imageHeight,
+    );
+  } catch (e) {
+    logger.e('Failed to compile the SVG image ${config.imagePath}: $e');
+    return null;
+  }
+}
+
+/// Returns the stand-in of [vector] in the layout of the splash
+///
+/// Which pixels the paths cover is only known once the plugin draws them,
+/// so its pixels are all half opaque: the window shape keeps the whole box
+/// of the image, and it never counts as covering the window opaquely.
+BGRAImage _vectorLayout(VectorImage vector) {
+  final data = Uint8List(vector.width * vector.height * 4);
+  for (int i = 3; i < data.length; i += 4) {
+    data[i] = 0x80;
+  }
+  return BGRAImage(data: data, width: vector.width, height: vector.height);
 }
 
 /// Loads and processes the splash screen image according to configuration
 ///
+/// The background rectangle is not composed into the image, the plugin draws
+/// it at runtime from the parameters written by [_writeBackgroundSection],
+/// so only the foreground image pixels get embedded. The blur is left to the
+/// plugin as well, see [_writeImageEffectsSection], so the embedded image is
+/// trimmed to the sharp pixels and not their blurred halo.
+///
 /// Returns the processed [BGRAImage] or null if processing failed
 Future<BGRAImage?> _loadAndProcessImage(DesktopSplashConfig config) async {
   try {
-    return await loadImageAsBGRA(
+    final image = await loadImageAsBGRA(
       config.imagePath,
-      blurRadius: config.imageBlurRadius,
       resizeToFit: config.imageScaling,
       imageBorderRadius: config.imageBorderRadius,
       targetWidth: config.imageWidth,
       targetHeight: config.imageHeight,
-      backgroundBorderRadius: config.backgroundBorderRadius,
-      backgroundColor: config.backgroundColor,
-      backgroundWidth: config.backgroundWidth,
-      backgroundHeight: config.backgroundHeight,
     );
+
+    // Only embed the visible part of the image
+    return trimTransparentBorders(image);
   } catch (e) {
     logger.e('Failed to load or process the image: $e');
     return null;
   }
 }
 
-/// Generates the C++ source file with image data and configuration
+/// Generates the C++ source file with image data and configuration, and the
+/// header of its constexpr settings unless [configHeader] is false
 ///
 /// Returns [true] if file generation was successful, [false] otherwise
 Future<bool> _generateSourceFile({
@@ -75,6 +446,15 @@ Future<bool> _generateSourceFile({
   required String flavor,
   required DesktopSplashConfig config,
   required BGRAImage imageData,
+  IndexedImage? indexed,
+  VectorImage? vector,
+  TileSet? tiles,
+  Uint32List? tileMap,
+  Map<int, BGRAImage> variants = const {},
+  Map<int, BGRAImage> darkVariants = const {},
+  List<AnimationFrame> animation = const [],
+  required int hash,
+  bool configHeader = true,
 }) async {
   final target = 'native_splash_screen_$flavor.cc';
 
@@ -84,21 +464,102 @@ Future<bool> _generateSourceFile({
   final outputFile = File(outputFilePath);
 
   try {
-    final buffer = StringBuffer();
+    // File header, kept out of the asset hash below
+    final header = StringBuffer();
+    header.writeln('// Generated file - do not edit');
+    header.writeln('// Generated by native_splash_screen_cli');
+    header.writeln(generationHashLine(hash));
+    if (tiles != null && tileMap != null) {
+      header.writeln('// Tiles shared through $linuxTilesFile');
+    }
+    header.writeln('');
 
-    // File header
-    buffer.writeln('// Generated file - do not edit');
-    buffer.writeln('// Generated by native_splash_screen_cli');
-    buffer.writeln('');
+    final buffer = StringBuffer();
 
     // Splash screen configuration
     _writeConfigSection(buffer, config, imageData);
 
+    // Background rectangle parameters
+    _writeBackgroundSection(buffer, config);
+
+    // Loading spinner drawn by the plugin
+    _writeSpinnerSection(buffer, config, imageData);
+
+    // Blur and drop shadow drawn by the plugin
+    _writeImageEffectsSection(buffer, config);
+
+    // Whether the window can skip alpha blending
+    _writeOpaqueSection(buffer, config, imageData, darkImage: darkVariants[1]);
+
+    // Shape of the window when its transparency can not be shown
+    _writeShapeSection(
+      buffer,
+      config,
+      imageData,
+      darkImage: darkVariants[1],
+      animation: animation,
+    );
+
     // Image data
-    _writeImageDataSection(buffer, imageData);
+    if (config.imageStorage == ImageStorage.file) {
+      _writeImageAssetSection(buffer);
+    } else if (vector != null) {
+      _writeVectorDataSection(buffer, vector);
+    } else if (tiles != null && tileMap != null) {
+      _writeTiledImageDataSection(buffer, tiles, tileMap);
+    } else {
+      _writeImageDataSection(buffer, imageData, indexed);
+    }
+
+    // HiDPI variants of the embedded image
+    if (variants.isNotEmpty) {
+      _writeImageVariantsSection(
+        buffer,
+        variants,
+        config.imageQuantizeTolerance,
+      );
+    }
+
+    // Image of dark desktops, at every scale
+    if (darkVariants.isNotEmpty) {
+      _writeImageVariantsSection(
+        buffer,
+        darkVariants,
+        config.imageQuantizeTolerance,
+        symbol: 'image_dark',
+        description: 'dark image',
+      );
+    }
+
+    // Animation played over the splash
+    if (animation.isNotEmpty) {
+      _writeAnimationSection(buffer, animation, config.animationLoop);
+    }
+
+    // Everything the composed splash depends on, including the shared tiles
+    int assetHash = fnv1a64(utf8.encode(buffer.toString()));
+    if (tiles != null && tileMap != null) {
+      assetHash = fnv1a64(tiles.tiles, assetHash);
+      assetHash = fnv1a64(tiles.colors.buffer.asUint8List(), assetHash);
+    }
+    _writeAssetHashSection(buffer, assetHash);
 
     // Write to file
-    await outputFile.writeAsString(buffer.toString());
+    await writeIfChanged(outputFile, utf8.encode('$header$buffer'));
+
+    // Compile-time copy of the settings for the plugin, which can not be
+    // switched to another flavor at runtime
+    final headerFile = File(
+      path.join(outputDir, 'native_splash_screen_$flavor.h'),
+    );
+    if (configHeader) {
+      await writeIfChanged(
+        headerFile,
+        utf8.encode(_configHeader(flavor, buffer.toString(), hash)),
+      );
+    } else if (headerFile.existsSync()) {
+      await headerFile.delete();
+    }
     // logger.success('Generated $target in $outputDir');
     return true;
   } catch (e) {
@@ -107,6 +568,44 @@ Future<bool> _generateSourceFile({
   }
 }
 
+/// Scalar definitions of a generated source, e.g.
+/// `int native_splash_screen_width = 400;`
+final RegExp _scalarDefinition = RegExp(
+  r'^(int|bool|double|unsigned int|unsigned long long|const char\*) '
+  r'native_splash_screen_(\w+) = (.+);$',
+  multiLine: true,
+);
+
+/// Returns the header of constexpr settings matching the [source] of
+/// [flavor]
+///
+/// The plugin includes it in place of reading the generated globals when the
+/// build passes it as NATIVE_SPLASH_SCREEN_CONFIG_HEADER, so the settings
+/// become compile-time constants. Every scalar defined by the source is
+/// copied, the others keep the defaults of the plugin.
+String _configHeader(String flavor, String source, int hash) {
+  final guard = 'NATIVE_SPLASH_SCREEN_${flavor.toUpperCase()}_H_';
+  final buffer = StringBuffer();
+  buffer.writeln('// Generated file - do not edit');
+  buffer.writeln('// Generated by native_splash_screen_cli');
+  buffer.writeln(generationHashLine(hash));
+  buffer.writeln('');
+  buffer.writeln('#ifndef $guard');
+  buffer.writeln('#define $guard');
+  buffer.writeln('');
+  buffer.writeln('// Settings of native_splash_screen_$flavor.cc');
+  buffer.writeln('struct NativeSplashScreenConfig : SplashConfigDefaults {');
+  for (final match in _scalarDefinition.allMatches(source)) {
+    buffer.writeln(
+      '  static constexpr ${match[1]} ${match[2]}() { return ${match[3]}; }',
+    );
+  }
+  buffer.writeln('};');
+  buffer.writeln('');
+  buffer.writeln('#endif  // $guard');
+  return buffer.toString();
+}
+
 /// Writes the configuration section of the C++ file
 void _writeConfigSection(
   StringBuffer buffer,
@@ -145,42 +644,1020 @@ void _writeConfigSection(
     'int native_splash_screen_image_height = ${imageData.height};',
   );
   buffer.writeln('');
+
+  buffer.writeln('// Image placement inside its untrimmed canvas');
+  buffer.writeln(
+    'int native_splash_screen_image_offset_x = ${imageData.offsetX};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_offset_y = ${imageData.offsetY};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_canvas_width = ${imageData.canvasWidth};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_canvas_height = ${imageData.canvasHeight};',
+  );
+  buffer.writeln('');
 }
 
-/// Writes the image data section of the C++ file
-void _writeImageDataSection(StringBuffer buffer, BGRAImage imageData) {
-  final length = imageData.data.length;
+/// Writes the background rectangle section of the C++ file
+void _writeBackgroundSection(StringBuffer buffer, DesktopSplashConfig config) {
+  buffer.writeln('// Background rectangle (ARGB format), drawn at runtime');
+  buffer.writeln(
+    'unsigned int native_splash_screen_background_rect_color = 0x${colorHex(config.backgroundColor)};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_background_rect_width = ${config.backgroundWidth};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_background_rect_height = ${config.backgroundHeight};',
+  );
+  buffer.writeln(
+    'double native_splash_screen_background_rect_radius = ${config.backgroundBorderRadius};',
+  );
+  buffer.writeln('');
 
-  buffer.writeln('// Raw image data in (ARGB) format');
+  buffer.writeln('// Background gradient (0: none, 1: linear, 2: radial)');
   buffer.writeln(
-    'const unsigned char native_splash_screen_image_data[$length] = {',
+    'int native_splash_screen_background_gradient = ${config.backgroundGradient.index};',
+  );
+  buffer.writeln(
+    'unsigned int native_splash_screen_background_gradient_color = 0x${colorHex(config.backgroundGradientColor)};',
+  );
+  buffer.writeln(
+    'double native_splash_screen_background_gradient_angle = ${config.backgroundGradientAngle};',
   );
+  buffer.writeln('');
+}
 
-  // Write data in a formatted way (16 values per line)
-  const int valuesPerLine = 16;
-  for (int i = 0; i < length; i++) {
-    if (i % valuesPerLine == 0) {
-      buffer.write('  ');
+/// Writes the loading spinner section of the C++ file
+///
+/// The plugin draws the spinner itself, into an atlas of pre-rotated frames
+/// built once when the splash is shown, so no pixel is embedded.
+void _writeSpinnerSection(
+  StringBuffer buffer,
+  DesktopSplashConfig config,
+  BGRAImage imageData,
+) {
+  buffer.writeln('// Loading spinner (ARGB format), 0 size for none');
+  buffer.writeln(
+    'int native_splash_screen_spinner_size = ${config.spinnerSize};',
+  );
+  buffer.writeln(
+    'unsigned int native_splash_screen_spinner_color = 0x${colorHex(config.spinnerColor)};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_spinner_offset_y = ${_spinnerOffsetY(config, imageData)};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_spinner_period = ${config.spinnerPeriod};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_spinner_frames = ${config.spinnerFrames};',
+  );
+  buffer.writeln('');
+}
+
+/// Writes the blur and drop shadow section of the C++ file
+///
+/// The plugin blurs the image and draws its shadow from its alpha channel
+/// once, when the splash is composed, so the embedded pixels stay those of
+/// the sharp image. The radii are in logical pixels.
+void _writeImageEffectsSection(
+  StringBuffer buffer,
+  DesktopSplashConfig config,
+) {
+  buffer.writeln('// Image blur and drop shadow (ARGB format), 0 for none');
+  buffer.writeln(
+    'double native_splash_screen_image_blur_radius = ${config.imageBlurRadius};',
+  );
+  buffer.writeln(
+    'unsigned int native_splash_screen_image_shadow_color = 0x${colorHex(config.imageShadowColor)};',
+  );
+  buffer.writeln(
+    'double native_splash_screen_image_shadow_radius = ${config.imageShadowRadius};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_shadow_offset_x = ${config.imageShadowOffsetX};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_shadow_offset_y = ${config.imageShadowOffsetY};',
+  );
+  buffer.writeln('');
+}
+
+/// Returns how far below the center of the background rectangle the center
+/// of the spinner is: the configured offset, or by default under the image
+/// canvas with some spacing, kept inside the background rectangle
+int _spinnerOffsetY(DesktopSplashConfig config, BGRAImage imageData) {
+  const spacing = 16;
+  final size = config.spinnerSize;
+  return config.spinnerOffsetY ??
+      min(
+        imageData.canvasHeight ~/ 2 + spacing + size ~/ 2,
+        (config.backgroundHeight - size) ~/ 2,
+      );
+}
+
+/// Writes whether the composed splash is fully opaque
+///
+/// The window is transparent when composited, so it is only opaque when the
+/// background rectangle or the image cover all of it without any
+/// transparent pixel. The plugin then keeps the system visual, which spares
+/// the compositor blending the window on every frame.
+///
+/// With a [darkImage], both images must cover the window.
+void _writeOpaqueSection(
+  StringBuffer buffer,
+  DesktopSplashConfig config,
+  BGRAImage imageData, {
+  BGRAImage? darkImage,
+}) {
+  bool isOpaque(Color color) => color.a == color.maxChannelValue;
+
+  final backgroundCovers = config.backgroundWidth == config.windowWidth &&
+      config.backgroundHeight == config.windowHeight &&
+      config.backgroundBorderRadius <= 0 &&
+      isOpaque(config.backgroundColor) &&
+      (config.backgroundGradient == BackgroundGradient.none ||
+          isOpaque(config.backgroundGradientColor));
+
+  bool covers(BGRAImage image) {
+    final (imageX, imageY) = _imagePosition(config, image);
+    return imageX <= 0 &&
+        imageY <= 0 &&
+        imageX + image.width >= config.windowWidth &&
+        imageY + image.height >= config.windowHeight &&
+        config.imageBlurRadius <= 0 &&
+        _isImageOpaque(image);
+  }
+
+  final imageCovers =
+      covers(imageData) && (darkImage == null || covers(darkImage));
+
+  buffer.writeln('// Whether the splash covers the window with opaque pixels');
+  buffer.writeln(
+    'bool native_splash_screen_opaque = ${backgroundCovers || imageCovers};',
+  );
+  buffer.writeln('');
+}
+
+/// Returns the position of [imageData] in the window, like the plugin places
+/// it: the canvas is centered in the background rectangle, which is itself
+/// centered in the window
+(int, int) _imagePosition(DesktopSplashConfig config, BGRAImage imageData) {
+  final anchorX = (config.windowWidth - config.backgroundWidth) ~/ 2;
+  final anchorY = (config.windowHeight - config.backgroundHeight) ~/ 2;
+  return (
+    anchorX +
+        (config.backgroundWidth - imageData.canvasWidth) ~/ 2 +
+        imageData.offsetX,
+    anchorY +
+        (config.backgroundHeight - imageData.canvasHeight) ~/ 2 +
+        imageData.offsetY,
+  );
+}
+
+/// Returns the position of the animation of [frame] size in the window,
+/// centered in the background rectangle like the plugin places it
+(int, int) _animationPosition(DesktopSplashConfig config, BGRAImage frame) {
+  final anchorX = (config.windowWidth - config.backgroundWidth) ~/ 2;
+  final anchorY = (config.windowHeight - config.backgroundHeight) ~/ 2;
+  return (
+    anchorX + (config.backgroundWidth - frame.width) ~/ 2,
+    anchorY + (config.backgroundHeight - frame.height) ~/ 2,
+  );
+}
+
+/// Writes the shape of the window on screens without a compositor
+///
+/// Such screens can not show the transparent parts of the window, which
+/// would be filled with the window color instead. The shape covers the
+/// pixels of the background rectangle, rounded corners included, and the
+/// pixels of the image that are at least half opaque. It is written as the
+/// runs of every row, with identical consecutive rows merged into taller
+/// rectangles. Nothing is written when the shape is the whole window.
+///
+/// The shape only depends on the 1x image, the window geometry is logical.
+/// With a [darkImage], it covers the pixels of both images, and with an
+/// [animation], the pixels of any of its frames. The spinner covers its
+/// whole square. A blurred image stays at least half opaque about where it
+/// was sharp, and so does a drop shadow where the offset image would be.
+void _writeShapeSection(
+  StringBuffer buffer,
+  DesktopSplashConfig config,
+  BGRAImage imageData, {
+  BGRAImage? darkImage,
+  List<AnimationFrame> animation = const [],
+}) {
+  final width = config.windowWidth;
+  final height = config.windowHeight;
+  final mask = Uint8List(width * height);
+
+  // Background rectangle, skipped when it is fully transparent
+  final hasBackground = config.backgroundColor.a != 0 ||
+      (config.backgroundGradient != BackgroundGradient.none &&
+          config.backgroundGradientColor.a != 0);
+  if (hasBackground) {
+    final left = (width - config.backgroundWidth) ~/ 2;
+    final top = (height - config.backgroundHeight) ~/ 2;
+    final radius = min(
+      config.backgroundBorderRadius,
+      min(config.backgroundWidth, config.backgroundHeight) / 2,
+    );
+
+    for (int y = 0; y < config.backgroundHeight; y++) {
+      // Distance of the row center into the corner arcs
+      final center = y + 0.5;
+      final bottom = config.backgroundHeight - radius;
+      final dy = max(0.0, max(radius - center, center - bottom));
+      final inset = radius > 0 && dy > 0
+          ? (radius - sqrt(max(0.0, radius * radius - dy * dy))).round()
+          : 0;
+      final row = (top + y) * width;
+      for (int x = inset; x < config.backgroundWidth - inset; x++) {
+        mask[row + left + x] = 1;
+      }
     }
+  }
 
-    final hex =
-        imageData.data[i].toRadixString(16).padLeft(2, '0').toUpperCase();
-    buffer.write('0x$hex');
+  // Image, shadow and animation pixels, clipped to the window
+  final hasShadow = config.imageShadowColor.a >= 0x80;
+  final images = <(BGRAImage, (int, int))>[];
+  for (final image in [imageData, if (darkImage != null) darkImage]) {
+    final (imageX, imageY) = _imagePosition(config, image);
+    images.add((image, (imageX, imageY)));
+    if (hasShadow) {
+      final shadowX = imageX + config.imageShadowOffsetX;
+      final shadowY = imageY + config.imageShadowOffsetY;
+      images.add((image, (shadowX, shadowY)));
+    }
+  }
+  for (final frame in animation) {
+    images.add((frame.image, _animationPosition(config, frame.image)));
+  }
+  for (final (image, (imageX, imageY)) in images) {
+    final data = image.data;
+    for (int y = max(0, -imageY); y < image.height; y++) {
+      if (imageY + y >= height) {
+        break;
+      }
+      for (int x = max(0, -imageX); x < image.width; x++) {
+        if (imageX + x >= width) {
+          break;
+        }
+        if (data[(y * image.width + x) * 4 + 3] >= 0x80) {
+          mask[(imageY + y) * width + imageX + x] = 1;
+        }
+      }
+    }
+  }
 
-    if (i != length - 1) {
-      buffer.write(', ');
-      if ((i + 1) % valuesPerLine == 0) {
-        buffer.writeln();
+  // Spinner, as a whole since it turns
+  if (config.spinnerSize > 0) {
+    final size = config.spinnerSize;
+    final left = (width - config.backgroundWidth) ~/ 2 +
+        (config.backgroundWidth - size) ~/ 2;
+    final top = (height - config.backgroundHeight) ~/ 2 +
+        (config.backgroundHeight - size) ~/ 2 +
+        _spinnerOffsetY(config, imageData);
+    for (int y = max(0, top); y < min(height, top + size); y++) {
+      for (int x = max(0, left); x < min(width, left + size); x++) {
+        mask[y * width + x] = 1;
       }
     }
   }
 
-  buffer.writeln('');
-  buffer.writeln('};');
+  // Runs of every row as (x, width) pairs, merged down while they repeat
+  List<int> runsOf(int y) {
+    final runs = <int>[];
+    int x = 0;
+    while (x < width) {
+      if (mask[y * width + x] == 0) {
+        x++;
+        continue;
+      }
+      final start = x;
+      while (x < width && mask[y * width + x] != 0) {
+        x++;
+      }
+      runs.addAll([start, x - start]);
+    }
+    return runs;
+  }
 
-  buffer.writeln('');
-  buffer.writeln('// Pointer to image data');
+  final rects = <int>[];
+  int y = 0;
+  while (y < height) {
+    final runs = runsOf(y);
+    int rows = 1;
+    while (y + rows < height && _sameRuns(runsOf(y + rows), runs)) {
+      rows++;
+    }
+    for (int i = 0; i < runs.length; i += 2) {
+      rects.addAll([runs[i], y, runs[i + 1], rows]);
+    }
+    y += rows;
+  }
+
+  // Nothing to shape when the whole window, or nothing, is covered
+  final fullWindow =
+      rects.length == 4 && rects[2] == width && rects[3] == height;
+  if (rects.isEmpty || fullWindow) {
+    return;
+  }
+
+  final count = rects.length ~/ 4;
+  buffer.writeln(
+    '// Window shape without a compositor, as (x, y, width, height) rectangles',
+  );
+  buffer.writeln('int native_splash_screen_shape_rect_count = $count;');
+  buffer.writeln(
+    'const int native_splash_screen_shape_rects_data[${rects.length}] = {',
+  );
+  for (int i = 0; i < rects.length; i += 4) {
+    buffer.writeln('  ${rects.sublist(i, i + 4).join(', ')},');
+  }
+  buffer.writeln('};');
+  buffer.writeln(
+    'const int* native_splash_screen_shape_rects = native_splash_screen_shape_rects_data;',
+  );
+  buffer.writeln('');
+}
+
+bool _sameRuns(List<int> a, List<int> b) {
+  if (a.length != b.length) {
+    return false;
+  }
+  for (int i = 0; i < a.length; i++) {
+    if (a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Returns true if every pixel of [image] has a full alpha
+bool _isImageOpaque(BGRAImage image) {
+  final data = image.data;
+  for (int i = 3; i < data.length; i += 4) {
+    if (data[i] != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Writes the image data section of the C++ file
+///
+/// Images with at most 256 colors are written as one palette index per
+/// pixel, which the plugin expands back to ARGB when the splash is shown.
+void _writeImageDataSection(
+  StringBuffer buffer,
+  BGRAImage imageData,
+  IndexedImage? indexed,
+) {
+  buffer.writeln(
+    '// Pixel format (0: ARGB, 1: 8-bit palette indices, 2: tiles)',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_format = ${indexed != null ? 1 : 0};',
+  );
+  buffer.writeln('');
+
+  if (indexed != null) {
+    final size = indexed.palette.length;
+    buffer.writeln('// Image palette in (ARGB) format');
+    buffer.writeln(
+      'const unsigned int native_splash_screen_image_palette_data[$size] = {',
+    );
+    _writeWords(buffer, indexed.palette);
+    buffer.writeln('};');
+    buffer.writeln(
+      'const unsigned int* native_splash_screen_image_palette = native_splash_screen_image_palette_data;',
+    );
+    buffer.writeln('int native_splash_screen_image_palette_size = $size;');
+    buffer.writeln('');
+  }
+
+  final data = indexed != null ? indexed.indices : imageData.data;
+  final length = data.length;
+
+  buffer.writeln(
+    indexed != null
+        ? '// Image data as palette indices'
+        : '// Raw image data in (ARGB) format',
+  );
+  buffer.writeln(_pixelDataAttribute);
+  buffer.writeln(
+    'const unsigned char native_splash_screen_image_data[$length] = {',
+  );
+  _writeBytes(buffer, data);
+  buffer.writeln('};');
+
+  buffer.writeln('');
+  buffer.writeln('// Pointer to image data');
+  buffer.writeln(
+    'const unsigned char* native_splash_screen_image_pixels = native_splash_screen_image_data;',
+  );
+}
+
+/// Writes the image data section of a vector image, as its display list
+void _writeVectorDataSection(StringBuffer buffer, VectorImage vector) {
+  buffer.writeln(
+    '// Pixel format (0: ARGB, 1: 8-bit palette indices, 2: tiles, 3: vector)',
+  );
+  buffer.writeln('int native_splash_screen_image_format = 3;');
+  buffer.writeln('');
+
+  final length = vector.data.length;
+  buffer.writeln('// Display list of the vector image, drawn at runtime');
+  buffer.writeln(_pixelDataAttribute);
+  buffer.writeln(
+    'const unsigned char native_splash_screen_image_data[$length] = {',
+  );
+  _writeBytes(buffer, vector.data);
+  buffer.writeln('};');
+  buffer.writeln(
+    'unsigned int native_splash_screen_image_vector_size = $length;',
+  );
+
+  buffer.writeln('');
+  buffer.writeln('// Pointer to image data');
   buffer.writeln(
     'const unsigned char* native_splash_screen_image_pixels = native_splash_screen_image_data;',
   );
 }
+
+/// Writes the HiDPI variants of the image as compressed `.nss` blobs
+///
+/// Unlike the 1x image they are not in the prefetched data section: only the
+/// variant matching the display is inflated, the others are never touched.
+///
+/// The globals are named after [symbol], e.g. `image_dark` for the
+/// `native_splash_screen_image_dark_variant_*` ones, and the blobs after the
+/// [description] of the image.
+void _writeImageVariantsSection(
+  StringBuffer buffer,
+  Map<int, BGRAImage> variants,
+  int tolerance, {
+  String symbol = 'image',
+  String description = 'image',
+}) {
+  final scales = variants.keys.toList()..sort();
+  final sizes = <int>[];
+  final prefix = 'native_splash_screen_$symbol';
+
+  for (final scale in scales) {
+    final image = variants[scale]!;
+    final asset = encodeSplashAsset(
+      image,
+      encodeIndexed(image, tolerance: tolerance),
+      compress: true,
+      alignment: 16,
+    );
+    sizes.add(asset.length);
+
+    buffer.writeln('');
+    buffer.writeln('// ${scale}x $description as a compressed splash asset');
+    buffer.writeln('__attribute__((aligned(16)))');
+    buffer.writeln(
+      'static const unsigned char ${prefix}_${scale}x[${asset.length}] = {',
+    );
+    _writeBytes(buffer, asset);
+    buffer.writeln('};');
+  }
+
+  final count = scales.length;
+  buffer.writeln('');
+  buffer.writeln('// Scale variants of the $description');
+  buffer.writeln('int ${prefix}_variant_count = $count;');
+  buffer.writeln(
+    'static const int ${prefix}_variant_scales_data[$count] = {${scales.join(', ')}};',
+  );
+  buffer.writeln(
+    'static const unsigned char* const ${prefix}_variants_data[$count] = {${scales.map((s) => '${prefix}_${s}x').join(', ')}};',
+  );
+  buffer.writeln(
+    'static const unsigned int ${prefix}_variant_sizes_data[$count] = {${sizes.join(', ')}};',
+  );
+  buffer.writeln(
+    'const int* ${prefix}_variant_scales = ${prefix}_variant_scales_data;',
+  );
+  buffer.writeln(
+    'const unsigned char* const* ${prefix}_variants = ${prefix}_variants_data;',
+  );
+  buffer.writeln(
+    'const unsigned int* ${prefix}_variant_sizes = ${prefix}_variant_sizes_data;',
+  );
+}
+
+/// Writes the [frames] of the animation as the blob of
+/// [encodeSplashAnimation], played once unless it [loop]s
+///
+/// Like the variants it is not in the prefetched data section, the plugin
+/// only reads the frames one after the other as they are shown.
+void _writeAnimationSection(
+  StringBuffer buffer,
+  List<AnimationFrame> frames,
+  bool loop,
+) {
+  final animation = encodeSplashAnimation(frames, loopCount: loop ? 0 : 1);
+
+  buffer.writeln('');
+  buffer.writeln(
+    '// ${frames.length} animation frames, as keyframes and dirty rectangles',
+  );
+  buffer.writeln('__attribute__((aligned(16)))');
+  buffer.writeln(
+    'static const unsigned char native_splash_screen_animation_data[${animation.length}] = {',
+  );
+  _writeBytes(buffer, animation);
+  buffer.writeln('};');
+  buffer.writeln(
+    'const unsigned char* native_splash_screen_animation = native_splash_screen_animation_data;',
+  );
+  buffer.writeln(
+    'unsigned int native_splash_screen_animation_size = ${animation.length};',
+  );
+}
+
+/// Writes the hash keying the persistent cache of the composed splash
+void _writeAssetHashSection(StringBuffer buffer, int hash) {
+  buffer.writeln('');
+  buffer.writeln('// Hash of the splash assets, invalidates the runtime cache');
+  buffer.writeln(
+    'unsigned long long native_splash_screen_asset_hash = 0x${hex64(hash)}ULL;',
+  );
+}
+
+/// Writes the image data section of a flavor stored in an asset file
+///
+/// The plugin maps `data/splash.nss` from the bundle when the splash is
+/// shown, so the image can be replaced without rebuilding the runner. The
+/// pixel format and placement are read from the asset header.
+void _writeImageAssetSection(StringBuffer buffer) {
+  buffer.writeln('// Image asset, relative to the bundle data directory');
+  buffer.writeln(
+    'const char* native_splash_screen_image_asset = "$linuxAssetFile";',
+  );
+  buffer.writeln(
+    'const unsigned char* native_splash_screen_image_pixels = nullptr;',
+  );
+}
+
+/// Generates the `.nss` asset of [flavor] from [imageData], and the
+/// `@<scale>x.nss` assets of its HiDPI [variants]
+///
+/// When the flavor embeds its image, previously generated assets are removed
+/// instead so they no longer get installed.
+///
+/// Returns [true] if file generation was successful, [false] otherwise
+Future<bool> _generateAssetFile({
+  required String outputDir,
+  required String flavor,
+  required BGRAImage? imageData,
+  IndexedImage? indexed,
+  Map<int, BGRAImage> variants = const {},
+  int tolerance = 0,
+}) async {
+  final target = 'native_splash_screen_$flavor.nss';
+  final outputFile = File(path.join(outputDir, target));
+
+  try {
+    // Remove the variants of scales that are no longer generated
+    final variantName = RegExp(
+      '^native_splash_screen_${RegExp.escape(flavor)}@(\\d+)x\\.nss\$',
+    );
+    await for (final entity in Directory(outputDir).list()) {
+      final match = variantName.firstMatch(path.basename(entity.path));
+      if (match != null &&
+          !(imageData != null &&
+              variants.containsKey(int.parse(match.group(1)!)))) {
+        await entity.delete();
+      }
+    }
+
+    if (imageData == null) {
+      if (outputFile.existsSync()) {
+        await outputFile.delete();
+      }
+      return true;
+    }
+
+    await writeIfChanged(outputFile, encodeSplashAsset(imageData, indexed));
+    for (final MapEntry(key: scale, value: image) in variants.entries) {
+      await writeIfChanged(
+        File(
+          path.join(outputDir, 'native_splash_screen_$flavor@${scale}x.nss'),
+        ),
+        encodeSplashAsset(image, encodeIndexed(image, tolerance: tolerance)),
+      );
+    }
+    return true;
+  } catch (e) {
+    logger.e('Failed to generate $target file: $e');
+    return false;
+  }
+}
+
+/// Writes the image data section of a flavor embedded as tiles
+///
+/// Only the tile map is specific to the flavor, the tiles and the colors of
+/// the solid tiles are defined once in [linuxTilesFile].
+void _writeTiledImageDataSection(
+  StringBuffer buffer,
+  TileSet tiles,
+  Uint32List tileMap,
+) {
+  buffer.writeln(
+    '// Pixel format (0: ARGB, 1: 8-bit palette indices, 2: tiles)',
+  );
+  buffer.writeln('int native_splash_screen_image_format = 2;');
+  buffer.writeln('');
+
+  buffer.writeln('// Tiles and solid tile colors shared by every flavor');
+  buffer.writeln('extern const unsigned char native_splash_screen_tiles_data[];');
+  buffer.writeln('extern const unsigned int native_splash_screen_tiles_colors[];');
+  buffer.writeln(
+    'const unsigned char* native_splash_screen_image_pixels = native_splash_screen_tiles_data;',
+  );
+  buffer.writeln(
+    'const unsigned int* native_splash_screen_image_palette = native_splash_screen_tiles_colors;',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_palette_size = ${tiles.colors.length};',
+  );
+  buffer.writeln('');
+
+  final size = tiles.tileSize;
+  buffer.writeln('// Tile map of ${size}x$size tiles, row by row');
+  buffer.writeln('int native_splash_screen_image_tile_size = $size;');
+  buffer.writeln(
+    'const unsigned int native_splash_screen_image_tile_map_data[${tileMap.length}] = {',
+  );
+  _writeWords(buffer, tileMap);
+  buffer.writeln('};');
+  buffer.writeln(
+    'const unsigned int* native_splash_screen_image_tile_map = native_splash_screen_image_tile_map_data;',
+  );
+}
+
+/// Generates [linuxTilesFile] with the tiles shared by every flavor
+///
+/// When the flavors are not embedded as tiles, a previously generated file
+/// is removed instead.
+///
+/// Returns [true] if file generation was successful, [false] otherwise
+Future<bool> _generateTilesFile({
+  required String outputDir,
+  required TileSet? tiles,
+  required int hash,
+}) async {
+  final outputFile = File(path.join(outputDir, linuxTilesFile));
+
+  try {
+    if (tiles == null) {
+      if (outputFile.existsSync()) {
+        await outputFile.delete();
+      }
+      return true;
+    }
+
+    final buffer = StringBuffer();
+
+    // File header
+    buffer.writeln('// Generated file - do not edit');
+    buffer.writeln('// Generated by native_splash_screen_cli');
+    buffer.writeln(generationHashLine(hash));
+    buffer.writeln('');
+
+    buffer.writeln(
+      '// ${tiles.tileCount} unique tiles in (ARGB) format, shared by every flavor',
+    );
+    buffer.writeln(_pixelDataAttribute);
+    buffer.writeln(
+      'extern const unsigned char native_splash_screen_tiles_data[${tiles.tiles.length}] = {',
+    );
+    _writeBytes(buffer, tiles.tiles);
+    buffer.writeln('};');
+    buffer.writeln('');
+
+    // C++ does not allow empty arrays
+    final colors = tiles.colors.isNotEmpty ? tiles.colors : [0];
+    buffer.writeln('// Colors of the solid tiles (ARGB format)');
+    buffer.writeln(
+      'extern const unsigned int native_splash_screen_tiles_colors[${colors.length}] = {',
+    );
+    _writeWords(buffer, colors);
+    buffer.writeln('};');
+
+    await writeIfChanged(outputFile, utf8.encode(buffer.toString()));
+    return true;
+  } catch (e) {
+    logger.e('Failed to generate $linuxTilesFile file: $e');
+    return false;
+  }
+}
+
+/// Fields of NativeSplashScreenFlavor after its name, in the order of
+/// `native_splash_screen_flavor.h`, each copied from the generated global of
+/// the same name
+const List<(String, String)> _flavorFields = [
+  ('int', 'width'),
+  ('int', 'height'),
+  ('const char*', 'title'),
+  ('bool', 'with_animation'),
+  ('unsigned int', 'background_color'),
+  ('unsigned int', 'background_rect_color'),
+  ('int', 'background_rect_width'),
+  ('int', 'background_rect_height'),
+  ('double', 'background_rect_radius'),
+  ('int', 'background_gradient'),
+  ('unsigned int', 'background_gradient_color'),
+  ('double', 'background_gradient_angle'),
+  ('int', 'spinner_size'),
+  ('unsigned int', 'spinner_color'),
+  ('int', 'spinner_offset_y'),
+  ('int', 'spinner_period'),
+  ('int', 'spinner_frames'),
+  ('double', 'image_blur_radius'),
+  ('unsigned int', 'image_shadow_color'),
+  ('double', 'image_shadow_radius'),
+  ('int', 'image_shadow_offset_x'),
+  ('int', 'image_shadow_offset_y'),
+  ('bool', 'opaque'),
+  ('int', 'shape_rect_count'),
+  ('const int*', 'shape_rects'),
+  ('int', 'image_variant_count'),
+  ('const int*', 'image_variant_scales'),
+  ('const unsigned char* const*', 'image_variants'),
+  ('const unsigned int*', 'image_variant_sizes'),
+  ('int', 'image_dark_variant_count'),
+  ('const int*', 'image_dark_variant_scales'),
+  ('const unsigned char* const*', 'image_dark_variants'),
+  ('const unsigned int*', 'image_dark_variant_sizes'),
+  ('const unsigned char*', 'animation'),
+  ('unsigned int', 'animation_size'),
+  ('unsigned long long', 'asset_hash'),
+];
+
+/// Writes the checks that [_flavorFields] matches the NativeSplashScreenFlavor
+/// of the plugin, so sources generated for another version of the plugin fail
+/// to compile instead of filling its index with misplaced settings
+void _writeFlavorLayoutChecks(StringBuffer buffer) {
+  buffer.writeln('');
+  buffer.writeln('// Layout the index below is written for');
+  String previous = 'name';
+  for (final (type, field) in _flavorFields) {
+    buffer.writeln(
+      'static_assert(std::is_same<decltype(NativeSplashScreenFlavor::$field), '
+      '$type>::value &&',
+    );
+    buffer.writeln(
+      '              offsetof(NativeSplashScreenFlavor, $field) > '
+      'offsetof(NativeSplashScreenFlavor, $previous),',
+    );
+    buffer.writeln(
+      '              "NativeSplashScreenFlavor::$field does not match '
+      'native_splash_screen_cli");',
+    );
+    previous = field;
+  }
+  final (lastType, _) = _flavorFields.last;
+  buffer.writeln(
+    'static_assert(sizeof(NativeSplashScreenFlavor) == '
+    'offsetof(NativeSplashScreenFlavor, $previous) + sizeof($lastType),',
+  );
+  buffer.writeln(
+    '              "NativeSplashScreenFlavor has fields unknown to '
+    'native_splash_screen_cli");',
+  );
+}
+
+/// Generates [linuxFlavorsFile] with the settings and images of the
+/// [flavors] selected at runtime, and their index
+///
+/// Every flavor is written by the same sections as the sources of the build
+/// configurations, in a namespace of its own, except for its image: all its
+/// scales, 1x included, are compressed variants, only inflated for the
+/// selected flavor. When there is no such flavor, a previously generated file
+/// is removed instead.
+///
+/// Returns [true] if file generation was successful, [false] otherwise
+Future<bool> _generateFlavorsFile({
+  required String outputDir,
+  required Map<String, DesktopSplashConfig> flavors,
+  required int hash,
+}) async {
+  final outputFile = File(path.join(outputDir, linuxFlavorsFile));
+
+  try {
+    if (flavors.isEmpty) {
+      if (outputFile.existsSync()) {
+        await outputFile.delete();
+      }
+      return true;
+    }
+
+    final loading = Future.wait(flavors.values.map(_loadImageVariants));
+    final darkLoading = Future.wait(
+      flavors.values.map(_loadDarkImageVariants),
+    );
+    final animationLoading = Future.wait(flavors.values.map(_loadAnimation));
+    final loaded = await loading;
+    final dark = await darkLoading;
+    final animations = await animationLoading;
+    if (loaded.contains(null) ||
+        dark.contains(null) ||
+        animations.contains(null)) {
+      return false;
+    }
+
+    final buffer = StringBuffer();
+
+    // File header
+    buffer.writeln('// Generated file - do not edit');
+    buffer.writeln('// Generated by native_splash_screen_cli');
+    buffer.writeln(generationHashLine(hash));
+    buffer.writeln('');
+
+    // Compiled into the plugin, which shares the layout of the index
+    buffer.writeln('#include <stddef.h>');
+    buffer.writeln('');
+    buffer.writeln('#include <type_traits>');
+    buffer.writeln('');
+    buffer.writeln(
+      '#include <native_splash_screen_linux/native_splash_screen_flavor.h>',
+    );
+    _writeFlavorLayoutChecks(buffer);
+
+    final names = flavors.keys.toList();
+    final configs = flavors.values.toList();
+    for (int i = 0; i < names.length; i++) {
+      final config = configs[i];
+      final variants = loaded[i]!;
+      final darkVariants = dark[i]!;
+      final animation = animations[i]!;
+      final imageData = variants[1]!;
+
+      final section = StringBuffer();
+      _writeConfigSection(section, config, imageData);
+      _writeBackgroundSection(section, config);
+      _writeSpinnerSection(section, config, imageData);
+      _writeImageEffectsSection(section, config);
+      _writeOpaqueSection(
+        section,
+        config,
+        imageData,
+        darkImage: darkVariants[1],
+      );
+      _writeShapeSection(
+        section,
+        config,
+        imageData,
+        darkImage: darkVariants[1],
+        animation: animation,
+      );
+      if (!section.toString().contains('native_splash_screen_shape_rects')) {
+        section.writeln('int native_splash_screen_shape_rect_count = 0;');
+        section.writeln('const int* native_splash_screen_shape_rects = nullptr;');
+      }
+      _writeImageVariantsSection(
+        section,
+        variants,
+        config.imageQuantizeTolerance,
+      );
+      if (darkVariants.isNotEmpty) {
+        _writeImageVariantsSection(
+          section,
+          darkVariants,
+          config.imageQuantizeTolerance,
+          symbol: 'image_dark',
+          description: 'dark image',
+        );
+      } else {
+        section.writeln('');
+        section.writeln('int native_splash_screen_image_dark_variant_count = 0;');
+        section.writeln(
+          'const int* native_splash_screen_image_dark_variant_scales = nullptr;',
+        );
+        section.writeln(
+          'const unsigned char* const* native_splash_screen_image_dark_variants = nullptr;',
+        );
+        section.writeln(
+          'const unsigned int* native_splash_screen_image_dark_variant_sizes = nullptr;',
+        );
+      }
+      if (animation.isNotEmpty) {
+        _writeAnimationSection(section, animation, config.animationLoop);
+      } else {
+        section.writeln('');
+        section.writeln(
+          'const unsigned char* native_splash_screen_animation = nullptr;',
+        );
+        section.writeln('unsigned int native_splash_screen_animation_size = 0;');
+      }
+      _writeAssetHashSection(
+        section,
+        fnv1a64(utf8.encode(section.toString())),
+      );
+
+      buffer.writeln('');
+      buffer.writeln('// Flavor "${escapeString(names[i])}"');
+      buffer.writeln('namespace native_splash_screen_flavor_$i {');
+      buffer.writeln('');
+      buffer.write(section);
+      buffer.writeln('');
+      buffer.writeln('}  // namespace native_splash_screen_flavor_$i');
+    }
+
+    final count = names.length;
+    buffer.writeln('');
+    buffer.writeln('// Index of the flavors, matched by name at runtime');
+    buffer.writeln(
+      'static const NativeSplashScreenFlavor native_splash_screen_flavors_data[$count] = {',
+    );
+    for (int i = 0; i < count; i++) {
+      buffer.writeln('  {"${escapeString(names[i])}",');
+      for (final (_, field) in _flavorFields) {
+        buffer.writeln(
+          '   native_splash_screen_flavor_$i::native_splash_screen_$field,',
+        );
+      }
+      buffer.writeln('  },');
+    }
+    buffer.writeln('};');
+    buffer.writeln('int native_splash_screen_flavor_count = $count;');
+    buffer.writeln(
+      'const NativeSplashScreenFlavor* native_splash_screen_flavors = native_splash_screen_flavors_data;',
+    );
+
+    await writeIfChanged(outputFile, utf8.encode(buffer.toString()));
+    return true;
+  } catch (e) {
+    logger.e('Failed to generate $linuxFlavorsFile file: $e');
+    return false;
+  }
+}
+
+/// Upper-case hex digits of every byte value, formatted once instead of once
+/// per written value
+final List<String> _hexBytes = List.generate(
+  256,
+  (i) => i.toRadixString(16).padLeft(2, '0').toUpperCase(),
+  growable: false,
+);
+
+/// Writes [data] as the body of a C array initializer, 16 values per line
+void _writeBytes(StringBuffer buffer, List<int> data) {
+  final length = data.length;
+
+  const int valuesPerLine = 16;
+  for (int i = 0; i < length; i++) {
+    if (i % valuesPerLine == 0) {
+      buffer.write('  ');
+    }
+
+    buffer.write('0x');
+    buffer.write(_hexBytes[data[i]]);
+
+    if (i != length - 1) {
+      buffer.write(', ');
+      if ((i + 1) % valuesPerLine == 0) {
+        buffer.writeln();
+      }
+    }
+  }
+
+  buffer.writeln('');
+}
+
+/// Writes [data] as 32-bit words of a C array initializer, 4 values per line
+void _writeWords(StringBuffer buffer, List<int> data) {
+  final length = data.length;
+
+  const int valuesPerLine = 4;
+  for (int i = 0; i < length; i++) {
+    if (i % valuesPerLine == 0) {
+      buffer.write('  ');
+    }
+
+    final word = data[i];
+    buffer.write('0x');
+    buffer.write(_hexBytes[(word >> 24) & 0xFF]);
+    buffer.write(_hexBytes[(word >> 16) & 0xFF]);
+    buffer.write(_hexBytes[(word >> 8) & 0xFF]);
+    buffer.write(_hexBytes[word & 0xFF]);
+
+    if (i != length - 1) {
+      buffer.write(', ');
+      if ((i + 1) % valuesPerLine == 0) {
+        buffer.writeln();
+      }
+    }
+  }
+
+  buffer.writeln('');
+}
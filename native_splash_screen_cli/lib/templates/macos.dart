@@ -39,15 +39,16 @@ Future<bool> generateMacosCode({
   final int logicalHeight =
       config.imageHeight > 0 ? config.imageHeight : config.windowHeight;
 
-  // 2. Generate the 1x asset using the logical dimensions.
-  final BGRAImage? processedImage1x =
-      await _loadAndProcessImage(config, logicalWidth, logicalHeight);
+  // 2. Generate the 1x asset using the logical dimensions, and
+  // 3. the 2x asset using doubled logical dimensions, concurrently.
+  final processed = await Future.wait([
+    _loadAndProcessImage(config, logicalWidth, logicalHeight),
+    _loadAndProcessImage(config, logicalWidth * 2, logicalHeight * 2,
+        scale: 2.0),
+  ]);
+  final BGRAImage? processedImage1x = processed[0];
   if (processedImage1x == null) return false;
-
-  // 3. Generate the 2x asset using doubled logical dimensions.
-  final BGRAImage? processedImage2x = await _loadAndProcessImage(
-      config, logicalWidth * 2, logicalHeight * 2,
-      scale: 2.0);
+  final BGRAImage? processedImage2x = processed[1];
   if (processedImage2x == null) return false;
 
   // Save the generated high-quality assets to the xcassets bundle.
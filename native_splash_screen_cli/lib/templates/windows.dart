@@ -1,3 +1,4 @@
+import 'dart:convert' show utf8;
 import 'dart:io';
 
 import 'package:path/path.dart' as path;
@@ -9,6 +10,7 @@ import '../common/utils.dart';
 
 import '../src/logger.dart';
 import '../src/image.dart';
+import '../src/incremental.dart';
 
 /// Generates Windows platform-specific code for the native splash screen
 ///
@@ -16,11 +18,16 @@ import '../src/image.dart';
 /// a [flavor] string to support multiple build flavors,
 /// and an output [outputDir] to override the default location.
 ///
+/// The source embeds the hash of its inputs. When it did not change the
+/// source is left untouched, unless [force] is set, so the build skips
+/// compiling it.
+///
 /// Returns [true] if generation was successful, [false] otherwise.
 Future<bool> generateWindowsCode({
   required DesktopSplashConfig config,
   required String flavor,
   required Directory outputDir,
+  bool force = false,
 }) async {
   // Validate image file exists
   final imageFile = File(config.imagePath);
@@ -29,6 +36,15 @@ Future<bool> generateWindowsCode({
     return false;
   }
 
+  final hash = await hashGenerationInputs([config]);
+  final source = File(
+    path.join(outputDir.path, 'native_splash_screen_$flavor.cpp'),
+  );
+  if (!force && hasGenerationHash(source, hash)) {
+    logger.i('Windows $flavor splash source is up to date.');
+    return true;
+  }
+
   // Load and process the image
   final BGRAImage? imageData = await _loadAndProcessImage(config);
   if (imageData == null) {
@@ -41,6 +57,7 @@ Future<bool> generateWindowsCode({
     flavor: flavor,
     config: config,
     imageData: imageData,
+    hash: hash,
   );
 }
 
@@ -49,7 +66,7 @@ Future<bool> generateWindowsCode({
 /// Returns the processed [BGRAImage] or null if processing failed
 Future<BGRAImage?> _loadAndProcessImage(DesktopSplashConfig config) async {
   try {
-    return await loadImageAsBGRA(
+    final image = await loadImageAsBGRA(
       config.imagePath,
       blurRadius: config.imageBlurRadius,
       resizeToFit: config.imageScaling,
@@ -61,6 +78,9 @@ Future<BGRAImage?> _loadAndProcessImage(DesktopSplashConfig config) async {
       backgroundWidth: config.backgroundWidth,
       backgroundHeight: config.backgroundHeight,
     );
+
+    // Only embed the visible part of the image
+    return trimTransparentBorders(image);
   } catch (e) {
     logger.e('Failed to load or process the image: $e');
     return null;
@@ -75,6 +95,7 @@ Future<bool> _generateSourceFile({
   required String flavor,
   required DesktopSplashConfig config,
   required BGRAImage imageData,
+  required int hash,
 }) async {
   final target = 'native_splash_screen_$flavor.cpp';
 
@@ -89,6 +110,7 @@ Future<bool> _generateSourceFile({
     // File header
     buffer.writeln('// Generated file - do not edit');
     buffer.writeln('// Generated by native_splash_screen_cli');
+    buffer.writeln(generationHashLine(hash));
     buffer.writeln('');
     buffer.writeln('#include <cstdint>');
     buffer.writeln('');
@@ -112,7 +134,7 @@ Future<bool> _generateSourceFile({
     buffer.writeln('#endif');
 
     // Write to file
-    await outputFile.writeAsString(buffer.toString());
+    await writeIfChanged(outputFile, utf8.encode(buffer.toString()));
     // logger.success('Generated $target in $outputDir');
     return true;
   } catch (e) {
@@ -155,6 +177,21 @@ void _writeConfigSection(
     'int native_splash_screen_image_height = ${imageData.height};',
   );
   buffer.writeln('');
+
+  buffer.writeln('// Image placement inside its untrimmed canvas');
+  buffer.writeln(
+    'int native_splash_screen_image_offset_x = ${imageData.offsetX};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_offset_y = ${imageData.offsetY};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_canvas_width = ${imageData.canvasWidth};',
+  );
+  buffer.writeln(
+    'int native_splash_screen_image_canvas_height = ${imageData.canvasHeight};',
+  );
+  buffer.writeln('');
 }
 
 /// Writes the image data section of the C++ file
@@ -0,0 +1,326 @@
+#include "image_ops.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+// One pixel as 4 float lanes, so the kernels below process the 4 channels
+// in a single SIMD operation.
+#if defined(__GNUC__)
+typedef float Pixel4 __attribute__((vector_size(16)));
+#else
+struct Pixel4 {
+  float v[4];
+
+  float operator[](int i) const { return v[i]; }
+  Pixel4& operator+=(const Pixel4& other) {
+    for (int i = 0; i < 4; i++) {
+      v[i] += other.v[i];
+    }
+    return *this;
+  }
+  friend Pixel4 operator*(const Pixel4& pixel, float weight) {
+    return Pixel4{pixel.v[0] * weight, pixel.v[1] * weight,
+                  pixel.v[2] * weight, pixel.v[3] * weight};
+  }
+};
+#endif
+
+static inline Pixel4 load_pixel(const uint8_t* pixel) {
+  return Pixel4{(float)pixel[0], (float)pixel[1], (float)pixel[2],
+                (float)pixel[3]};
+}
+
+// Truncates like the image package does when it stores channels.
+static inline void store_pixel(uint8_t* out, const Pixel4& pixel) {
+  for (int c = 0; c < 4; c++) {
+    out[c] = (uint8_t)std::min(std::max((int)pixel[c], 0), 255);
+  }
+}
+
+void parallel_for(int count, const std::function<void(int, int)>& func) {
+  const int threads =
+      std::max(1, std::min((int)std::thread::hardware_concurrency(), count));
+  if (threads == 1) {
+    func(0, count);
+    return;
+  }
+
+  const int band = (count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (int begin = band; begin < count; begin += band) {
+    workers.emplace_back(func, begin, std::min(begin + band, count));
+  }
+  func(0, std::min(band, count));
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+Image resize_average(const Image& src, int width, int height) {
+  Image dst(width, height);
+  const double dx = (double)src.width / width;
+  const double dy = (double)src.height / height;
+
+  // Source columns under every output column
+  std::vector<int> x1(width), x2(width);
+  for (int x = 0; x < width; x++) {
+    x1[x] = (int)(x * dx);
+    x2[x] = std::min(std::max((int)((x + 1) * dx), x1[x] + 1), src.width);
+  }
+
+  parallel_for(height, [&](int begin, int end) {
+    std::vector<uint32_t> sums((size_t)width * 4);
+    for (int y = begin; y < end; y++) {
+      const int y1 = (int)(y * dy);
+      const int y2 = std::min(std::max((int)((y + 1) * dy), y1 + 1),
+                              src.height);
+
+      // Sum the rows first, then the columns of every output pixel
+      std::fill(sums.begin(), sums.end(), 0);
+      for (int sy = y1; sy < y2; sy++) {
+        const uint8_t* row = src.row(sy);
+        for (int x = 0; x < width; x++) {
+          uint32_t* sum = &sums[(size_t)x * 4];
+          for (int sx = x1[x]; sx < x2[x]; sx++) {
+            for (int c = 0; c < 4; c++) {
+              sum[c] += row[sx * 4 + c];
+            }
+          }
+        }
+      }
+
+      uint8_t* out = dst.row(y);
+      for (int x = 0; x < width; x++) {
+        const uint32_t count = (uint32_t)(x2[x] - x1[x]) * (y2 - y1);
+        for (int c = 0; c < 4; c++) {
+          out[x * 4 + c] = (uint8_t)(sums[(size_t)x * 4 + c] / count);
+        }
+      }
+    }
+  });
+  return dst;
+}
+
+// Mirrors |x| back inside [0, |size|), then clamps what is still outside.
+static inline int reflect(int size, int x) {
+  if (x < 0) {
+    x = -x;
+  } else if (x >= size) {
+    x = size - (x - size) - 1;
+  }
+  return std::min(std::max(x, 0), size - 1);
+}
+
+Image gaussian_blur(const Image& src, int radius) {
+  if (radius <= 0) {
+    return src;
+  }
+
+  const double sigma = radius * (2.0 / 3.0);
+  const double s = 2.0 * sigma * sigma;
+  std::vector<float> kernel(2 * radius + 1);
+  double sum = 0.0;
+  for (int i = -radius; i <= radius; i++) {
+    kernel[i + radius] = (float)exp(-(i * i) / s);
+    sum += kernel[i + radius];
+  }
+  for (float& weight : kernel) {
+    weight = (float)(weight / sum);
+  }
+
+  const int width = src.width;
+  const int height = src.height;
+
+  // Horizontal pass
+  Image tmp(width, height);
+  parallel_for(height, [&](int begin, int end) {
+    for (int y = begin; y < end; y++) {
+      const uint8_t* row = src.row(y);
+      uint8_t* out = tmp.row(y);
+      for (int x = 0; x < width; x++) {
+        Pixel4 acc = {0, 0, 0, 0};
+        for (int k = -radius; k <= radius; k++) {
+          acc += load_pixel(row + reflect(width, x + k) * 4) *
+                 kernel[k + radius];
+        }
+        store_pixel(out + x * 4, acc);
+      }
+    }
+  });
+
+  // Vertical pass, whole rows at a time so the reads stay sequential
+  Image dst(width, height);
+  parallel_for(height, [&](int begin, int end) {
+    std::vector<Pixel4> acc(width);
+    for (int y = begin; y < end; y++) {
+      std::fill(acc.begin(), acc.end(), Pixel4{0, 0, 0, 0});
+      for (int k = -radius; k <= radius; k++) {
+        const uint8_t* row = tmp.row(reflect(height, y + k));
+        const float weight = kernel[k + radius];
+        for (int x = 0; x < width; x++) {
+          acc[x] += load_pixel(row + x * 4) * weight;
+        }
+      }
+
+      uint8_t* out = dst.row(y);
+      for (int x = 0; x < width; x++) {
+        store_pixel(out + x * 4, acc[x]);
+      }
+    }
+  });
+  return dst;
+}
+
+// Same test as `_isInsideRoundedRect` of the Dart pipeline.
+static bool is_inside_rounded_rect(int x,
+                                   int y,
+                                   int width,
+                                   int height,
+                                   double radius) {
+  int cx, cy;
+  if (x < radius && y < radius) {
+    cx = (int)radius;
+    cy = (int)radius;
+  } else if (x >= width - radius && y < radius) {
+    cx = (int)(width - radius);
+    cy = (int)radius;
+  } else if (x < radius && y >= height - radius) {
+    cx = (int)radius;
+    cy = (int)(height - radius);
+  } else if (x >= width - radius && y >= height - radius) {
+    cx = (int)(width - radius);
+    cy = (int)(height - radius);
+  } else {
+    return true;
+  }
+
+  const int dx = x - cx;
+  const int dy = y - cy;
+  return dx * dx + dy * dy <= radius * radius;
+}
+
+void apply_border_radius(Image* image, double radius) {
+  if (radius <= 0) {
+    return;
+  }
+
+  // Only the corner rows have pixels to clear
+  const int corner = std::min((int)ceil(radius), image->height);
+  auto clear_row = [&](int y) {
+    uint8_t* row = image->row(y);
+    for (int x = 0; x < image->width; x++) {
+      if (!is_inside_rounded_rect(x, y, image->width, image->height, radius)) {
+        memset(row + x * 4, 0, 4);
+      }
+    }
+  };
+  for (int y = 0; y < corner; y++) {
+    clear_row(y);
+  }
+  for (int y = std::max(image->height - corner, corner); y < image->height;
+       y++) {
+    clear_row(y);
+  }
+}
+
+static void get_position(int fg_width,
+                         int fg_height,
+                         int bg_width,
+                         int bg_height,
+                         Alignment alignment,
+                         int* x,
+                         int* y) {
+  const int center_x = (bg_width - fg_width) / 2;
+  const int center_y = (bg_height - fg_height) / 2;
+  switch (alignment) {
+    case kAlignTopLeft:
+      *x = 0, *y = 0;
+      break;
+    case kAlignTopCenter:
+      *x = center_x, *y = 0;
+      break;
+    case kAlignTopRight:
+      *x = bg_width - fg_width, *y = 0;
+      break;
+    case kAlignCenterLeft:
+      *x = 0, *y = center_y;
+      break;
+    case kAlignCenter:
+      *x = center_x, *y = center_y;
+      break;
+    case kAlignCenterRight:
+      *x = bg_width - fg_width, *y = center_y;
+      break;
+    case kAlignBottomLeft:
+      *x = 0, *y = bg_height - fg_height;
+      break;
+    case kAlignBottomCenter:
+      *x = center_x, *y = bg_height - fg_height;
+      break;
+    case kAlignBottomRight:
+      *x = bg_width - fg_width, *y = bg_height - fg_height;
+      break;
+  }
+}
+
+Image compose_with_background(const Image& foreground,
+                              uint32_t argb,
+                              int width,
+                              int height,
+                              double radius,
+                              Alignment alignment) {
+  if (width <= 0) {
+    width = foreground.width;
+  }
+  if (height <= 0) {
+    height = foreground.height;
+  }
+
+  Image background(width, height);
+  const uint8_t color[4] = {(uint8_t)argb, (uint8_t)(argb >> 8),
+                            (uint8_t)(argb >> 16), (uint8_t)(argb >> 24)};
+  for (size_t i = 0; i < background.pixels.size(); i += 4) {
+    memcpy(&background.pixels[i], color, 4);
+  }
+  apply_border_radius(&background, radius);
+
+  int left, top;
+  get_position(foreground.width, foreground.height, width, height, alignment,
+               &left, &top);
+
+  // Straight alpha "over", clipped to the background
+  const int x_begin = std::max(0, -left);
+  const int x_end = std::min(foreground.width, width - left);
+  const int y_begin = std::max(0, -top);
+  const int y_end = std::min(foreground.height, height - top);
+  if (x_begin >= x_end || y_begin >= y_end) {
+    return background;
+  }
+
+  parallel_for(y_end - y_begin, [&](int begin, int end) {
+    for (int y = y_begin + begin; y < y_begin + end; y++) {
+      const uint8_t* src = foreground.row(y);
+      uint8_t* dst = background.row(top + y) + left * 4;
+      for (int x = x_begin; x < x_end; x++) {
+        const uint8_t* s = src + x * 4;
+        uint8_t* d = dst + x * 4;
+        const float sa = s[3] / 255.0f;
+        const float da = d[3] / 255.0f;
+        const float out_a = sa + da * (1.0f - sa);
+        if (out_a <= 0.0f) {
+          memset(d, 0, 4);
+          continue;
+        }
+        for (int c = 0; c < 3; c++) {
+          d[c] = (uint8_t)lroundf(
+              (s[c] * sa + d[c] * da * (1.0f - sa)) / out_a);
+        }
+        d[3] = (uint8_t)lroundf(out_a * 255.0f);
+      }
+    }
+  });
+  return background;
+}
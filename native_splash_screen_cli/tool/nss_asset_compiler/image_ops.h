@@ -0,0 +1,66 @@
+#ifndef NSS_ASSET_COMPILER_IMAGE_OPS_H_
+#define NSS_ASSET_COMPILER_IMAGE_OPS_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+// Image operations of the native asset pipeline.
+//
+// They mirror the Dart pipeline of native_splash_screen_cli
+// (lib/src/image.dart) so both produce the same assets: pixels are 4 bytes,
+// B G R A in memory, with straight (not premultiplied) alpha.
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> pixels;
+
+  Image() = default;
+  Image(int width, int height)
+      : width(width), height(height), pixels((size_t)width * height * 4) {}
+
+  uint8_t* row(int y) { return pixels.data() + (size_t)y * width * 4; }
+  const uint8_t* row(int y) const {
+    return pixels.data() + (size_t)y * width * 4;
+  }
+};
+
+// Position of a foreground image inside its background.
+enum Alignment {
+  kAlignTopLeft,
+  kAlignTopCenter,
+  kAlignTopRight,
+  kAlignCenterLeft,
+  kAlignCenter,
+  kAlignCenterRight,
+  kAlignBottomLeft,
+  kAlignBottomCenter,
+  kAlignBottomRight,
+};
+
+// Runs |func| over [0, |count|) split in bands, one per core.
+void parallel_for(int count, const std::function<void(int, int)>& func);
+
+// Resizes |src| to |width| x |height| by averaging the source pixels under
+// every output pixel, like `Interpolation.average` of the image package.
+Image resize_average(const Image& src, int width, int height);
+
+// Blurs every channel with a separable gaussian kernel of 2 * |radius| + 1
+// taps, reflecting at the edges.
+Image gaussian_blur(const Image& src, int radius);
+
+// Clears the pixels outside of a rectangle with |radius| rounded corners.
+void apply_border_radius(Image* image, double radius);
+
+// Draws |foreground| over a |width| x |height| background of color |argb|,
+// with |radius| rounded corners. A zero size uses the foreground size.
+Image compose_with_background(const Image& foreground,
+                              uint32_t argb,
+                              int width,
+                              int height,
+                              double radius,
+                              Alignment alignment);
+
+#endif  // NSS_ASSET_COMPILER_IMAGE_OPS_H_
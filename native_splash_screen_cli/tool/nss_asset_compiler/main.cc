@@ -0,0 +1,252 @@
+// Native image pipeline of native_splash_screen_cli.
+//
+// Decodes a PNG image, resizes, blurs and composes it over its background
+// like the Dart pipeline, and writes the result to stdout:
+//
+//   "NSSB" | width (u32) | height (u32) | reserved (u32) | B G R A pixels
+//
+// with little endian integers and straight alpha pixels. Exits with 3 when
+// the input is not a PNG image, so the CLI falls back to its Dart pipeline.
+
+#include <png.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "image_ops.h"
+
+namespace {
+
+constexpr int kExitUsage = 1;
+constexpr int kExitFailure = 2;
+constexpr int kExitUnsupported = 3;
+
+struct Options {
+  const char* input = nullptr;
+  int width = 0;
+  int height = 0;
+  bool fit = false;
+  double blur = 0;
+  double radius = 0;
+  bool has_background = false;
+  uint32_t background = 0;
+  int background_width = 0;
+  int background_height = 0;
+  double background_radius = 0;
+  bool canvas = false;
+  Alignment alignment = kAlignCenter;
+};
+
+void print_usage() {
+  fprintf(stderr,
+          "Usage: nss-asset-compiler <input.png> [--width N] [--height N] "
+          "[--fit] [--blur R] [--radius R] [--background AARRGGBB] "
+          "[--background-width N] [--background-height N] "
+          "[--background-radius R] [--canvas] [--align NAME]\n");
+}
+
+bool parse_alignment(const char* name, Alignment* alignment) {
+  static const struct {
+    const char* name;
+    Alignment alignment;
+  } kAlignments[] = {
+      {"topLeft", kAlignTopLeft},
+      {"topCenter", kAlignTopCenter},
+      {"topRight", kAlignTopRight},
+      {"centerLeft", kAlignCenterLeft},
+      {"center", kAlignCenter},
+      {"centerRight", kAlignCenterRight},
+      {"bottomLeft", kAlignBottomLeft},
+      {"bottomCenter", kAlignBottomCenter},
+      {"bottomRight", kAlignBottomRight},
+  };
+  for (const auto& entry : kAlignments) {
+    if (strcmp(entry.name, name) == 0) {
+      *alignment = entry.alignment;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--fit") {
+      options->fit = true;
+      continue;
+    }
+    if (arg == "--canvas") {
+      options->canvas = true;
+      continue;
+    }
+    if (arg.rfind("--", 0) != 0) {
+      if (options->input != nullptr) {
+        return false;
+      }
+      options->input = argv[i];
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+
+    const char* value = argv[++i];
+    char* end = nullptr;
+    if (arg == "--width") {
+      options->width = (int)strtol(value, &end, 10);
+    } else if (arg == "--height") {
+      options->height = (int)strtol(value, &end, 10);
+    } else if (arg == "--blur") {
+      options->blur = strtod(value, &end);
+    } else if (arg == "--radius") {
+      options->radius = strtod(value, &end);
+    } else if (arg == "--background") {
+      options->background = (uint32_t)strtoul(value, &end, 16);
+      options->has_background = true;
+    } else if (arg == "--background-width") {
+      options->background_width = (int)strtol(value, &end, 10);
+    } else if (arg == "--background-height") {
+      options->background_height = (int)strtol(value, &end, 10);
+    } else if (arg == "--background-radius") {
+      options->background_radius = strtod(value, &end);
+    } else if (arg == "--align") {
+      if (!parse_alignment(value, &options->alignment)) {
+        return false;
+      }
+      continue;
+    } else {
+      return false;
+    }
+    if (end == value || *end != '\0') {
+      return false;
+    }
+  }
+  return options->input != nullptr;
+}
+
+bool is_png(FILE* file) {
+  png_byte signature[8];
+  const bool result = fread(signature, 1, sizeof(signature), file) ==
+                          sizeof(signature) &&
+                      png_sig_cmp(signature, 0, sizeof(signature)) == 0;
+  rewind(file);
+  return result;
+}
+
+bool decode_png(FILE* file, Image* image) {
+  png_image png;
+  memset(&png, 0, sizeof(png));
+  png.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_stdio(&png, file)) {
+    fprintf(stderr, "Error: %s\n", png.message);
+    return false;
+  }
+
+  // B G R A in memory with straight alpha, like the Dart pipeline
+  png.format = PNG_FORMAT_BGRA;
+  *image = Image((int)png.width, (int)png.height);
+  if (!png_image_finish_read(&png, nullptr, image->pixels.data(), 0,
+                             nullptr)) {
+    fprintf(stderr, "Error: %s\n", png.message);
+    png_image_free(&png);
+    return false;
+  }
+  return true;
+}
+
+// Same steps, in the same order, as `loadImageAsBGRA` of the Dart pipeline.
+Image process(Image image, const Options& options) {
+  const int target_width = options.width;
+  const int target_height = options.height;
+  if ((options.fit || image.width > target_width ||
+       image.height > target_height) &&
+      target_width > 0 && target_height > 0) {
+    if (target_width != image.width || target_height != image.height) {
+      image = resize_average(image, target_width, target_height);
+    }
+  }
+
+  const int blur = (int)(options.blur + 0.5);
+  if (blur > 0) {
+    image = gaussian_blur(image, blur);
+  }
+
+  apply_border_radius(&image, options.radius);
+
+  if (options.has_background && (options.background >> 24) != 0) {
+    image = compose_with_background(
+        image, options.background, options.background_width,
+        options.background_height, options.background_radius,
+        options.alignment);
+  } else if (options.canvas && target_width > 0 && target_height > 0) {
+    image = compose_with_background(image, 0, target_width, target_height,
+                                    options.background_radius,
+                                    options.alignment);
+  }
+  return image;
+}
+
+void put_u32(uint8_t* out, uint32_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+  out[2] = (uint8_t)(value >> 16);
+  out[3] = (uint8_t)(value >> 24);
+}
+
+bool write_image(const Image& image) {
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+  uint8_t header[16] = {'N', 'S', 'S', 'B'};
+  put_u32(header + 4, (uint32_t)image.width);
+  put_u32(header + 8, (uint32_t)image.height);
+  put_u32(header + 12, 0);
+  return fwrite(header, 1, sizeof(header), stdout) == sizeof(header) &&
+         fwrite(image.pixels.data(), 1, image.pixels.size(), stdout) ==
+             image.pixels.size() &&
+         fflush(stdout) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, &options)) {
+    print_usage();
+    return kExitUsage;
+  }
+
+  FILE* file = fopen(options.input, "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "Error: Cannot open %s\n", options.input);
+    return kExitFailure;
+  }
+  if (!is_png(file)) {
+    fclose(file);
+    return kExitUnsupported;
+  }
+
+  Image image;
+  const bool decoded = decode_png(file, &image);
+  fclose(file);
+  if (!decoded) {
+    return kExitFailure;
+  }
+
+  if (!write_image(process(std::move(image), options))) {
+    fprintf(stderr, "Error: Cannot write the image\n");
+    return kExitFailure;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_FLAVOR_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_FLAVOR_H_
+
+// Shared by the plugin and the generated native_splash_screen_flavors.cc,
+// which is compiled into the plugin but can not include its GTK headers.
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+// Settings of a flavor embedded next to the one of the build configuration,
+// selected when the splash is shown. Its image only comes as compressed
+// variants, so the flavors that are not shown are never decoded
+typedef struct NativeSplashScreenFlavor {
+  const char* name;
+  int width;
+  int height;
+  const char* title;
+  bool with_animation;
+  unsigned int background_color;
+  unsigned int background_rect_color;
+  int background_rect_width;
+  int background_rect_height;
+  double background_rect_radius;
+  int background_gradient;
+  unsigned int background_gradient_color;
+  double background_gradient_angle;
+  int spinner_size;
+  unsigned int spinner_color;
+  int spinner_offset_y;
+  int spinner_period;
+  int spinner_frames;
+  double image_blur_radius;
+  unsigned int image_shadow_color;
+  double image_shadow_radius;
+  int image_shadow_offset_x;
+  int image_shadow_offset_y;
+  bool opaque;
+  int shape_rect_count;
+  const int* shape_rects;
+  int image_variant_count;
+  const int* image_variant_scales;
+  const unsigned char* const* image_variants;
+  const unsigned int* image_variant_sizes;
+  int image_dark_variant_count;
+  const int* image_dark_variant_scales;
+  const unsigned char* const* image_dark_variants;
+  const unsigned int* image_dark_variant_sizes;
+  const unsigned char* animation;
+  unsigned int animation_size;
+  unsigned long long asset_hash;
+} NativeSplashScreenFlavor;
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_FLAVOR_H_
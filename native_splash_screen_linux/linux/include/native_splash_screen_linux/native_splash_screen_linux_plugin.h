@@ -4,6 +4,8 @@
 #include <flutter_linux/flutter_linux.h>
 #include <gtk/gtk.h>
 
+#include "native_splash_screen_flavor.h"
+
 G_BEGIN_DECLS
 
 #ifdef FLUTTER_PLUGIN_IMPL
@@ -40,6 +42,101 @@ extern const unsigned char*
 extern int native_splash_screen_image_width;
 extern int native_splash_screen_image_height;
 
+// Encoding of the image pixels (0: ARGB, 1: 8-bit palette indices, 2: tiles,
+// 3: vector display list)
+extern int native_splash_screen_image_format;
+extern const unsigned int*
+    native_splash_screen_image_palette;  // Palette entries in ARGB format
+extern int native_splash_screen_image_palette_size;
+
+// Tiled images: the pixels point to the tile blob shared by all flavors and
+// the palette to the solid tile colors
+extern int native_splash_screen_image_tile_size;
+extern const unsigned int*
+    native_splash_screen_image_tile_map;  // One entry per tile, row by row
+
+// Vector images: the pixels point to the display list, of the given size in
+// bytes
+extern unsigned int native_splash_screen_image_vector_size;
+
+// Splash asset file holding the image instead of the pixels above, relative
+// to the data directory of the bundle (nullptr when the image is embedded)
+extern const char* native_splash_screen_image_asset;
+
+// HiDPI variants of the embedded image, as compressed splash asset blobs made
+// for the given scale factors. Only the one matching the display is decoded
+extern int native_splash_screen_image_variant_count;
+extern const int* native_splash_screen_image_variant_scales;
+extern const unsigned char* const* native_splash_screen_image_variants;
+extern const unsigned int* native_splash_screen_image_variant_sizes;
+
+// Variants of the image for a dark desktop appearance, compressed like the
+// HiDPI ones and made for the given scale factors, 1x included. Only decoded
+// when the desktop prefers a dark color scheme
+extern int native_splash_screen_image_dark_variant_count;
+extern const int* native_splash_screen_image_dark_variant_scales;
+extern const unsigned char* const* native_splash_screen_image_dark_variants;
+extern const unsigned int* native_splash_screen_image_dark_variant_sizes;
+
+// Animation played over the splash, as a blob of keyframes and of frames
+// only holding the dirty rectangle of what changed (nullptr without one)
+extern const unsigned char* native_splash_screen_animation;
+extern unsigned int native_splash_screen_animation_size;
+
+// Hash of the generated assets, keys the persistent cache of the composed
+// splash (0 disables the cache)
+extern unsigned long long native_splash_screen_asset_hash;
+
+// Placement of the image inside its canvas, once its transparent borders
+// have been trimmed
+extern int native_splash_screen_image_offset_x;
+extern int native_splash_screen_image_offset_y;
+extern int native_splash_screen_image_canvas_width;
+extern int native_splash_screen_image_canvas_height;
+
+// Background rectangle drawn at runtime behind the image
+extern unsigned int native_splash_screen_background_rect_color;  // ARGB format
+extern int native_splash_screen_background_rect_width;
+extern int native_splash_screen_background_rect_height;
+extern double native_splash_screen_background_rect_radius;
+extern int native_splash_screen_background_gradient;  // 0: none, 1: linear,
+                                                      // 2: radial
+extern unsigned int
+    native_splash_screen_background_gradient_color;  // ARGB format
+extern double native_splash_screen_background_gradient_angle;  // Degrees
+
+// Loading spinner drawn by the plugin, centered horizontally in the
+// background rectangle and |offset_y| below its center (no spinner when the
+// size is 0)
+extern int native_splash_screen_spinner_size;
+extern unsigned int native_splash_screen_spinner_color;  // ARGB format
+extern int native_splash_screen_spinner_offset_y;
+extern int native_splash_screen_spinner_period;  // Milliseconds per turn
+extern int native_splash_screen_spinner_frames;  // Pre-rotated frames
+
+// Blur of the image and drop shadow drawn from its alpha channel by the
+// plugin, radii in logical pixels (no shadow when its color is transparent)
+extern double native_splash_screen_image_blur_radius;
+extern unsigned int native_splash_screen_image_shadow_color;  // ARGB format
+extern double native_splash_screen_image_shadow_radius;
+extern int native_splash_screen_image_shadow_offset_x;
+extern int native_splash_screen_image_shadow_offset_y;
+
+// The background rectangle or the image cover the window with opaque pixels,
+// so the window does not need an alpha channel
+extern bool native_splash_screen_opaque;
+
+// Shape of the window on screens without a compositor, as x, y, width and
+// height quadruplets in window coordinates (no shape when the count is 0)
+extern int native_splash_screen_shape_rect_count;
+extern const int* native_splash_screen_shape_rects;
+
+// Index of the embedded flavors, selected by the `--splash-flavor=<name>`
+// command-line flag, the NATIVE_SPLASH_SCREEN_FLAVOR environment variable or
+// the last component of the application ID
+extern int native_splash_screen_flavor_count;
+extern const NativeSplashScreenFlavor* native_splash_screen_flavors;
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,10 +2,29 @@
 
 #include <cairo.h>
 #include <flutter_linux/flutter_linux.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 #include <gdk/gdk.h>
 #include <gtk/gtk.h>
 
 #include "native_splash_screen_linux_plugin_private.h"
+#include "splash_animation.h"
+#include "splash_asset.h"
+#include "splash_blur.h"
+#include "splash_cache.h"
+#include "splash_config.h"
+#include "splash_metrics.h"
+#include "splash_pixels.h"
+#include "splash_scaler.h"
+#include "splash_scene.h"
+#include "splash_spinner.h"
+#include "splash_theme.h"
+#include "splash_vector.h"
 
 #define NATIVE_SPLASH_SCREEN_LINUX_PLUGIN(obj)                              \
   (G_TYPE_CHECK_INSTANCE_CAST((obj),                                        \
@@ -16,10 +35,89 @@ struct _NativeSplashScreenLinuxPlugin {
   GObject parent_instance;
 };
 
+// Defaults for the symbols that sources generated by older versions of
+// native_splash_screen_cli do not define. The generated definitions take
+// precedence over these weak ones at link time.
+__attribute__((weak)) int native_splash_screen_image_format =
+    SPLASH_PIXEL_FORMAT_ARGB32;
+__attribute__((weak)) const unsigned int* native_splash_screen_image_palette =
+    nullptr;
+__attribute__((weak)) int native_splash_screen_image_palette_size = 0;
+__attribute__((weak)) int native_splash_screen_image_tile_size = 0;
+__attribute__((weak)) const unsigned int* native_splash_screen_image_tile_map =
+    nullptr;
+__attribute__((weak)) unsigned int native_splash_screen_image_vector_size = 0;
+__attribute__((weak)) const char* native_splash_screen_image_asset = nullptr;
+__attribute__((weak)) unsigned long long native_splash_screen_asset_hash = 0;
+__attribute__((weak)) int native_splash_screen_image_variant_count = 0;
+__attribute__((weak)) const int* native_splash_screen_image_variant_scales =
+    nullptr;
+__attribute__((weak)) const unsigned char* const*
+    native_splash_screen_image_variants = nullptr;
+__attribute__((weak)) const unsigned int*
+    native_splash_screen_image_variant_sizes = nullptr;
+__attribute__((weak)) int native_splash_screen_image_dark_variant_count = 0;
+__attribute__((weak)) const int*
+    native_splash_screen_image_dark_variant_scales = nullptr;
+__attribute__((weak)) const unsigned char* const*
+    native_splash_screen_image_dark_variants = nullptr;
+__attribute__((weak)) const unsigned int*
+    native_splash_screen_image_dark_variant_sizes = nullptr;
+__attribute__((weak)) const unsigned char* native_splash_screen_animation =
+    nullptr;
+__attribute__((weak)) unsigned int native_splash_screen_animation_size = 0;
+__attribute__((weak)) int native_splash_screen_image_offset_x = 0;
+__attribute__((weak)) int native_splash_screen_image_offset_y = 0;
+__attribute__((weak)) int native_splash_screen_image_canvas_width = 0;
+__attribute__((weak)) int native_splash_screen_image_canvas_height = 0;
+__attribute__((weak)) unsigned int native_splash_screen_background_rect_color =
+    0x00000000;
+__attribute__((weak)) int native_splash_screen_background_rect_width = 0;
+__attribute__((weak)) int native_splash_screen_background_rect_height = 0;
+__attribute__((weak)) double native_splash_screen_background_rect_radius = 0.0;
+__attribute__((weak)) int native_splash_screen_background_gradient = 0;
+__attribute__((weak)) unsigned int
+    native_splash_screen_background_gradient_color = 0x00000000;
+__attribute__((weak)) double native_splash_screen_background_gradient_angle =
+    90.0;
+__attribute__((weak)) int native_splash_screen_spinner_size = 0;
+__attribute__((weak)) unsigned int native_splash_screen_spinner_color =
+    0xFF808080;
+__attribute__((weak)) int native_splash_screen_spinner_offset_y = 0;
+__attribute__((weak)) int native_splash_screen_spinner_period = 1000;
+__attribute__((weak)) int native_splash_screen_spinner_frames = 30;
+__attribute__((weak)) double native_splash_screen_image_blur_radius = 0.0;
+__attribute__((weak)) unsigned int native_splash_screen_image_shadow_color =
+    0x00000000;
+__attribute__((weak)) double native_splash_screen_image_shadow_radius = 0.0;
+__attribute__((weak)) int native_splash_screen_image_shadow_offset_x = 0;
+__attribute__((weak)) int native_splash_screen_image_shadow_offset_y = 0;
+__attribute__((weak)) bool native_splash_screen_opaque = false;
+__attribute__((weak)) int native_splash_screen_shape_rect_count = 0;
+__attribute__((weak)) const int* native_splash_screen_shape_rects = nullptr;
+__attribute__((weak)) int native_splash_screen_flavor_count = 0;
+__attribute__((weak)) const NativeSplashScreenFlavor*
+    native_splash_screen_flavors = nullptr;
+
+// Bounds of the section holding the generated pixel arrays, defined by the
+// linker when the generated sources place data in it.
+extern "C" __attribute__((weak))
+const unsigned char __start_native_splash_screen_data[];
+extern "C" __attribute__((weak))
+const unsigned char __stop_native_splash_screen_data[];
+
 G_DEFINE_TYPE(NativeSplashScreenLinuxPlugin,
               native_splash_screen_linux_plugin,
               g_object_get_type())
 
+// Adds a recorded metric to the map returned by `getMetrics`.
+static void add_metric_to_map(const gchar* name,
+                              gint64 value,
+                              gpointer user_data) {
+  fl_value_set_string_take(static_cast<FlValue*>(user_data), name,
+                           fl_value_new_int(value));
+}
+
 // Called when a method call is received from Flutter.
 static void native_splash_screen_linux_plugin_handle_method_call(
     NativeSplashScreenLinuxPlugin* self,
@@ -54,6 +152,12 @@ static void native_splash_screen_linux_plugin_handle_method_call(
 
     close_splash_screen(effect);
     response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (g_strcmp0(method, "getMetrics") == 0) {
+    g_autoptr(FlValue) metrics = fl_value_new_map();
+    splash_metrics_foreach(add_metric_to_map, metrics);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(metrics));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
   }
 
   fl_method_call_respond(method_call, response, nullptr);
@@ -97,17 +201,48 @@ void native_splash_screen_linux_plugin_register_with_registrar(
 
 // Global variables to manage the splash window
 static GtkWidget* splash_window = nullptr;
+static GtkWidget* splash_drawing_area = nullptr;
+static SplashScene* splash_scene = nullptr;
+static gulong composited_changed_handler = 0;
+static cairo_surface_t* splash_image_surface = nullptr;
+static SplashImage splash_image;
+static int splash_display_scale = 1;
+static double splash_image_x = 0;
+static double splash_image_y = 0;
+static double splash_image_margin_x = 0;
+static double splash_image_margin_y = 0;
+static SplashAsset* splash_asset = nullptr;
+static cairo_surface_t* splash_cached_surface = nullptr;
+static gchar* splash_cache_path = nullptr;
+static guint64 splash_cache_key = 0;
+static gboolean splash_dark_theme = FALSE;
+static SplashAnimation* splash_animation = nullptr;
+static cairo_surface_t* splash_animation_surface = nullptr;
+static int splash_animation_frame = 0;
+static int splash_animation_loops = 0;
+static gint64 splash_animation_next_time = 0;
+static guint splash_animation_tick_id = 0;
+static SplashSpinner* splash_spinner = nullptr;
+static int splash_spinner_frame = 0;
+static gint64 splash_spinner_start_time = 0;
 static gboolean splash_shown = FALSE;
 static guint animation_timer_id = 0;
 
+// Distance the content slides by when the splash closes with a slide
+#define SPLASH_SLIDE_DISTANCE 50
+
+// Transparent margin above and below the content of a window with an alpha
+// channel, which the content slides into instead of being clipped
+static int splash_slide_margin = 0;
+
 // Forward declarations
 static gboolean on_draw_event(GtkWidget* widget,
                               cairo_t* cr,
                               gpointer user_data);
+static void on_splash_destroyed(GtkWidget* widget, gpointer user_data);
 static gboolean fade_in_func(gpointer user_data);
 static gboolean fade_out_func(gpointer user_data);
-static gboolean slide_up_fade_func(gpointer user_data);
-static gboolean slide_down_fade_func(gpointer user_data);
+static gboolean slide_fade_func(gpointer user_data);
 
 // Data structure for fade animation steps
 struct FadeData {
@@ -121,8 +256,9 @@ struct SlideFadeData {
   GtkWidget* window;
   int current_step;
   int total_steps;
-  int start_y;
   int move_distance;
+  gboolean move_window;
+  int start_y;
 };
 
 // Function to clean up animation timer if it exists
@@ -133,12 +269,1459 @@ static void cleanup_animation_timer() {
   }
 }
 
+// Sets an ARGB color as the cairo source.
+static void set_source_argb(cairo_t* cr, unsigned int argb) {
+  cairo_set_source_rgba(cr, ((argb >> 16) & 0xFF) / 255.0,
+                        ((argb >> 8) & 0xFF) / 255.0, (argb & 0xFF) / 255.0,
+                        ((argb >> 24) & 0xFF) / 255.0);
+}
+
+// Adds a rectangle with rounded corners to the current path.
+static void rounded_rectangle(cairo_t* cr,
+                              double width,
+                              double height,
+                              double radius) {
+  radius = CLAMP(radius, 0.0, MIN(width, height) / 2.0);
+  if (radius <= 0.0) {
+    cairo_rectangle(cr, 0, 0, width, height);
+    return;
+  }
+
+  cairo_new_sub_path(cr);
+  cairo_arc(cr, width - radius, radius, radius, -G_PI / 2, 0);
+  cairo_arc(cr, width - radius, height - radius, radius, 0, G_PI / 2);
+  cairo_arc(cr, radius, height - radius, radius, G_PI / 2, G_PI);
+  cairo_arc(cr, radius, radius, radius, G_PI, 3 * G_PI / 2);
+  cairo_close_path(cr);
+}
+
+// Fills the layer with the window color, used when the screen can not
+// composite the transparent parts of the splash.
+static void paint_window_color_layer(cairo_t* cr,
+                                     int width,
+                                     int height,
+                                     gpointer user_data) {
+  set_source_argb(cr, SplashConfig::background_color());
+  cairo_rectangle(cr, 0, 0, width, height);
+  cairo_fill(cr);
+}
+
+// Returns TRUE if the generated configuration asks for a background
+// rectangle that would actually be visible.
+static gboolean has_background_rect() {
+  if (SplashConfig::background_rect_width() <= 0 ||
+      SplashConfig::background_rect_height() <= 0) {
+    return FALSE;
+  }
+
+  gboolean visible_color =
+      (SplashConfig::background_rect_color() >> 24) != 0;
+  gboolean visible_gradient =
+      SplashConfig::background_gradient() != 0 &&
+      (SplashConfig::background_gradient_color() >> 24) != 0;
+  return visible_color || visible_gradient;
+}
+
+// Draws the background rectangle from its generated parameters, so it does
+// not need to be baked into the embedded pixels.
+static void paint_background_layer(cairo_t* cr,
+                                   int width,
+                                   int height,
+                                   gpointer user_data) {
+  cairo_pattern_t* pattern = nullptr;
+
+  if (SplashConfig::background_gradient() == 1) {
+    // Linear gradient through the center, 0 degrees goes left to right
+    double angle = SplashConfig::background_gradient_angle() * G_PI / 180;
+    double dx = cos(angle) * width / 2.0;
+    double dy = sin(angle) * height / 2.0;
+    pattern = cairo_pattern_create_linear(width / 2.0 - dx, height / 2.0 - dy,
+                                          width / 2.0 + dx, height / 2.0 + dy);
+  } else if (SplashConfig::background_gradient() == 2) {
+    // Radial gradient from the center to the farthest edge
+    pattern = cairo_pattern_create_radial(width / 2.0, height / 2.0, 0,
+                                          width / 2.0, height / 2.0,
+                                          MAX(width, height) / 2.0);
+  }
+
+  rounded_rectangle(cr, width, height,
+                    SplashConfig::background_rect_radius());
+
+  if (pattern != nullptr) {
+    const unsigned int stops[2] = {
+        SplashConfig::background_rect_color(),
+        SplashConfig::background_gradient_color()};
+    for (int i = 0; i < 2; i++) {
+      cairo_pattern_add_color_stop_rgba(
+          pattern, i, ((stops[i] >> 16) & 0xFF) / 255.0,
+          ((stops[i] >> 8) & 0xFF) / 255.0, (stops[i] & 0xFF) / 255.0,
+          ((stops[i] >> 24) & 0xFF) / 255.0);
+    }
+    cairo_set_source(cr, pattern);
+    cairo_fill(cr);
+    cairo_pattern_destroy(pattern);
+  } else {
+    set_source_argb(cr, SplashConfig::background_rect_color());
+    cairo_fill(cr);
+  }
+}
+
+// Returns the number of bytes of embedded pixel data the image reads.
+static size_t embedded_pixels_size() {
+  const size_t pixels = (size_t)MAX(SplashConfig::image_width(), 0) *
+                        MAX(SplashConfig::image_height(), 0);
+
+  switch (SplashConfig::image_format()) {
+    case SPLASH_PIXEL_FORMAT_ARGB32:
+      return pixels * 4;
+    case SPLASH_PIXEL_FORMAT_INDEXED8:
+      return pixels;
+    case SPLASH_PIXEL_FORMAT_TILED: {
+      if (native_splash_screen_image_tile_map == nullptr ||
+          SplashConfig::image_tile_size() <= 0) {
+        return 0;
+      }
+      // Clamped so the division is not folded into a division by zero when
+      // the settings are constants
+      const int tile_size = MAX(SplashConfig::image_tile_size(), 1);
+      const size_t tiles =
+          (size_t)((SplashConfig::image_width() + tile_size - 1) /
+                   tile_size) *
+          ((SplashConfig::image_height() + tile_size - 1) / tile_size);
+      size_t used = 0;
+      for (size_t i = 0; i < tiles; i++) {
+        const uint32_t entry = native_splash_screen_image_tile_map[i];
+        if (!(entry & SPLASH_TILE_SOLID)) {
+          used = MAX(used, (size_t)entry + 1);
+        }
+      }
+      return used * tile_size * tile_size * 4;
+    }
+    case SPLASH_PIXEL_FORMAT_VECTOR:
+      return SplashConfig::image_vector_size();
+    default:
+      return 0;
+  }
+}
+
+// Passes |advice| to the kernel for the pages of the embedded pixel data.
+//
+// The generator places the pixel arrays in their own page-aligned section,
+// older sources only provide the pixels pointer. With MADV_DONTNEED only the
+// pages fully covered by the data are released, the data is read-only and
+// backed by the library file so they would be read back from disk if needed.
+static void advise_embedded_pixels(int advice) {
+  if (SplashConfig::image_asset() != nullptr ||
+      native_splash_screen_image_pixels == nullptr) {
+    return;
+  }
+
+  uintptr_t begin = (uintptr_t)native_splash_screen_image_pixels;
+  size_t size = embedded_pixels_size();
+  if (__start_native_splash_screen_data != nullptr &&
+      __stop_native_splash_screen_data != nullptr) {
+    begin = (uintptr_t)__start_native_splash_screen_data;
+    size = __stop_native_splash_screen_data - __start_native_splash_screen_data;
+  }
+  if (size == 0) {
+    return;
+  }
+
+  const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t start = begin & ~(page - 1);
+  uintptr_t end = (begin + size + page - 1) & ~(page - 1);
+  if (advice == MADV_DONTNEED) {
+    start = (begin + page - 1) & ~(page - 1);
+    end = (begin + size) & ~(page - 1);
+  }
+
+  if (end > start) {
+    madvise(reinterpret_cast<void*>(start), end - start, advice);
+  }
+}
+
+// Returns TRUE if an image made for |candidate| scale suits a |scale|
+// display better than one made for |current|. Downscaling a larger image
+// looks better than upscaling a smaller one.
+static gboolean is_better_scale(int candidate, int current, int scale) {
+  if (candidate == current) {
+    return FALSE;
+  }
+  if (candidate >= scale) {
+    return current < scale || candidate < current;
+  }
+  return current < scale && candidate > current;
+}
+
+// Returns the path of the asset file |name| made for |scale|, e.g.
+// `splash@2x.nss` for `splash.nss`. Relative names are looked up in the data
+// directory of the bundle, next to the Flutter assets.
+static gchar* get_asset_path(const gchar* name, int scale) {
+  g_autofree gchar* scaled = nullptr;
+  if (scale > 1) {
+    const gchar* extension = strrchr(name, '.');
+    const int stem = extension != nullptr ? (int)(extension - name)
+                                          : (int)strlen(name);
+    scaled = g_strdup_printf("%.*s@%dx%s", stem, name, scale,
+                             extension != nullptr ? extension : "");
+    name = scaled;
+  }
+
+  if (g_path_is_absolute(name)) {
+    return g_strdup(name);
+  }
+
+  g_autofree gchar* executable = g_file_read_link("/proc/self/exe", nullptr);
+  g_autofree gchar* directory =
+      executable != nullptr ? g_path_get_dirname(executable) : nullptr;
+  return g_build_filename(directory != nullptr ? directory : ".", "data", name,
+                          nullptr);
+}
+
+// Opens the asset file named by the generated sources, preferring the
+// variant made for |scale| when it is installed.
+static void load_splash_asset_file(int scale) {
+  if (scale > 1) {
+    g_autofree gchar* path =
+        get_asset_path(SplashConfig::image_asset(), scale);
+    if (g_file_test(path, G_FILE_TEST_EXISTS)) {
+      g_autoptr(GError) error = nullptr;
+      splash_asset = splash_asset_open(path, &error);
+      if (splash_asset != nullptr) {
+        splash_image = *splash_asset_get_image(splash_asset);
+        splash_image.scale = scale;
+        return;
+      }
+      g_warning("Failed to load the splash asset %s: %s", path,
+                error->message);
+    }
+  }
+
+  g_autofree gchar* path = get_asset_path(SplashConfig::image_asset(), 1);
+  g_autoptr(GError) error = nullptr;
+  splash_asset = splash_asset_open(path, &error);
+  if (splash_asset == nullptr) {
+    g_warning("Failed to load the splash asset %s: %s", path, error->message);
+    return;
+  }
+  splash_image = *splash_asset_get_image(splash_asset);
+}
+
+// Decodes the variant closest to |scale| among the |count| compressed ones
+// made for |scales|, if any suits it better than an image of
+// |fallback_scale| (0 when there is none). Returns FALSE to fall back to it.
+static gboolean load_splash_variant(int scale,
+                                    int count,
+                                    const int* scales,
+                                    const unsigned char* const* variants,
+                                    const unsigned int* sizes,
+                                    int fallback_scale) {
+  int best = -1;
+  int best_scale = fallback_scale;
+  for (int i = 0; i < count; i++) {
+    const int candidate = scales[i];
+    if (is_better_scale(candidate, best_scale, scale)) {
+      best = i;
+      best_scale = candidate;
+    }
+  }
+  if (best < 0) {
+    return FALSE;
+  }
+
+  g_autoptr(GError) error = nullptr;
+  splash_asset =
+      splash_asset_new_from_data(variants[best], sizes[best], &error);
+  if (splash_asset == nullptr) {
+    g_warning("Failed to decode the %dx splash image: %s", best_scale,
+              error->message);
+    return FALSE;
+  }
+
+  splash_image = *splash_asset_get_image(splash_asset);
+  splash_image.scale = best_scale;
+  return TRUE;
+}
+
+// Resolves the image of the splash for a |scale| display, either from the
+// embedded data or from the asset file named by the generated sources, or
+// from the dark variants on a dark desktop. Only the selected variant is
+// decoded.
+static void load_splash_image(int scale) {
+  memset(&splash_image, 0, sizeof(splash_image));
+  splash_image.scale = 1;
+  splash_display_scale = scale;
+
+  // The dark variants replace the image, wherever it is stored
+  if (splash_dark_theme &&
+      load_splash_variant(scale, SplashConfig::image_dark_variant_count(),
+                          native_splash_screen_image_dark_variant_scales,
+                          native_splash_screen_image_dark_variants,
+                          native_splash_screen_image_dark_variant_sizes, 0)) {
+    splash_metrics_record("image_scale", splash_image.scale);
+    return;
+  }
+
+  if (SplashConfig::image_asset() != nullptr) {
+    load_splash_asset_file(scale);
+  } else if (!load_splash_variant(
+                 scale, SplashConfig::image_variant_count(),
+                 native_splash_screen_image_variant_scales,
+                 native_splash_screen_image_variants,
+                 native_splash_screen_image_variant_sizes,
+                 // Flavors selected at runtime only come as variants
+                 native_splash_screen_image_pixels != nullptr ? 1 : 0)) {
+    splash_image.format = SplashConfig::image_format();
+    splash_image.width = SplashConfig::image_width();
+    splash_image.height = SplashConfig::image_height();
+    splash_image.pixels = native_splash_screen_image_pixels;
+    splash_image.palette = native_splash_screen_image_palette;
+    splash_image.palette_size = SplashConfig::image_palette_size();
+    splash_image.tile_size = SplashConfig::image_tile_size();
+    splash_image.tile_map = native_splash_screen_image_tile_map;
+    splash_image.offset_x = SplashConfig::image_offset_x();
+    splash_image.offset_y = SplashConfig::image_offset_y();
+    splash_image.canvas_width = SplashConfig::image_canvas_width();
+    splash_image.canvas_height = SplashConfig::image_canvas_height();
+
+    // Display lists are drawn at the resolution of the display, so the image
+    // is made for its scale
+    if (splash_image.format == SPLASH_PIXEL_FORMAT_VECTOR) {
+      splash_image.scale = scale;
+      splash_image.width *= scale;
+      splash_image.height *= scale;
+      splash_image.offset_x *= scale;
+      splash_image.offset_y *= scale;
+      splash_image.canvas_width *= scale;
+      splash_image.canvas_height *= scale;
+    }
+  }
+
+  splash_metrics_record("image_scale", splash_image.scale);
+}
+
+// Replays the display list of a vector image into a new surface of its size
+// in device pixels. Returns nullptr on failure.
+static cairo_surface_t* rasterize_vector_image() {
+  const gint64 start = g_get_monotonic_time();
+
+  cairo_surface_t* surface = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, splash_image.width, splash_image.height);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    return nullptr;
+  }
+
+  cairo_t* cr = cairo_create(surface);
+  const int scale = MAX(splash_image.scale, 1);
+  cairo_scale(cr, scale, scale);
+  g_autoptr(GError) error = nullptr;
+  const gboolean drawn =
+      splash_vector_render(splash_image.pixels,
+                           SplashConfig::image_vector_size(), cr, &error);
+  cairo_destroy(cr);
+  if (!drawn) {
+    g_warning("Failed to draw the splash image: %s", error->message);
+    cairo_surface_destroy(surface);
+    return nullptr;
+  }
+
+  splash_metrics_record("image_rasterize_us", g_get_monotonic_time() - start);
+  return surface;
+}
+
+// Decodes the splash image into a cairo surface, once per splash.
+//
+// Plain ARGB pixels are wrapped without a copy, palette and tiled images are
+// expanded into a new surface, and vector images are drawn into one.
+static cairo_surface_t* create_image_surface() {
+  const int width = splash_image.width;
+  const int height = splash_image.height;
+
+  if (splash_image.format == SPLASH_PIXEL_FORMAT_ARGB32) {
+    return cairo_image_surface_create_for_data(
+        (unsigned char*)splash_image.pixels, CAIRO_FORMAT_ARGB32, width,
+        height,
+        width * 4  // Stride
+    );
+  }
+
+  if (splash_image.format == SPLASH_PIXEL_FORMAT_INDEXED8) {
+    cairo_surface_t* surface =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    unsigned char* data = cairo_image_surface_get_data(surface);
+    const int stride = cairo_image_surface_get_stride(surface);
+    if (data == nullptr) {
+      return surface;
+    }
+
+    cairo_surface_flush(surface);
+    for (int y = 0; y < height; y++) {
+      splash_pixels_expand_palette(
+          splash_image.pixels + (size_t)y * width, width, splash_image.palette,
+          splash_image.palette_size,
+          reinterpret_cast<uint32_t*>(data + (size_t)y * stride));
+    }
+    cairo_surface_mark_dirty(surface);
+    return surface;
+  }
+
+  if (splash_image.format == SPLASH_PIXEL_FORMAT_TILED) {
+    cairo_surface_t* surface =
+        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    unsigned char* data = cairo_image_surface_get_data(surface);
+    if (data == nullptr || splash_image.tile_map == nullptr) {
+      return surface;
+    }
+
+    cairo_surface_flush(surface);
+    splash_pixels_decode_tiles(
+        splash_image.tile_map, splash_image.tile_size, splash_image.pixels,
+        splash_image.palette, splash_image.palette_size, width, height, data,
+        cairo_image_surface_get_stride(surface));
+    cairo_surface_mark_dirty(surface);
+    return surface;
+  }
+
+  if (splash_image.format == SPLASH_PIXEL_FORMAT_VECTOR) {
+    return rasterize_vector_image();
+  }
+
+  g_warning("Unsupported splash image format: %d", splash_image.format);
+  return nullptr;
+}
+
+// Resamples |surface|, an image made for |scale|, to the resolution of a
+// |display_scale| display. Returns nullptr on failure.
+static cairo_surface_t* resample_image_surface(cairo_surface_t* surface,
+                                               int scale,
+                                               int display_scale) {
+  const gint64 start = g_get_monotonic_time();
+
+  const int width = cairo_image_surface_get_width(surface);
+  const int height = cairo_image_surface_get_height(surface);
+  const int target_width =
+      MAX((int)lround((double)width * display_scale / scale), 1);
+  const int target_height =
+      MAX((int)lround((double)height * display_scale / scale), 1);
+
+  cairo_surface_t* resampled = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, target_width, target_height);
+  if (cairo_surface_status(resampled) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(resampled);
+    return nullptr;
+  }
+
+  // Shrinking by 2 or more averages, otherwise keep the edges sharp
+  const SplashScaleFilter filter = target_width * 2 <= width
+                                       ? SPLASH_SCALE_FILTER_BOX
+                                       : SPLASH_SCALE_FILTER_LANCZOS2;
+
+  cairo_surface_flush(surface);
+  cairo_surface_flush(resampled);
+  if (!splash_scaler_resample(cairo_image_surface_get_data(surface), width,
+                              height, cairo_image_surface_get_stride(surface),
+                              cairo_image_surface_get_data(resampled),
+                              target_width, target_height,
+                              cairo_image_surface_get_stride(resampled),
+                              filter)) {
+    cairo_surface_destroy(resampled);
+    return nullptr;
+  }
+  cairo_surface_mark_dirty(resampled);
+
+  // The rounded size keeps the logical size of the image
+  cairo_surface_set_device_scale(resampled,
+                                 (double)target_width * scale / width,
+                                 (double)target_height * scale / height);
+
+  splash_metrics_record("image_resample_us", g_get_monotonic_time() - start);
+  return resampled;
+}
+
+// Returns the standard deviation of the gaussian of a blur |radius|, the
+// one native_splash_screen_cli used when it baked the blur into the image.
+static double get_blur_sigma(double radius) {
+  return radius > 0 ? radius * 2 / 3 : 0;
+}
+
+// Returns TRUE if the generated configuration asks for a visible shadow.
+static gboolean has_image_shadow() {
+  return (SplashConfig::image_shadow_color() >> 24) != 0;
+}
+
+// Returns how far, in logical pixels, the blur and the shadow of the image
+// spread around it.
+static GtkBorder get_image_effect_margins() {
+  const gint16 blur = (gint16)splash_blur_get_extent(
+      get_blur_sigma(SplashConfig::image_blur_radius()));
+  GtkBorder margins = {blur, blur, blur, blur};
+  if (has_image_shadow()) {
+    const int spread = splash_blur_get_extent(
+        get_blur_sigma(SplashConfig::image_shadow_radius()));
+    const int offset_x = SplashConfig::image_shadow_offset_x();
+    const int offset_y = SplashConfig::image_shadow_offset_y();
+    margins.left = (gint16)MAX(margins.left, spread - offset_x);
+    margins.right = (gint16)MAX(margins.right, spread + offset_x);
+    margins.top = (gint16)MAX(margins.top, spread - offset_y);
+    margins.bottom = (gint16)MAX(margins.bottom, spread + offset_y);
+  }
+  return margins;
+}
+
+// Draws |image|, blurred, over its drop shadow into a new surface padded by
+// the margins of the effects, with the same device scale. Everything is
+// computed in device pixels, once, like the embedded pixels used to be.
+// Returns nullptr on failure.
+static cairo_surface_t* create_image_effects_surface(cairo_surface_t* image) {
+  const gint64 start = g_get_monotonic_time();
+
+  double scale_x, scale_y;
+  cairo_surface_get_device_scale(image, &scale_x, &scale_y);
+  const GtkBorder margins = get_image_effect_margins();
+  const int left = (int)lround(margins.left * scale_x);
+  const int top = (int)lround(margins.top * scale_y);
+  const int width = cairo_image_surface_get_width(image);
+  const int height = cairo_image_surface_get_height(image);
+  const int padded_width = width + left + (int)lround(margins.right * scale_x);
+  const int padded_height =
+      height + top + (int)lround(margins.bottom * scale_y);
+
+  cairo_surface_t* surface = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, padded_width, padded_height);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    return nullptr;
+  }
+
+  // Same pixels, without the device scale, so nothing gets resampled
+  cairo_surface_flush(image);
+  unsigned char* pixels = cairo_image_surface_get_data(image);
+  const int stride = cairo_image_surface_get_stride(image);
+  cairo_surface_t* source = cairo_image_surface_create_for_data(
+      pixels, CAIRO_FORMAT_ARGB32, width, height, stride);
+
+  cairo_t* cr = cairo_create(surface);
+  cairo_set_source_surface(cr, source, left, top);
+  cairo_paint(cr);
+
+  const double blur_sigma =
+      get_blur_sigma(SplashConfig::image_blur_radius()) * scale_x;
+  if (blur_sigma > 0) {
+    cairo_surface_flush(surface);
+    if (!splash_blur(cairo_image_surface_get_data(surface), padded_width,
+                     padded_height, cairo_image_surface_get_stride(surface),
+                     4, blur_sigma)) {
+      g_warning("Failed to blur the splash image");
+    }
+    cairo_surface_mark_dirty(surface);
+  }
+
+  // The shadow is the alpha of the image, offset and blurred, slid under it
+  cairo_surface_t* mask = has_image_shadow()
+                              ? cairo_image_surface_create(
+                                    CAIRO_FORMAT_A8, padded_width,
+                                    padded_height)
+                              : nullptr;
+  unsigned char* mask_data =
+      mask != nullptr ? cairo_image_surface_get_data(mask) : nullptr;
+  if (mask_data != nullptr) {
+    const int mask_stride = cairo_image_surface_get_stride(mask);
+    const int mask_x =
+        left + (int)lround(SplashConfig::image_shadow_offset_x() * scale_x);
+    const int mask_y =
+        top + (int)lround(SplashConfig::image_shadow_offset_y() * scale_y);
+
+    cairo_surface_flush(mask);
+    for (int y = 0; y < height; y++) {
+      const uint32_t* row =
+          reinterpret_cast<const uint32_t*>(pixels + (size_t)y * stride);
+      unsigned char* out =
+          mask_data + (size_t)(mask_y + y) * mask_stride + mask_x;
+      for (int x = 0; x < width; x++) {
+        out[x] = row[x] >> 24;
+      }
+    }
+    const double shadow_sigma =
+        get_blur_sigma(SplashConfig::image_shadow_radius()) * scale_x;
+    if (!splash_blur(mask_data, padded_width, padded_height, mask_stride, 1,
+                     shadow_sigma)) {
+      g_warning("Failed to blur the splash image shadow");
+    }
+    cairo_surface_mark_dirty(mask);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_DEST_OVER);
+    set_source_argb(cr, SplashConfig::image_shadow_color());
+    cairo_mask_surface(cr, mask, 0, 0);
+  }
+  if (mask != nullptr) {
+    cairo_surface_destroy(mask);
+  }
+
+  cairo_destroy(cr);
+  cairo_surface_destroy(source);
+
+  cairo_surface_set_device_scale(surface, scale_x, scale_y);
+  splash_image_margin_x = left / scale_x;
+  splash_image_margin_y = top / scale_y;
+
+  splash_metrics_record("image_effects_us", g_get_monotonic_time() - start);
+  return surface;
+}
+
+// Replaces |surface| with its blurred and shadowed version when the
+// configuration asks for any. Keeps the sharp image if that fails.
+static cairo_surface_t* apply_image_effects(cairo_surface_t* surface) {
+  splash_image_margin_x = 0;
+  splash_image_margin_y = 0;
+  if (SplashConfig::image_blur_radius() <= 0 && !has_image_shadow()) {
+    return surface;
+  }
+
+  cairo_surface_t* effects = create_image_effects_surface(surface);
+  if (effects == nullptr) {
+    g_warning("Failed to draw the splash image effects");
+    return surface;
+  }
+  cairo_surface_destroy(surface);
+  return effects;
+}
+
+// Decodes the splash image and maps its pixels to logical units.
+//
+// When no variant matches the scale of the display, the closest one is
+// resampled once to the display resolution, so cairo never has to filter it
+// when painting. The blur and the shadow are drawn at that resolution.
+static cairo_surface_t* create_scaled_image_surface() {
+  cairo_surface_t* surface = create_image_surface();
+  if (surface == nullptr) {
+    return nullptr;
+  }
+
+  const int scale = MAX(splash_image.scale, 1);
+  if (scale != splash_display_scale) {
+    cairo_surface_t* resampled =
+        resample_image_surface(surface, scale, splash_display_scale);
+    if (resampled != nullptr) {
+      cairo_surface_destroy(surface);
+      return apply_image_effects(resampled);
+    }
+  }
+
+  if (scale > 1) {
+    cairo_surface_set_device_scale(surface, scale, scale);
+  }
+  return apply_image_effects(surface);
+}
+
+// Paints the decoded splash image into the layer.
+static void paint_image_layer(cairo_t* cr,
+                              int width,
+                              int height,
+                              gpointer user_data) {
+  if (splash_image_surface == nullptr) {
+    splash_image_surface = create_scaled_image_surface();
+  }
+  if (splash_image_surface == nullptr) {
+    return;
+  }
+
+  cairo_set_source_surface(cr, splash_image_surface,
+                           splash_image_x - splash_image_margin_x,
+                           splash_image_y - splash_image_margin_y);
+  cairo_paint(cr);
+}
+
+// Copies a composed splash, |user_data|, into the layer. Nothing is blended,
+// the composition already covers the whole window.
+static void paint_surface_layer(cairo_t* cr,
+                                int width,
+                                int height,
+                                gpointer user_data) {
+  cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_surface(cr, static_cast<cairo_surface_t*>(user_data), 0,
+                           0);
+  cairo_paint(cr);
+}
+
+// Composes |scene| once onto the window color into an opaque surface at
+// |scale|, and returns a scene made of that surface only. Frees |scene|.
+static SplashScene* flatten_splash_scene(SplashScene* scene, int scale) {
+  const int width = SplashConfig::width();
+  const int height = SplashConfig::height();
+
+  cairo_surface_t* surface = cairo_image_surface_create(
+      CAIRO_FORMAT_RGB24, width * scale, height * scale);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    return scene;
+  }
+  cairo_surface_set_device_scale(surface, scale, scale);
+
+  cairo_t* cr = cairo_create(surface);
+  splash_scene_draw(scene, cr);
+  cairo_destroy(cr);
+  splash_scene_free(scene);
+
+  // The decoded image is recreated if the scene ever has to be rebuilt
+  if (splash_image_surface != nullptr) {
+    cairo_surface_destroy(splash_image_surface);
+    splash_image_surface = nullptr;
+  }
+
+  SplashScene* flat = splash_scene_new(width, height);
+  cairo_rectangle_int_t bounds = {0, 0, width, height};
+
+  SplashLayer* layer = splash_scene_add_layer(
+      flat, "flat", &bounds, paint_surface_layer, surface,
+      reinterpret_cast<GDestroyNotify>(cairo_surface_destroy));
+  splash_layer_set_cached(layer, FALSE);
+  return flat;
+}
+
+// Returns the area the content is centered in: the background rectangle,
+// which is itself centered in the window, or the whole window.
+static cairo_rectangle_int_t get_content_anchor() {
+  cairo_rectangle_int_t anchor = {0, 0, SplashConfig::width(),
+                                  SplashConfig::height()};
+  if (has_background_rect()) {
+    anchor.width = SplashConfig::background_rect_width();
+    anchor.height = SplashConfig::background_rect_height();
+    anchor.x = (SplashConfig::width() - anchor.width) / 2;
+    anchor.y = (SplashConfig::height() - anchor.height) / 2;
+  }
+  return anchor;
+}
+
+// Builds the layers of the splash that never change while it is shown.
+static SplashScene* create_static_splash_scene(GdkScreen* screen) {
+  SplashScene* scene =
+      splash_scene_new(SplashConfig::width(), SplashConfig::height());
+
+  // The cached composition replaces the static layers
+  if (splash_cached_surface != nullptr) {
+    cairo_rectangle_int_t bounds = {0, 0, SplashConfig::width(),
+                                    SplashConfig::height()};
+    SplashLayer* cache_layer =
+        splash_scene_add_layer(scene, "cache", &bounds, paint_surface_layer,
+                               splash_cached_surface, nullptr);
+    splash_layer_set_cached(cache_layer, FALSE);
+    return scene;
+  }
+
+  // Only fill background if compositing is NOT supported
+  cairo_rectangle_int_t window_bounds = {0, 0, SplashConfig::width(),
+                                         SplashConfig::height()};
+  SplashLayer* window_layer =
+      splash_scene_add_layer(scene, "window", &window_bounds,
+                             paint_window_color_layer, nullptr, nullptr);
+  splash_layer_set_cached(window_layer, FALSE);
+  splash_layer_set_visible(window_layer, !gdk_screen_is_composited(screen));
+
+  // The image is centered in the background rectangle, which is itself
+  // centered in the window
+  const cairo_rectangle_int_t anchor = get_content_anchor();
+  if (has_background_rect()) {
+    splash_scene_add_layer(scene, "background", &anchor,
+                           paint_background_layer, nullptr, nullptr);
+  }
+
+  // Draw the image if available
+  if (splash_image.pixels != nullptr && splash_image.width > 0 &&
+      splash_image.height > 0) {
+    // Center the untrimmed canvas, then place the image inside of it. The
+    // image is measured in device pixels, position it on whole ones
+    const int scale = MAX(splash_image.scale, 1);
+    int canvas_width = splash_image.canvas_width > 0 ? splash_image.canvas_width
+                                                     : splash_image.width;
+    int canvas_height = splash_image.canvas_height > 0
+                            ? splash_image.canvas_height
+                            : splash_image.height;
+    const double image_x = (anchor.x * scale +
+                      (anchor.width * scale - canvas_width) / 2 +
+                      splash_image.offset_x) /
+                     (double)scale;
+    const double image_y = (anchor.y * scale +
+                      (anchor.height * scale - canvas_height) / 2 +
+                      splash_image.offset_y) /
+                     (double)scale;
+
+    // A resampled image is placed on whole pixels of the display instead
+    const double x = round(image_x * splash_display_scale) /
+                     splash_display_scale;
+    const double y = round(image_y * splash_display_scale) /
+                     splash_display_scale;
+
+    // The layer covers whole logical pixels, the image is offset inside,
+    // with room for its blur and shadow around
+    const GtkBorder margins = get_image_effect_margins();
+    cairo_rectangle_int_t image_bounds;
+    image_bounds.x = (int)floor(x) - margins.left;
+    image_bounds.y = (int)floor(y) - margins.top;
+    image_bounds.width = (int)ceil(x + splash_image.width / (double)scale) +
+                         margins.right - image_bounds.x;
+    image_bounds.height = (int)ceil(y + splash_image.height / (double)scale) +
+                          margins.bottom - image_bounds.y;
+    splash_image_x = x - image_bounds.x;
+    splash_image_y = y - image_bounds.y;
+
+    // The decoded image surface already acts as the layer cache
+    SplashLayer* image_layer = splash_scene_add_layer(
+        scene, "image", &image_bounds, paint_image_layer, nullptr, nullptr);
+    splash_layer_set_cached(image_layer, FALSE);
+  }
+
+  // Without a compositor the window has no alpha, blend the layers once so
+  // every expose is a plain copy
+  if (!gdk_screen_is_composited(screen)) {
+    return flatten_splash_scene(scene, splash_display_scale);
+  }
+
+  return scene;
+}
+
+// Returns the scale factor of the monitor the splash is centered on.
+static int get_splash_scale(GdkScreen* screen) {
+  GdkDisplay* display = gdk_screen_get_display(screen);
+  GdkMonitor* monitor = gdk_display_get_primary_monitor(display);
+  if (monitor == nullptr) {
+    monitor = gdk_display_get_monitor(display, 0);
+  }
+  return monitor != nullptr ? gdk_monitor_get_scale_factor(monitor) : 1;
+}
+
+// Paints the current frame of the animation into the layer. When nothing
+// else changed, the clip only holds the dirty rectangle of the frame.
+static void paint_animation_layer(cairo_t* cr,
+                                  int width,
+                                  int height,
+                                  gpointer user_data) {
+  cairo_set_source_surface(cr, splash_animation_surface, 0, 0);
+  cairo_paint(cr);
+}
+
+// Parses the embedded animation and decodes its first frame, once per run.
+// The frame surface is the only memory the animation takes when playing.
+static gboolean load_splash_animation() {
+  if (splash_animation_surface != nullptr) {
+    return TRUE;
+  }
+  if (SplashConfig::animation_size() == 0 ||
+      native_splash_screen_animation == nullptr) {
+    return FALSE;
+  }
+
+  const gint64 start = g_get_monotonic_time();
+  g_autoptr(GError) error = nullptr;
+  splash_animation = splash_animation_new_from_data(
+      native_splash_screen_animation, SplashConfig::animation_size(), &error);
+  if (splash_animation == nullptr) {
+    g_warning("Failed to load the splash animation: %s", error->message);
+    return FALSE;
+  }
+
+  splash_animation_surface = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, splash_animation_get_width(splash_animation),
+      splash_animation_get_height(splash_animation));
+  cairo_rectangle_int_t dirty;
+  if (cairo_surface_status(splash_animation_surface) != CAIRO_STATUS_SUCCESS ||
+      !splash_animation_decode_frame(splash_animation, 0,
+                                     splash_animation_surface, &dirty,
+                                     &error)) {
+    g_warning("Failed to decode the splash animation: %s",
+              error != nullptr ? error->message : "out of memory");
+    g_clear_pointer(&splash_animation_surface, cairo_surface_destroy);
+    g_clear_pointer(&splash_animation, splash_animation_free);
+    return FALSE;
+  }
+  splash_animation_frame = 0;
+
+  splash_metrics_record("animation_frames",
+                        splash_animation_get_frame_count(splash_animation));
+  splash_metrics_record("animation_decode_us",
+                        g_get_monotonic_time() - start);
+  return TRUE;
+}
+
+// Adds the animation on top of |scene|, centered in the background rectangle
+// like the image canvas. The frame surface acts as the layer cache, so only
+// the dirty rectangles of the frames get repainted.
+static void add_animation_layer(SplashScene* scene) {
+  if (!load_splash_animation()) {
+    return;
+  }
+
+  const cairo_rectangle_int_t anchor = get_content_anchor();
+  cairo_rectangle_int_t bounds;
+  bounds.width = splash_animation_get_width(splash_animation);
+  bounds.height = splash_animation_get_height(splash_animation);
+  bounds.x = anchor.x + (anchor.width - bounds.width) / 2;
+  bounds.y = anchor.y + (anchor.height - bounds.height) / 2;
+
+  SplashLayer* layer = splash_scene_add_layer(
+      scene, "animation", &bounds, paint_animation_layer, nullptr, nullptr);
+  splash_layer_set_cached(layer, FALSE);
+}
+
+// Blits the current frame of the spinner atlas into the layer.
+static void paint_spinner_layer(cairo_t* cr,
+                                int width,
+                                int height,
+                                gpointer user_data) {
+  splash_spinner_paint_frame(splash_spinner, cr, splash_spinner_frame);
+}
+
+// Adds the loading spinner on top of |scene|, drawing its pre-rotated
+// frames once for the scale of the display.
+static void add_spinner_layer(SplashScene* scene, GdkScreen* screen) {
+  if (SplashConfig::spinner_size() <= 0) {
+    return;
+  }
+
+  if (splash_spinner == nullptr) {
+    const gint64 start = g_get_monotonic_time();
+    splash_spinner = splash_spinner_new(
+        SplashConfig::spinner_size(), SplashConfig::spinner_color(),
+        SplashConfig::spinner_frames(), get_splash_scale(screen));
+    if (splash_spinner == nullptr) {
+      g_warning("Failed to draw the splash spinner");
+      return;
+    }
+    splash_metrics_record("spinner_atlas_us", g_get_monotonic_time() - start);
+  }
+
+  const cairo_rectangle_int_t anchor = get_content_anchor();
+  const int size = SplashConfig::spinner_size();
+  cairo_rectangle_int_t bounds = {
+      anchor.x + (anchor.width - size) / 2,
+      anchor.y + (anchor.height - size) / 2 + SplashConfig::spinner_offset_y(),
+      size, size};
+
+  // The atlas acts as the layer cache
+  SplashLayer* layer = splash_scene_add_layer(
+      scene, "spinner", &bounds, paint_spinner_layer, nullptr, nullptr);
+  splash_layer_set_cached(layer, FALSE);
+}
+
+// Builds the retained scene drawn by the splash window: the static layers,
+// composed or flattened as needed, with the animation and the spinner
+// played over them.
+static SplashScene* create_splash_scene(GdkScreen* screen) {
+  SplashScene* scene = create_static_splash_scene(screen);
+  add_animation_layer(scene);
+  add_spinner_layer(scene, screen);
+  return scene;
+}
+
+// Maps the splash composed by a previous launch, if its key still matches.
+//
+// Only embedded images are cached: their hash is known without reading them,
+// and an asset file is already mapped without any decoding.
+static void load_splash_cache(GdkScreen* screen) {
+  if (SplashConfig::asset_hash() == 0 ||
+      SplashConfig::image_asset() != nullptr) {
+    return;
+  }
+
+  const int scale = get_splash_scale(screen);
+  splash_cache_key =
+      splash_cache_make_key(SplashConfig::asset_hash(), scale,
+                            gdk_screen_is_composited(screen),
+                            splash_dark_theme);
+  splash_cache_path = splash_cache_get_path(splash_cache_key);
+  if (splash_cache_path == nullptr) {
+    return;
+  }
+
+  splash_cached_surface = splash_cache_load(
+      splash_cache_path, splash_cache_key, SplashConfig::width(),
+      SplashConfig::height(), scale);
+  splash_metrics_record("cache_hit", splash_cached_surface != nullptr);
+}
+
+// Shows or hides the layers that change while the splash is shown.
+static void set_moving_layers_visible(gboolean visible) {
+  static const char* const kMovingLayers[] = {"animation", "spinner"};
+  for (const char* name : kMovingLayers) {
+    SplashLayer* layer = splash_scene_get_layer(splash_scene, name);
+    if (layer != nullptr) {
+      splash_layer_set_visible(layer, visible);
+    }
+  }
+}
+
+// Writes the composed splash for the next launches, once it is on screen.
+static gboolean store_splash_cache(gpointer user_data) {
+  if (splash_scene == nullptr || splash_cache_path == nullptr) {
+    return G_SOURCE_REMOVE;
+  }
+
+  // Compose at the resolution of the display
+  const int scale = splash_display_scale;
+  cairo_surface_t* surface = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, SplashConfig::width() * scale,
+      SplashConfig::height() * scale);
+  cairo_surface_set_device_scale(surface, scale, scale);
+  // The animation and the spinner keep playing over the cached composition
+  set_moving_layers_visible(FALSE);
+  cairo_t* cr = cairo_create(surface);
+  splash_scene_draw(splash_scene, cr);
+  cairo_destroy(cr);
+  set_moving_layers_visible(TRUE);
+
+  g_autoptr(GError) error = nullptr;
+  if (!splash_cache_store(splash_cache_path, splash_cache_key, surface,
+                          &error)) {
+    g_warning("Failed to write the splash cache: %s", error->message);
+  }
+  cairo_surface_destroy(surface);
+  return G_SOURCE_REMOVE;
+}
+
+// Cuts the window to the shape of the splash when the screen can not show
+// its transparent parts, and restores the full window otherwise. The slide
+// margin is always cut off.
+static void update_window_shape(GdkScreen* screen) {
+  if (splash_window == nullptr ||
+      (SplashConfig::shape_rect_count() <= 0 && splash_slide_margin == 0)) {
+    return;
+  }
+
+  if (gdk_screen_is_composited(screen)) {
+    gtk_widget_shape_combine_region(splash_window, nullptr);
+    return;
+  }
+
+  cairo_region_t* shape = cairo_region_create();
+  for (int i = 0; i < SplashConfig::shape_rect_count(); i++) {
+    const int* values = native_splash_screen_shape_rects + i * 4;
+    cairo_rectangle_int_t rect = {values[0], values[1] + splash_slide_margin,
+                                  values[2], values[3]};
+    cairo_region_union_rectangle(shape, &rect);
+  }
+  if (SplashConfig::shape_rect_count() <= 0) {
+    cairo_rectangle_int_t rect = {0, splash_slide_margin, SplashConfig::width(),
+                                  SplashConfig::height()};
+    cairo_region_union_rectangle(shape, &rect);
+  }
+  gtk_widget_shape_combine_region(splash_window, shape);
+  cairo_region_destroy(shape);
+}
+
+// Rebuilds the scene when a compositor starts or stops, the window color is
+// only painted without one.
+static void on_composited_changed(GdkScreen* screen, gpointer user_data) {
+  update_window_shape(screen);
+
+  if (splash_scene == nullptr) {
+    return;
+  }
+
+  splash_scene_free(splash_scene);
+  splash_scene = nullptr;
+
+  // The cached composition was made for the previous state
+  if (splash_cached_surface != nullptr) {
+    cairo_surface_destroy(splash_cached_surface);
+    splash_cached_surface = nullptr;
+    load_splash_image(get_splash_scale(screen));
+  }
+
+  splash_scene = create_splash_scene(screen);
+  if (splash_drawing_area != nullptr) {
+    gtk_widget_queue_draw(splash_drawing_area);
+  }
+}
+
+// Repaints the damaged parts of the scene, if any.
+static void queue_scene_damage() {
+  if (splash_scene == nullptr || splash_drawing_area == nullptr ||
+      !splash_scene_has_damage(splash_scene)) {
+    return;
+  }
+
+  cairo_region_t* damage = splash_scene_take_damage(splash_scene);
+  cairo_region_translate(damage, 0, splash_slide_margin);
+  gtk_widget_queue_draw_region(splash_drawing_area, damage);
+  cairo_region_destroy(damage);
+}
+
+// Advances the animation on the frame clock. Every frame that is due is
+// inflated in turn into the frame surface, each one applying to the frame
+// before it, and only their dirty rectangles are repainted.
+static gboolean on_animation_tick(GtkWidget* widget,
+                                  GdkFrameClock* frame_clock,
+                                  gpointer user_data) {
+  SplashLayer* layer = splash_scene != nullptr
+                           ? splash_scene_get_layer(splash_scene, "animation")
+                           : nullptr;
+  if (layer == nullptr) {
+    splash_animation_tick_id = 0;
+    return G_SOURCE_REMOVE;
+  }
+
+  const gint64 now = gdk_frame_clock_get_frame_time(frame_clock);
+  if (splash_animation_next_time == 0) {
+    splash_animation_next_time =
+        now + splash_animation_get_frame_duration(splash_animation,
+                                                  splash_animation_frame) *
+                  G_GINT64_CONSTANT(1000);
+    return G_SOURCE_CONTINUE;
+  }
+
+  const int count = splash_animation_get_frame_count(splash_animation);
+  for (int decoded = 0; now >= splash_animation_next_time; decoded++) {
+    // After a stall, e.g. while the engine starts, restart the timing rather
+    // than decoding more than a whole loop at once
+    if (decoded == count) {
+      splash_animation_next_time = now;
+      break;
+    }
+
+    int next = splash_animation_frame + 1;
+    if (next == count) {
+      const int loop_count = splash_animation_get_loop_count(splash_animation);
+      if (loop_count > 0 && ++splash_animation_loops >= loop_count) {
+        splash_animation_tick_id = 0;
+        return G_SOURCE_REMOVE;
+      }
+      next = 0;
+    }
+
+    g_autoptr(GError) error = nullptr;
+    cairo_rectangle_int_t dirty;
+    if (!splash_animation_decode_frame(splash_animation, next,
+                                       splash_animation_surface, &dirty,
+                                       &error)) {
+      g_warning("Failed to decode a splash animation frame: %s",
+                error->message);
+      splash_animation_tick_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+    splash_layer_invalidate_rect(layer, &dirty);
+
+    splash_animation_frame = next;
+    splash_animation_next_time +=
+        splash_animation_get_frame_duration(splash_animation, next) *
+        G_GINT64_CONSTANT(1000);
+  }
+
+  queue_scene_damage();
+  return G_SOURCE_CONTINUE;
+}
+
+// Turns the spinner on the frame clock. The frame only depends on the time,
+// so a stalled main loop skips frames instead of slowing the spinner down,
+// and only its small square is repainted when the frame changes.
+static gboolean on_spinner_tick(GtkWidget* widget,
+                                GdkFrameClock* frame_clock,
+                                gpointer user_data) {
+  SplashLayer* layer = splash_scene != nullptr
+                           ? splash_scene_get_layer(splash_scene, "spinner")
+                           : nullptr;
+  if (layer == nullptr) {
+    return G_SOURCE_REMOVE;
+  }
+
+  const gint64 now = gdk_frame_clock_get_frame_time(frame_clock);
+  if (splash_spinner_start_time == 0) {
+    splash_spinner_start_time = now;
+  }
+
+  const gint64 period =
+      SplashConfig::spinner_period() * G_GINT64_CONSTANT(1000);
+  const int count = splash_spinner_get_frame_count(splash_spinner);
+  const int frame =
+      (int)((now - splash_spinner_start_time) % period * count / period);
+  if (frame != splash_spinner_frame) {
+    splash_spinner_frame = frame;
+    splash_layer_invalidate(layer);
+    queue_scene_damage();
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+// Compositor cost of the RGBA and of the system visual, measured when the
+// NATIVE_SPLASH_SCREEN_VISUAL_BENCHMARK environment variable holds a number
+// of frames. The whole window is repainted on every frame, first with the
+// visual the splash picked and then with the other one, and the presentation
+// timings the compositor reports for each are recorded as metrics.
+struct VisualBenchmark {
+  int frames;                  // Frames to present with each visual
+  int visuals;                 // Visuals measured so far
+  gboolean rgba;               // Whether the window has the RGBA visual
+  int ticks;                   // Frames drawn with the current visual
+  gint64 counter;              // Next frame whose timings are read
+  int presented;               // Frames presented with the current visual
+  gint64 latency;              // Sum of the frame start to presentation times
+  gint64 first_presentation;   // Presentation time of the first frame
+  gint64 last_presentation;    // Presentation time of the last frame
+};
+static VisualBenchmark visual_benchmark;
+
+static gboolean on_visual_benchmark_tick(GtkWidget* widget,
+                                         GdkFrameClock* frame_clock,
+                                         gpointer user_data);
+
+// Records the timings of the visual that was just measured.
+static void record_visual_benchmark() {
+  const VisualBenchmark* benchmark = &visual_benchmark;
+  const char* visual = benchmark->rgba ? "rgba" : "system";
+
+  g_autofree gchar* frames =
+      g_strdup_printf("visual_benchmark_%s_frames", visual);
+  splash_metrics_record(frames, benchmark->presented);
+  if (benchmark->presented == 0) {
+    g_warning("No presentation time was reported for the %s visual", visual);
+    return;
+  }
+
+  g_autofree gchar* latency =
+      g_strdup_printf("visual_benchmark_%s_latency_us", visual);
+  splash_metrics_record(latency, benchmark->latency / benchmark->presented);
+  if (benchmark->presented > 1) {
+    g_autofree gchar* interval =
+        g_strdup_printf("visual_benchmark_%s_interval_us", visual);
+    splash_metrics_record(interval, (benchmark->last_presentation -
+                                     benchmark->first_presentation) /
+                                        (benchmark->presented - 1));
+  }
+}
+
+// Starts measuring the current visual of the window.
+static void start_visual_benchmark_run(gboolean rgba) {
+  const int frames = visual_benchmark.frames;
+  const int visuals = visual_benchmark.visuals;
+  memset(&visual_benchmark, 0, sizeof(visual_benchmark));
+  visual_benchmark.frames = frames;
+  visual_benchmark.visuals = visuals;
+  visual_benchmark.rgba = rgba;
+
+  gtk_widget_add_tick_callback(splash_drawing_area, on_visual_benchmark_tick,
+                               nullptr, nullptr);
+}
+
+// Gives the window the visual that was not measured yet. A window only takes
+// a visual before it is realized, so it is shown again.
+static gboolean switch_benchmark_visual(gpointer user_data) {
+  if (splash_window == nullptr || splash_drawing_area == nullptr) {
+    return G_SOURCE_REMOVE;
+  }
+
+  GdkScreen* screen = gtk_widget_get_screen(splash_window);
+  const gboolean rgba = !visual_benchmark.rgba;
+  gtk_widget_hide(splash_window);
+  gtk_widget_unrealize(splash_window);
+  gtk_widget_set_visual(splash_window,
+                        rgba ? gdk_screen_get_rgba_visual(screen)
+                             : gdk_screen_get_system_visual(screen));
+  gtk_widget_show(splash_window);
+
+  start_visual_benchmark_run(rgba);
+  return G_SOURCE_REMOVE;
+}
+
+// Repaints the whole window on every frame and reads the presentation times
+// of the frames the compositor reported since the previous one.
+static gboolean on_visual_benchmark_tick(GtkWidget* widget,
+                                         GdkFrameClock* frame_clock,
+                                         gpointer user_data) {
+  VisualBenchmark* benchmark = &visual_benchmark;
+  const gint64 current = gdk_frame_clock_get_frame_counter(frame_clock);
+  if (benchmark->ticks++ == 0) {
+    benchmark->counter = current;
+  }
+
+  // Frames older than the history of the clock are not measured
+  benchmark->counter = MAX(benchmark->counter,
+                           gdk_frame_clock_get_history_start(frame_clock));
+  for (; benchmark->counter < current &&
+         benchmark->presented < benchmark->frames;
+       benchmark->counter++) {
+    GdkFrameTimings* timings =
+        gdk_frame_clock_get_timings(frame_clock, benchmark->counter);
+    if (timings == nullptr || !gdk_frame_timings_get_complete(timings)) {
+      break;
+    }
+
+    const gint64 presentation =
+        gdk_frame_timings_get_presentation_time(timings);
+    if (presentation == 0) {
+      continue;
+    }
+    if (benchmark->presented == 0) {
+      benchmark->first_presentation = presentation;
+    }
+    benchmark->last_presentation = presentation;
+    benchmark->latency +=
+        presentation - gdk_frame_timings_get_frame_time(timings);
+    benchmark->presented++;
+  }
+
+  // Compositors that report no presentation time get twice as many frames
+  if (benchmark->presented < benchmark->frames &&
+      benchmark->ticks < benchmark->frames * 2) {
+    gtk_widget_queue_draw(widget);
+    return G_SOURCE_CONTINUE;
+  }
+
+  record_visual_benchmark();
+  if (++benchmark->visuals < 2) {
+    g_idle_add(switch_benchmark_visual, nullptr);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// Starts the visual benchmark when it is requested. The system visual only
+// skips blending on a compositing screen, where |rgba| tells which visual
+// the window was given.
+static void start_visual_benchmark(gboolean composited, gboolean rgba) {
+  const gchar* variable = g_getenv("NATIVE_SPLASH_SCREEN_VISUAL_BENCHMARK");
+  const gint64 frames =
+      variable != nullptr ? g_ascii_strtoll(variable, nullptr, 10) : 0;
+  if (frames <= 0) {
+    return;
+  }
+  if (!composited) {
+    g_warning("The visual benchmark needs a compositing screen");
+    return;
+  }
+
+  memset(&visual_benchmark, 0, sizeof(visual_benchmark));
+  visual_benchmark.frames = (int)MIN(frames, G_MAXINT / 2);
+  start_visual_benchmark_run(rgba);
+}
+
+#ifndef NATIVE_SPLASH_SCREEN_CONFIG_HEADER
+// Returns the name of the flavor requested for this run, if any: the
+// `--splash-flavor=<name>` command-line flag, then the
+// NATIVE_SPLASH_SCREEN_FLAVOR environment variable, then the last component
+// of the application ID, e.g. `meeting` for `com.example.app.meeting`.
+// |from_id| tells whether the name only comes from the application ID.
+static gchar* get_requested_flavor(gboolean* from_id) {
+  *from_id = FALSE;
+
+  // The runner shows the splash before it parses its arguments
+  g_autofree gchar* cmdline = nullptr;
+  gsize length = 0;
+  if (g_file_get_contents("/proc/self/cmdline", &cmdline, &length, nullptr)) {
+    static const char kFlag[] = "--splash-flavor=";
+    for (gsize i = 0; i < length; i += strlen(cmdline + i) + 1) {
+      if (g_str_has_prefix(cmdline + i, kFlag)) {
+        return g_strdup(cmdline + i + strlen(kFlag));
+      }
+    }
+  }
+
+  const gchar* variable = g_getenv("NATIVE_SPLASH_SCREEN_FLAVOR");
+  if (variable != nullptr && variable[0] != '\0') {
+    return g_strdup(variable);
+  }
+
+  // The runner shows the splash before it creates its application, the ID
+  // is then only known if main() set it as the program name first. Until
+  // then the program name is the binary name, which is not an ID
+  GApplication* application = g_application_get_default();
+  const gchar* id = application != nullptr
+                        ? g_application_get_application_id(application)
+                        : g_get_prgname();
+  if (id == nullptr || !g_application_id_is_valid(id)) {
+    return nullptr;
+  }
+  *from_id = TRUE;
+  return g_strdup(strrchr(id, '.') + 1);
+}
+
+// Switches the settings to the embedded flavor requested for this run. The
+// image of the build configuration is then left alone, the one of the
+// flavor is decoded from its compressed variants when the splash is drawn.
+static void select_splash_flavor() {
+  if (native_splash_screen_flavor_count <= 0) {
+    return;
+  }
+
+  gboolean from_id;
+  g_autofree gchar* name = get_requested_flavor(&from_id);
+  if (name == nullptr) {
+    return;
+  }
+
+  for (int i = 0; i < native_splash_screen_flavor_count; i++) {
+    const NativeSplashScreenFlavor* flavor = &native_splash_screen_flavors[i];
+    if (strcmp(flavor->name, name) != 0) {
+      continue;
+    }
+
+    native_splash_screen_width = flavor->width;
+    native_splash_screen_height = flavor->height;
+    native_splash_screen_title = flavor->title;
+    native_splash_screen_with_animation = flavor->with_animation;
+    native_splash_screen_background_color = flavor->background_color;
+    native_splash_screen_background_rect_color = flavor->background_rect_color;
+    native_splash_screen_background_rect_width = flavor->background_rect_width;
+    native_splash_screen_background_rect_height =
+        flavor->background_rect_height;
+    native_splash_screen_background_rect_radius =
+        flavor->background_rect_radius;
+    native_splash_screen_background_gradient = flavor->background_gradient;
+    native_splash_screen_background_gradient_color =
+        flavor->background_gradient_color;
+    native_splash_screen_background_gradient_angle =
+        flavor->background_gradient_angle;
+    native_splash_screen_spinner_size = flavor->spinner_size;
+    native_splash_screen_spinner_color = flavor->spinner_color;
+    native_splash_screen_spinner_offset_y = flavor->spinner_offset_y;
+    native_splash_screen_spinner_period = flavor->spinner_period;
+    native_splash_screen_spinner_frames = flavor->spinner_frames;
+    native_splash_screen_image_blur_radius = flavor->image_blur_radius;
+    native_splash_screen_image_shadow_color = flavor->image_shadow_color;
+    native_splash_screen_image_shadow_radius = flavor->image_shadow_radius;
+    native_splash_screen_image_shadow_offset_x = flavor->image_shadow_offset_x;
+    native_splash_screen_image_shadow_offset_y = flavor->image_shadow_offset_y;
+    native_splash_screen_opaque = flavor->opaque;
+    native_splash_screen_shape_rect_count = flavor->shape_rect_count;
+    native_splash_screen_shape_rects = flavor->shape_rects;
+    native_splash_screen_image_variant_count = flavor->image_variant_count;
+    native_splash_screen_image_variant_scales = flavor->image_variant_scales;
+    native_splash_screen_image_variants = flavor->image_variants;
+    native_splash_screen_image_variant_sizes = flavor->image_variant_sizes;
+    native_splash_screen_image_dark_variant_count =
+        flavor->image_dark_variant_count;
+    native_splash_screen_image_dark_variant_scales =
+        flavor->image_dark_variant_scales;
+    native_splash_screen_image_dark_variants = flavor->image_dark_variants;
+    native_splash_screen_image_dark_variant_sizes =
+        flavor->image_dark_variant_sizes;
+    native_splash_screen_animation = flavor->animation;
+    native_splash_screen_animation_size = flavor->animation_size;
+    native_splash_screen_asset_hash = flavor->asset_hash;
+    native_splash_screen_image_asset = nullptr;
+    native_splash_screen_image_pixels = nullptr;
+
+    splash_metrics_record("flavor_index", i);
+    return;
+  }
+  // Most application IDs do not end with a flavor
+  if (!from_id) {
+    g_warning("Unknown splash flavor %s, showing the default one", name);
+  }
+}
+#endif
+
 // Function to create and show the splash screen
 void show_splash_screen() {
   if (splash_shown) {
     return;  // Prevent showing multiple splash screens
   }
 
+#ifndef NATIVE_SPLASH_SCREEN_CONFIG_HEADER
+  select_splash_flavor();
+#endif
+
+  // Start reading the pixels from disk while GTK initializes, so the first
+  // draw does not fault them in page by page
+  advise_embedded_pixels(MADV_WILLNEED);
+
   // Make sure GTK is initialized
   if (!gtk_init_check(nullptr, nullptr)) {
     g_warning("Failed to initialize GTK, cannot show splash screen");
@@ -147,7 +1730,7 @@ void show_splash_screen() {
 
   // Create the splash window
   splash_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-  gtk_window_set_title(GTK_WINDOW(splash_window), native_splash_screen_title);
+  gtk_window_set_title(GTK_WINDOW(splash_window), SplashConfig::title());
 
   // Make it behave like a splash screen
   gtk_window_set_decorated(GTK_WINDOW(splash_window),
@@ -159,40 +1742,99 @@ void show_splash_screen() {
                            GDK_WINDOW_TYPE_HINT_SPLASHSCREEN);
   gtk_window_set_keep_above(GTK_WINDOW(splash_window), TRUE);  // Stay on top
   gtk_window_set_position(GTK_WINDOW(splash_window), GTK_WIN_POS_CENTER);
-  gtk_window_set_default_size(GTK_WINDOW(splash_window),
-                              native_splash_screen_width,
-                              native_splash_screen_height);
   gtk_widget_set_app_paintable(splash_window, TRUE);
 
-  // Set up for transparency
+  // Set up for transparency, an opaque splash keeps the system visual so the
+  // compositor does not blend the window on every frame
   GdkScreen* screen = gtk_window_get_screen(GTK_WINDOW(splash_window));
   GdkVisual* visual = gdk_screen_get_rgba_visual(screen);
-  if (visual != nullptr && gdk_screen_is_composited(screen)) {
+  const gboolean composited =
+      visual != nullptr && gdk_screen_is_composited(screen);
+  splash_slide_margin = 0;
+  if (composited && !SplashConfig::opaque()) {
     gtk_widget_set_visual(splash_window, visual);
+    splash_slide_margin = SPLASH_SLIDE_DISTANCE;
   }
 
+  // The margins are transparent and centered around the content, which
+  // stays where it would be without them
+  gtk_window_set_default_size(GTK_WINDOW(splash_window),
+                              SplashConfig::width(),
+                              SplashConfig::height() + 2 * splash_slide_margin);
+  splash_metrics_record("opaque_visual",
+                        composited && SplashConfig::opaque());
+
+  // Only ask for the appearance of the desktop when there is a dark image
+  if (SplashConfig::image_dark_variant_count() > 0) {
+    splash_dark_theme = splash_theme_prefers_dark();
+    splash_metrics_record("dark_theme", splash_dark_theme);
+  }
+
+  // Build the layers drawn by the splash window, from the cached composition
+  // when available
+  load_splash_cache(screen);
+  if (splash_cached_surface == nullptr) {
+    load_splash_image(get_splash_scale(screen));
+  }
+  splash_scene = create_splash_scene(screen);
+  composited_changed_handler =
+      g_signal_connect(G_OBJECT(screen), "composited-changed",
+                       G_CALLBACK(on_composited_changed), nullptr);
+
   // Create a drawing area for the splash content
-  GtkWidget* drawing_area = gtk_drawing_area_new();
-  gtk_container_add(GTK_CONTAINER(splash_window), drawing_area);
+  splash_drawing_area = gtk_drawing_area_new();
+  gtk_container_add(GTK_CONTAINER(splash_window), splash_drawing_area);
+
+  // Connect the draw signal to paint the damaged parts of the scene
+  g_signal_connect(G_OBJECT(splash_drawing_area), "draw",
+                   G_CALLBACK(on_draw_event), nullptr);
+
+  // Play the animation on the frame clock of the drawing area
+  if (splash_animation != nullptr &&
+      splash_animation_get_frame_count(splash_animation) > 1) {
+    splash_animation_tick_id = gtk_widget_add_tick_callback(
+        splash_drawing_area, on_animation_tick, nullptr, nullptr);
+  }
 
-  // Connect the draw signal to handle background color and image drawing
-  g_signal_connect(G_OBJECT(drawing_area), "draw", G_CALLBACK(on_draw_event),
-                   nullptr);
+  if (splash_spinner != nullptr) {
+    gtk_widget_add_tick_callback(splash_drawing_area, on_spinner_tick, nullptr,
+                                 nullptr);
+  }
 
   // Connect destroy signal
   g_signal_connect(G_OBJECT(splash_window), "destroy",
-                   G_CALLBACK(gtk_widget_destroyed), &splash_window);
+                   G_CALLBACK(on_splash_destroyed), nullptr);
+
+  // Shape the window before it is mapped, clicks go through the margins
+  update_window_shape(screen);
+  if (splash_slide_margin > 0) {
+    cairo_rectangle_int_t content = {0, splash_slide_margin,
+                                     SplashConfig::width(),
+                                     SplashConfig::height()};
+    cairo_region_t* input = cairo_region_create_rectangle(&content);
+    gtk_widget_input_shape_combine_region(splash_window, input);
+    cairo_region_destroy(input);
+  }
 
   // Set initial opacity if animation is enabled
-  if (native_splash_screen_with_animation) {
+  if (SplashConfig::with_animation()) {
     gtk_widget_set_opacity(splash_window, 0.0);
   }
 
   // Show all widgets
   gtk_widget_show_all(splash_window);
 
+  // The first frame paints everything, flush what was recorded while building
+  queue_scene_damage();
+
+  start_visual_benchmark(composited, composited && !SplashConfig::opaque());
+
+  if (splash_cached_surface == nullptr && splash_cache_path != nullptr) {
+    g_idle_add(store_splash_cache, nullptr);
+  }
+
   // Handle fade-in animation if enabled
-  if (native_splash_screen_with_animation) {
+  if (SplashConfig::with_animation()) {
     // Fade in using 10 steps with 15ms delay between each step (~150ms total)
     const int fade_steps = 10;
     const int fade_delay_ms = 15;
@@ -276,6 +1918,34 @@ void close_splash_window_with_fade() {
   animation_timer_id = g_timeout_add(sleep_per_step, fade_out_func, fade_data);
 }
 
+// Moves every layer but the window color by |y_offset|.
+static void offset_layer(SplashLayer* layer, gpointer user_data) {
+  if (g_strcmp0(splash_layer_get_name(layer), "window") == 0) {
+    return;
+  }
+
+  cairo_matrix_t transform;
+  cairo_matrix_init_translate(&transform, 0, *static_cast<int*>(user_data));
+  splash_layer_set_transform(layer, &transform);
+}
+
+static void set_scene_offset(int y_offset) {
+  if (splash_scene != nullptr) {
+    splash_scene_foreach_layer(splash_scene, offset_layer, &y_offset);
+  }
+}
+
+// Chooses how the content slides. A window with an alpha channel has a
+// transparent margin the content slides into, so the window stays in place.
+// Any other window would show the margin, it is moved as a whole instead,
+// which window managers of Wayland ignore.
+static void start_slide(struct SlideFadeData* data) {
+  GdkScreen* screen = gtk_widget_get_screen(data->window);
+  data->move_window =
+      splash_slide_margin == 0 || !gdk_screen_is_composited(screen);
+  gtk_window_get_position(GTK_WINDOW(data->window), nullptr, &data->start_y);
+}
+
 // Close with slide up and fade animation
 void close_splash_window_slide_up_fade() {
   if (!splash_window) {
@@ -288,23 +1958,19 @@ void close_splash_window_slide_up_fade() {
   const int fade_duration_ms = 300;
   const int steps = 30;
   const int sleep_per_step = fade_duration_ms / steps;
-  const int move_distance = 50;  // move up by 50 pixels total
-
-  // Get current position
-  gint x, y;
-  gtk_window_get_position(GTK_WINDOW(splash_window), &x, &y);
+  const int move_distance = SPLASH_SLIDE_DISTANCE;  // move up
 
   // Set up the animation data
   struct SlideFadeData* slide_data = g_new(struct SlideFadeData, 1);
   slide_data->window = splash_window;
   slide_data->current_step = 0;
   slide_data->total_steps = steps;
-  slide_data->start_y = y;
-  slide_data->move_distance = move_distance;
+  slide_data->move_distance = -move_distance;
+  start_slide(slide_data);
 
   // Start the animation timer
   animation_timer_id =
-      g_timeout_add(sleep_per_step, slide_up_fade_func, slide_data);
+      g_timeout_add(sleep_per_step, slide_fade_func, slide_data);
 }
 
 // Close with slide down and fade animation
@@ -319,73 +1985,88 @@ void close_splash_window_slide_down_fade() {
   const int fade_duration_ms = 300;
   const int steps = 30;
   const int sleep_per_step = fade_duration_ms / steps;
-  const int move_distance = 50;  // move down by 50 pixels total
-
-  // Get current position
-  gint x, y;
-  gtk_window_get_position(GTK_WINDOW(splash_window), &x, &y);
+  const int move_distance = SPLASH_SLIDE_DISTANCE;  // move down
 
   // Set up the animation data
   struct SlideFadeData* slide_data = g_new(struct SlideFadeData, 1);
   slide_data->window = splash_window;
   slide_data->current_step = 0;
   slide_data->total_steps = steps;
-  slide_data->start_y = y;
   slide_data->move_distance = move_distance;
+  start_slide(slide_data);
 
   // Start the animation timer
   animation_timer_id =
-      g_timeout_add(sleep_per_step, slide_down_fade_func, slide_data);
+      g_timeout_add(sleep_per_step, slide_fade_func, slide_data);
 }
 
 static gboolean on_draw_event(GtkWidget* widget,
                               cairo_t* cr,
                               gpointer user_data) {
-  GtkAllocation allocation;
-  gtk_widget_get_allocation(widget, &allocation);
+  if (splash_scene != nullptr) {
+    cairo_translate(cr, 0, splash_slide_margin);
+    splash_scene_draw(splash_scene, cr);
+  }
 
-  // Get the screen
-  GdkScreen* screen = gtk_widget_get_screen(widget);
+  return FALSE;  // Let GTK continue normal processing
+}
 
-  // Only fill background if compositing is NOT supported
-  if (!gdk_screen_is_composited(screen)) {
-    // Extract ARGB components from the background color
-    double alpha =
-        ((native_splash_screen_background_color >> 24) & 0xFF) / 255.0;
-    double red = ((native_splash_screen_background_color >> 16) & 0xFF) / 255.0;
-    double green =
-        ((native_splash_screen_background_color >> 8) & 0xFF) / 255.0;
-    double blue = (native_splash_screen_background_color & 0xFF) / 255.0;
-
-    // Fill background with the specified color
-    cairo_set_source_rgba(cr, red, green, blue, alpha);
-    cairo_rectangle(cr, 0, 0, allocation.width, allocation.height);
-    cairo_fill(cr);
+// Frees everything that was only needed to draw the splash: the scene and
+// its caches, the decoded image, the asset mapping or inflated data, and the
+// resident pages of the embedded pixels. The RSS before and after is
+// reported through the metrics.
+static void release_splash_memory() {
+  splash_metrics_record("rss_before_release", splash_metrics_get_rss());
+
+  splash_scene_free(splash_scene);
+  splash_scene = nullptr;
+
+  if (splash_image_surface != nullptr) {
+    cairo_surface_destroy(splash_image_surface);
+    splash_image_surface = nullptr;
   }
 
-  // Draw the image if available
-  if (native_splash_screen_image_pixels != nullptr &&
-      native_splash_screen_image_width > 0 &&
-      native_splash_screen_image_height > 0) {
-    // Create a cairo surface from the image data
-    cairo_surface_t* image_surface = cairo_image_surface_create_for_data(
-        (unsigned char*)native_splash_screen_image_pixels, CAIRO_FORMAT_ARGB32,
-        native_splash_screen_image_width, native_splash_screen_image_height,
-        native_splash_screen_image_width * 4  // Stride
-    );
+  if (splash_cached_surface != nullptr) {
+    cairo_surface_destroy(splash_cached_surface);
+    splash_cached_surface = nullptr;
+  }
+  g_clear_pointer(&splash_cache_path, g_free);
+
+  // The tick callback went away with the drawing area
+  splash_animation_tick_id = 0;
+  g_clear_pointer(&splash_animation_surface, cairo_surface_destroy);
+  g_clear_pointer(&splash_animation, splash_animation_free);
+  g_clear_pointer(&splash_spinner, splash_spinner_free);
+
+  // The surface may have been reading straight from the mapping
+  splash_asset_free(splash_asset);
+  splash_asset = nullptr;
+  memset(&splash_image, 0, sizeof(splash_image));
 
-    // Center the image
-    int x = (allocation.width - native_splash_screen_image_width) / 2;
-    int y = (allocation.height - native_splash_screen_image_height) / 2;
+  advise_embedded_pixels(MADV_DONTNEED);
+
+#ifdef __GLIBC__
+  // Hand the freed decoding buffers back to the system
+  malloc_trim(0);
+#endif
+
+  splash_metrics_record("rss_after_release", splash_metrics_get_rss());
+}
 
-    // Draw the image
-    cairo_set_source_surface(cr, image_surface, x, y);
-    cairo_paint(cr);
+// Releases the scene once the splash window is gone.
+static void on_splash_destroyed(GtkWidget* widget, gpointer user_data) {
+  if (widget == splash_window) {
+    splash_window = nullptr;
+  }
+  splash_drawing_area = nullptr;
 
-    cairo_surface_destroy(image_surface);
+  if (composited_changed_handler != 0) {
+    g_signal_handler_disconnect(gtk_widget_get_screen(widget),
+                                composited_changed_handler);
+    composited_changed_handler = 0;
   }
 
-  return FALSE;  // Let GTK continue normal processing
+  release_splash_memory();
 }
 
 static gboolean fade_in_func(gpointer user_data) {
@@ -447,8 +2128,9 @@ static gboolean fade_out_func(gpointer user_data) {
   return G_SOURCE_CONTINUE;
 }
 
-// Function to handle slide-up-fade animation steps
-static gboolean slide_up_fade_func(gpointer user_data) {
+// Function to handle slide-fade animation steps, up or down with the sign
+// of the move distance
+static gboolean slide_fade_func(gpointer user_data) {
   struct SlideFadeData* data = (struct SlideFadeData*)user_data;
 
   // Calculate new opacity and position
@@ -459,53 +2141,16 @@ static gboolean slide_up_fade_func(gpointer user_data) {
   // Apply new opacity and position
   gtk_widget_set_opacity(data->window, opacity);
 
-  // Get current x position and update window position
-  gint x;
-  gtk_window_get_position(GTK_WINDOW(data->window), &x, nullptr);
-  gtk_window_move(GTK_WINDOW(data->window), x, data->start_y - y_offset);
-
-  // Increment step
-  data->current_step++;
-
-  // Check if animation is complete
-  if (data->current_step > data->total_steps) {
-    // Animation complete, destroy the window
-    gtk_widget_destroy(data->window);
-    splash_window = nullptr;
-    splash_shown = FALSE;
-
-    // Free data and stop timer
-    g_free(data);
-    animation_timer_id = 0;
-    return G_SOURCE_REMOVE;
-  }
-
-  // Process pending events
-  while (gtk_events_pending()) {
-    gtk_main_iteration();
+  if (data->move_window) {
+    gint x;
+    gtk_window_get_position(GTK_WINDOW(data->window), &x, nullptr);
+    gtk_window_move(GTK_WINDOW(data->window), x, data->start_y + y_offset);
+  } else {
+    // Slide the content into the margin, the window geometry stays the same
+    set_scene_offset(y_offset);
+    queue_scene_damage();
   }
 
-  // Continue the animation
-  return G_SOURCE_CONTINUE;
-}
-
-// Function to handle slide-down-fade animation steps
-static gboolean slide_down_fade_func(gpointer user_data) {
-  struct SlideFadeData* data = (struct SlideFadeData*)user_data;
-
-  // Calculate new opacity and position
-  double opacity =
-      (double)(data->total_steps - data->current_step) / data->total_steps;
-  int y_offset = (data->move_distance * data->current_step) / data->total_steps;
-
-  // Apply new opacity and position
-  gtk_widget_set_opacity(data->window, opacity);
-
-  // Get current x position and update window position
-  gint x;
-  gtk_window_get_position(GTK_WINDOW(data->window), &x, nullptr);
-  gtk_window_move(GTK_WINDOW(data->window), x, data->start_y + y_offset);
-
   // Increment step
   data->current_step++;
 
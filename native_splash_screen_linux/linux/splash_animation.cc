@@ -0,0 +1,232 @@
+#include "splash_animation.h"
+
+#include <gio/gio.h>
+#include <string.h>
+
+struct _SplashAnimation {
+  const guint8* data;
+  gsize size;
+  int width;
+  int height;
+  int frame_count;
+  int loop_count;
+  const guint8* frames;
+};
+
+// Embedded header, every field is little-endian.
+struct SplashAnimationHeader {
+  char magic[4];
+  uint32_t version;
+  int32_t width;
+  int32_t height;
+  uint32_t frame_count;
+  uint32_t loop_count;
+  uint32_t frame_table_offset;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SplashAnimationHeader) == 32,
+              "The animation header is 32 bytes long");
+
+// Entry of the frame table, little-endian as well.
+struct SplashAnimationFrame {
+  uint32_t duration;
+  uint32_t flags;
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+  uint32_t data_offset;
+  uint32_t data_size;
+};
+
+static_assert(sizeof(SplashAnimationFrame) == 32,
+              "The animation frame entries are 32 bytes long");
+
+// Largest width or height accepted, guards the size computations.
+#define SPLASH_ANIMATION_MAX_EXTENT 4096
+
+static void get_frame(SplashAnimation* animation,
+                      int index,
+                      SplashAnimationFrame* frame) {
+  memcpy(frame, animation->frames + (gsize)index * sizeof(*frame),
+         sizeof(*frame));
+}
+
+// Checks that |frame| lies inside the animation and its data inside the blob.
+static gboolean validate_frame(SplashAnimation* animation,
+                               const SplashAnimationFrame* frame,
+                               gboolean first) {
+  if (frame->x < 0 || frame->y < 0 || frame->width < 0 ||
+      frame->height < 0 || frame->x + frame->width > animation->width ||
+      frame->y + frame->height > animation->height ||
+      (gsize)frame->data_offset + frame->data_size > animation->size) {
+    return FALSE;
+  }
+
+  // Nothing comes before the first frame for a delta to apply to
+  return !first || (frame->flags & SPLASH_ANIMATION_FRAME_KEYFRAME) != 0;
+}
+
+SplashAnimation* splash_animation_new_from_data(const guint8* data,
+                                                gsize size,
+                                                GError** error) {
+  if (data == nullptr || size < sizeof(SplashAnimationHeader)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Splash animation is too short");
+    return nullptr;
+  }
+
+  SplashAnimationHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, "NSSM", 4) != 0) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Not a splash animation");
+    return nullptr;
+  }
+  if (header.version != SPLASH_ANIMATION_VERSION) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                "Unsupported splash animation version %u", header.version);
+    return nullptr;
+  }
+
+  if (header.width <= 0 || header.height <= 0 ||
+      header.width > SPLASH_ANIMATION_MAX_EXTENT ||
+      header.height > SPLASH_ANIMATION_MAX_EXTENT || header.frame_count == 0 ||
+      header.frame_table_offset < sizeof(header) ||
+      header.frame_table_offset > size ||
+      header.frame_count > (size - header.frame_table_offset) /
+                               sizeof(SplashAnimationFrame)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Invalid splash animation header");
+    return nullptr;
+  }
+
+  SplashAnimation* animation = g_new0(SplashAnimation, 1);
+  animation->data = data;
+  animation->size = size;
+  animation->width = header.width;
+  animation->height = header.height;
+  animation->frame_count = (int)header.frame_count;
+  animation->loop_count = (int)MIN(header.loop_count, (uint32_t)G_MAXINT);
+  animation->frames = data + header.frame_table_offset;
+
+  for (int i = 0; i < animation->frame_count; i++) {
+    SplashAnimationFrame frame;
+    get_frame(animation, i, &frame);
+    if (!validate_frame(animation, &frame, i == 0)) {
+      g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                  "Invalid splash animation frame %d", i);
+      splash_animation_free(animation);
+      return nullptr;
+    }
+  }
+  return animation;
+}
+
+void splash_animation_free(SplashAnimation* animation) {
+  g_free(animation);
+}
+
+int splash_animation_get_width(SplashAnimation* animation) {
+  return animation->width;
+}
+
+int splash_animation_get_height(SplashAnimation* animation) {
+  return animation->height;
+}
+
+int splash_animation_get_frame_count(SplashAnimation* animation) {
+  return animation->frame_count;
+}
+
+int splash_animation_get_loop_count(SplashAnimation* animation) {
+  return animation->loop_count;
+}
+
+guint splash_animation_get_frame_duration(SplashAnimation* animation,
+                                          int frame) {
+  SplashAnimationFrame entry;
+  get_frame(animation, frame, &entry);
+  return entry.duration;
+}
+
+// Inflates the rows of |frame| one after the other into their place in
+// |pixels|, so no intermediate buffer is needed.
+static gboolean inflate_rows(const guint8* data,
+                             const SplashAnimationFrame* frame,
+                             guint8* pixels,
+                             int stride,
+                             GError** error) {
+  GConverter* converter =
+      G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+
+  const gsize row_size = (gsize)frame->width * 4;
+  gsize consumed = 0;
+  gboolean truncated = FALSE;
+  for (int y = 0; y < frame->height && !truncated; y++) {
+    guint8* row =
+        pixels + (gsize)(frame->y + y) * stride + (gsize)frame->x * 4;
+    gsize produced = 0;
+    while (produced < row_size) {
+      gsize bytes_read = 0;
+      gsize bytes_written = 0;
+      GConverterResult result = g_converter_convert(
+          converter, data + consumed, frame->data_size - consumed,
+          row + produced, row_size - produced, G_CONVERTER_INPUT_AT_END,
+          &bytes_read, &bytes_written, error);
+      if (result == G_CONVERTER_ERROR) {
+        g_object_unref(converter);
+        return FALSE;
+      }
+      consumed += bytes_read;
+      produced += bytes_written;
+      if (bytes_written == 0 &&
+          (bytes_read == 0 || result == G_CONVERTER_FINISHED)) {
+        truncated = TRUE;
+        break;
+      }
+    }
+  }
+  g_object_unref(converter);
+
+  if (truncated) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Truncated splash animation frame");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+gboolean splash_animation_decode_frame(SplashAnimation* animation,
+                                       int frame,
+                                       cairo_surface_t* surface,
+                                       cairo_rectangle_int_t* dirty,
+                                       GError** error) {
+  if (cairo_image_surface_get_format(surface) != CAIRO_FORMAT_ARGB32 ||
+      cairo_image_surface_get_width(surface) != animation->width ||
+      cairo_image_surface_get_height(surface) != animation->height) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                "Surface does not match the splash animation");
+    return FALSE;
+  }
+
+  SplashAnimationFrame entry;
+  get_frame(animation, frame, &entry);
+  dirty->x = entry.x;
+  dirty->y = entry.y;
+  dirty->width = entry.width;
+  dirty->height = entry.height;
+  if (entry.width == 0 || entry.height == 0) {
+    return TRUE;
+  }
+
+  cairo_surface_flush(surface);
+  const gboolean decoded = inflate_rows(
+      animation->data + entry.data_offset, &entry,
+      cairo_image_surface_get_data(surface),
+      cairo_image_surface_get_stride(surface), error);
+  cairo_surface_mark_dirty_rectangle(surface, entry.x, entry.y, entry.width,
+                                     entry.height);
+  return decoded;
+}
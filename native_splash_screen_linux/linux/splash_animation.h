@@ -0,0 +1,65 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ANIMATION_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ANIMATION_H_
+
+#include <cairo.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// An animation embedded by native_splash_screen_cli, played over the splash.
+//
+// The blob starts with a 32 bytes little-endian header:
+//
+//   magic "NSSM", version, width, height, frame count, loop count,
+//   frame table offset, reserved
+//
+// followed by the frame table, 32 bytes per frame:
+//
+//   duration in milliseconds, flags, x, y, width, height, data offset,
+//   data size
+//
+// Every frame only stores the pixels of its dirty rectangle, the area that
+// differs from the previous frame, as zlib compressed ARGB32 rows. Keyframes
+// cover the whole animation, the first frame always is one.
+//
+// Frames are inflated straight into the surface holding the previous one,
+// so playing the animation only takes the memory of a single frame on top
+// of the compressed blob.
+typedef struct _SplashAnimation SplashAnimation;
+
+#define SPLASH_ANIMATION_VERSION 1
+
+enum SplashAnimationFrameFlags {
+  SPLASH_ANIMATION_FRAME_KEYFRAME = 1 << 0,
+};
+
+// Parses an animation embedded in the binary, |data| must outlive it.
+SplashAnimation* splash_animation_new_from_data(const guint8* data,
+                                                gsize size,
+                                                GError** error);
+
+void splash_animation_free(SplashAnimation* animation);
+
+int splash_animation_get_width(SplashAnimation* animation);
+int splash_animation_get_height(SplashAnimation* animation);
+int splash_animation_get_frame_count(SplashAnimation* animation);
+
+// Number of times the animation is played, 0 when it loops forever.
+int splash_animation_get_loop_count(SplashAnimation* animation);
+
+// Returns how long |frame| is shown, in milliseconds.
+guint splash_animation_get_frame_duration(SplashAnimation* animation,
+                                          int frame);
+
+// Inflates |frame| into |surface|, an ARGB32 image surface of the animation
+// size holding the frame before it, or anything for a keyframe. Stores the
+// area that changed in |dirty|.
+gboolean splash_animation_decode_frame(SplashAnimation* animation,
+                                       int frame,
+                                       cairo_surface_t* surface,
+                                       cairo_rectangle_int_t* dirty,
+                                       GError** error);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ANIMATION_H_
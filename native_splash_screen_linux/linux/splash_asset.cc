@@ -0,0 +1,246 @@
+#include "splash_asset.h"
+
+#include <gio/gio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "splash_pixels.h"
+
+struct _SplashAsset {
+  GMappedFile* file;
+  guint8* inflated;
+  SplashImage image;
+};
+
+// On-disk header, every field is little-endian.
+struct SplashAssetHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t format;
+  uint32_t compression;
+  int32_t width;
+  int32_t height;
+  int32_t offset_x;
+  int32_t offset_y;
+  int32_t canvas_width;
+  int32_t canvas_height;
+  uint32_t palette_size;
+  uint32_t data_offset;
+  uint32_t data_size;
+  uint32_t raw_size;
+  uint32_t checksum;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SplashAssetHeader) == 64,
+              "The asset header is 64 bytes long");
+
+// Largest width or height accepted, guards the size computations.
+#define SPLASH_ASSET_MAX_EXTENT 16384
+
+static uint32_t fnv1a(const guint8* data, gsize size) {
+  uint32_t hash = 0x811C9DC5u;
+  for (gsize i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x01000193u;
+  }
+  return hash;
+}
+
+// Inflates |size| bytes of zlib data into |out|, which must receive exactly
+// |raw_size| bytes.
+static gboolean inflate(const guint8* data,
+                        gsize size,
+                        guint8* out,
+                        gsize raw_size,
+                        GError** error) {
+  GConverter* converter =
+      G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+
+  gsize consumed = 0;
+  gsize produced = 0;
+  GConverterResult result = G_CONVERTER_CONVERTED;
+  while (result != G_CONVERTER_FINISHED) {
+    gsize bytes_read = 0;
+    gsize bytes_written = 0;
+    result = g_converter_convert(converter, data + consumed, size - consumed,
+                                 out + produced, raw_size - produced,
+                                 G_CONVERTER_INPUT_AT_END, &bytes_read,
+                                 &bytes_written, error);
+    if (result == G_CONVERTER_ERROR) {
+      g_object_unref(converter);
+      return FALSE;
+    }
+    consumed += bytes_read;
+    produced += bytes_written;
+    if (bytes_read == 0 && bytes_written == 0 &&
+        result != G_CONVERTER_FINISHED) {
+      break;
+    }
+  }
+  g_object_unref(converter);
+
+  if (result != G_CONVERTER_FINISHED || produced != raw_size) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Truncated compressed splash data");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// Checks the header against the file size, returns the expected size of the
+// uncompressed pixels or 0 if the header is invalid.
+static gsize validate_header(const SplashAssetHeader* header,
+                             gsize file_size,
+                             GError** error) {
+  if (memcmp(header->magic, "NSSA", 4) != 0) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Not a splash asset file");
+    return 0;
+  }
+  if (header->version != SPLASH_ASSET_VERSION) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                "Unsupported splash asset version %u", header->version);
+    return 0;
+  }
+
+  gsize bytes_per_pixel;
+  if (header->format == SPLASH_PIXEL_FORMAT_ARGB32) {
+    bytes_per_pixel = 4;
+  } else if (header->format == SPLASH_PIXEL_FORMAT_INDEXED8) {
+    bytes_per_pixel = 1;
+  } else {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                "Unsupported splash asset pixel format %u", header->format);
+    return 0;
+  }
+
+  if (header->width <= 0 || header->height <= 0 ||
+      header->width > SPLASH_ASSET_MAX_EXTENT ||
+      header->height > SPLASH_ASSET_MAX_EXTENT || header->palette_size > 256 ||
+      header->compression > SPLASH_ASSET_COMPRESSION_ZLIB) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Invalid splash asset header");
+    return 0;
+  }
+
+  const gsize raw_size =
+      (gsize)header->width * (gsize)header->height * bytes_per_pixel;
+  const gsize palette_end =
+      sizeof(SplashAssetHeader) + (gsize)header->palette_size * 4;
+  const gboolean stored_raw =
+      header->compression == SPLASH_ASSET_COMPRESSION_NONE;
+  if (header->raw_size != raw_size || header->data_offset < palette_end ||
+      header->data_offset % 4 != 0 ||
+      (gsize)header->data_offset + header->data_size > file_size ||
+      (stored_raw && header->data_size != raw_size)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Splash asset layout does not match its header");
+    return 0;
+  }
+
+  return raw_size;
+}
+
+// Parses an asset whose |length| bytes of |contents| outlive it.
+static SplashAsset* splash_asset_new(const guint8* contents,
+                                     gsize length,
+                                     GError** error) {
+  if (contents == nullptr || length < sizeof(SplashAssetHeader)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Splash asset is too short");
+    return nullptr;
+  }
+
+  SplashAssetHeader header;
+  memcpy(&header, contents, sizeof(header));
+  const gsize raw_size = validate_header(&header, length, error);
+  if (raw_size == 0) {
+    return nullptr;
+  }
+
+  const guint8* data = contents + header.data_offset;
+  if (fnv1a(data, header.data_size) != header.checksum) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Splash asset checksum mismatch");
+    return nullptr;
+  }
+
+  SplashAsset* asset = g_new0(SplashAsset, 1);
+
+  if (header.compression == SPLASH_ASSET_COMPRESSION_ZLIB) {
+    asset->inflated = static_cast<guint8*>(g_try_malloc(raw_size));
+    if (asset->inflated == nullptr) {
+      g_set_error(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                  "Not enough memory to inflate the splash asset");
+      splash_asset_free(asset);
+      return nullptr;
+    }
+    if (!inflate(data, header.data_size, asset->inflated, raw_size, error)) {
+      splash_asset_free(asset);
+      return nullptr;
+    }
+    data = asset->inflated;
+  }
+
+  SplashImage* image = &asset->image;
+  image->format = header.format;
+  image->scale = 1;
+  image->width = header.width;
+  image->height = header.height;
+  image->pixels = data;
+  image->palette = header.palette_size > 0
+                       ? reinterpret_cast<const uint32_t*>(
+                             contents + sizeof(SplashAssetHeader))
+                       : nullptr;
+  image->palette_size = header.palette_size;
+  image->offset_x = header.offset_x;
+  image->offset_y = header.offset_y;
+  image->canvas_width = header.canvas_width;
+  image->canvas_height = header.canvas_height;
+  return asset;
+}
+
+SplashAsset* splash_asset_open(const gchar* path, GError** error) {
+  GMappedFile* file = g_mapped_file_new(path, FALSE, error);
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  const guint8* contents =
+      reinterpret_cast<const guint8*>(g_mapped_file_get_contents(file));
+  const gsize length = g_mapped_file_get_length(file);
+
+  // The whole file is read right away by the checksum and the first draw
+  if (contents != nullptr) {
+    madvise(const_cast<guint8*>(contents), length, MADV_WILLNEED);
+  }
+
+  SplashAsset* asset = splash_asset_new(contents, length, error);
+  if (asset == nullptr) {
+    g_mapped_file_unref(file);
+    return nullptr;
+  }
+  asset->file = file;
+  return asset;
+}
+
+SplashAsset* splash_asset_new_from_data(const guint8* data,
+                                        gsize size,
+                                        GError** error) {
+  return splash_asset_new(data, size, error);
+}
+
+void splash_asset_free(SplashAsset* asset) {
+  if (asset == nullptr) {
+    return;
+  }
+  g_free(asset->inflated);
+  if (asset->file != nullptr) {
+    g_mapped_file_unref(asset->file);
+  }
+  g_free(asset);
+}
+
+const SplashImage* splash_asset_get_image(SplashAsset* asset) {
+  return &asset->image;
+}
@@ -0,0 +1,64 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ASSET_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ASSET_H_
+
+#include <glib.h>
+#include <stdint.h>
+
+G_BEGIN_DECLS
+
+// Splash image pixels and their placement, whether they are embedded in the
+// binary or loaded from an asset file.
+typedef struct {
+  int format;  // SplashPixelFormat
+  int scale;   // Device pixels per logical pixel
+  int width;
+  int height;
+  const uint8_t* pixels;
+  const uint32_t* palette;
+  int palette_size;
+  int tile_size;
+  const uint32_t* tile_map;
+  int offset_x;
+  int offset_y;
+  int canvas_width;
+  int canvas_height;
+} SplashImage;
+
+// An image loaded from a `.nss` file written by native_splash_screen_cli.
+//
+// The file starts with a 64 bytes little-endian header:
+//
+//   magic "NSSA", version, format, compression,
+//   width, height, offset x, offset y, canvas width, canvas height,
+//   palette size, data offset, data size, raw size, checksum, reserved
+//
+// followed by the palette, if any, and by the pixel data at a page aligned
+// offset. The checksum is the 32-bit FNV-1a hash of the stored data.
+//
+// Files are mapped read-only. Uncompressed pixels are used straight from
+// the mapping, zlib compressed ones are inflated once into a private buffer.
+typedef struct _SplashAsset SplashAsset;
+
+#define SPLASH_ASSET_VERSION 1
+
+enum SplashAssetCompression {
+  SPLASH_ASSET_COMPRESSION_NONE = 0,
+  SPLASH_ASSET_COMPRESSION_ZLIB = 1,
+};
+
+SplashAsset* splash_asset_open(const gchar* path, GError** error);
+
+// Parses an asset embedded in the binary, |data| must outlive it.
+SplashAsset* splash_asset_new_from_data(const guint8* data,
+                                        gsize size,
+                                        GError** error);
+
+// Releases the mapping and any decompressed data, the image returned by
+// splash_asset_get_image() must not be used anymore.
+void splash_asset_free(SplashAsset* asset);
+
+const SplashImage* splash_asset_get_image(SplashAsset* asset);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_ASSET_H_
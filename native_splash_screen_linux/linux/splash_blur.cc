@@ -0,0 +1,250 @@
+#include "splash_blur.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPLASH_BLUR_X86 1
+#endif
+
+#define SPLASH_BLUR_PASSES 3
+
+// Box sums are divided by the box size through a fixed-point reciprocal with
+// 16 fractional bits, the product for a box of up to 255 rows fits in 31 bits
+#define SPLASH_BLUR_SCALE_BITS 16
+#define SPLASH_BLUR_MAX_SIZE 255
+
+// Computes the odd sizes of the boxes whose successive blurs have the
+// variance of a gaussian of |sigma|.
+static void compute_box_sizes(double sigma, int sizes[SPLASH_BLUR_PASSES]) {
+  const int n = SPLASH_BLUR_PASSES;
+  const double variance = 12.0 * sigma * sigma;
+  int lower = (int)floor(sqrt(variance / n + 1.0));
+  if (lower % 2 == 0) {
+    lower--;
+  }
+  lower = std::min(std::max(lower, 1), SPLASH_BLUR_MAX_SIZE - 2);
+
+  // Number of passes of the lower size, the others use the next odd one
+  const double lower_variance =
+      n * lower * lower + 4.0 * n * lower + 3.0 * n;
+  const int count =
+      (int)lround((variance - lower_variance) / (-4.0 * lower - 4.0));
+  for (int i = 0; i < n; i++) {
+    sizes[i] = i < count ? lower : lower + 2;
+  }
+}
+
+// Moves the box of |sums| one row down: adds the row entering it, removes the
+// one leaving it, and stores the averages in |out|. Any row can be nullptr.
+typedef void (*SplashBoxStepFunc)(int32_t* sums,
+                                  const uint8_t* enter,
+                                  const uint8_t* leave,
+                                  uint8_t* out,
+                                  int count,
+                                  int32_t reciprocal);
+
+static void box_step_scalar(int32_t* sums,
+                            const uint8_t* enter,
+                            const uint8_t* leave,
+                            uint8_t* out,
+                            int count,
+                            int32_t reciprocal) {
+  const int32_t half = 1 << (SPLASH_BLUR_SCALE_BITS - 1);
+  for (int i = 0; i < count; i++) {
+    int32_t sum = sums[i];
+    if (enter != nullptr) {
+      sum += enter[i];
+    }
+    if (leave != nullptr) {
+      sum -= leave[i];
+    }
+    sums[i] = sum;
+    if (out != nullptr) {
+      out[i] = (uint8_t)std::min(
+          (sum * reciprocal + half) >> SPLASH_BLUR_SCALE_BITS, 255);
+    }
+  }
+}
+
+#ifdef SPLASH_BLUR_X86
+// Widens the 8 bytes at |row| to two vectors of 4 lanes.
+__attribute__((target("sse4.1"))) static inline void load_bytes(
+    const uint8_t* row,
+    __m128i* low,
+    __m128i* high) {
+  const __m128i bytes =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row));
+  *low = _mm_cvtepu8_epi32(bytes);
+  *high = _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4));
+}
+
+__attribute__((target("sse4.1"))) static void box_step_sse41(
+    int32_t* sums,
+    const uint8_t* enter,
+    const uint8_t* leave,
+    uint8_t* out,
+    int count,
+    int32_t reciprocal) {
+  const __m128i factor = _mm_set1_epi32(reciprocal);
+  const __m128i half = _mm_set1_epi32(1 << (SPLASH_BLUR_SCALE_BITS - 1));
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<__m128i*>(sums + i));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<__m128i*>(sums + i + 4));
+    __m128i bytes_low, bytes_high;
+    if (enter != nullptr) {
+      load_bytes(enter + i, &bytes_low, &bytes_high);
+      low = _mm_add_epi32(low, bytes_low);
+      high = _mm_add_epi32(high, bytes_high);
+    }
+    if (leave != nullptr) {
+      load_bytes(leave + i, &bytes_low, &bytes_high);
+      low = _mm_sub_epi32(low, bytes_low);
+      high = _mm_sub_epi32(high, bytes_high);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i + 4), high);
+
+    if (out != nullptr) {
+      low = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(low, factor), half),
+                           SPLASH_BLUR_SCALE_BITS);
+      high = _mm_srli_epi32(
+          _mm_add_epi32(_mm_mullo_epi32(high, factor), half),
+          SPLASH_BLUR_SCALE_BITS);
+      const __m128i words = _mm_packus_epi32(low, high);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+                       _mm_packus_epi16(words, words));
+    }
+  }
+
+  box_step_scalar(sums + i, enter != nullptr ? enter + i : nullptr,
+                  leave != nullptr ? leave + i : nullptr,
+                  out != nullptr ? out + i : nullptr, count - i, reciprocal);
+}
+#endif
+
+// Blurs the columns of |src| with a box of |size| rows into |dst|, both
+// |rows| rows of |row_bytes| bytes. |sums| holds |row_bytes| entries.
+static void box_pass(SplashBoxStepFunc step,
+                     const uint8_t* src,
+                     int src_stride,
+                     uint8_t* dst,
+                     int dst_stride,
+                     int row_bytes,
+                     int rows,
+                     int size,
+                     int32_t* sums) {
+  const int radius = size / 2;
+  const int32_t reciprocal =
+      (int32_t)lround((double)(1 << SPLASH_BLUR_SCALE_BITS) / size);
+  memset(sums, 0, (size_t)row_bytes * sizeof(*sums));
+
+  // The box of the first row starts with the rows below it, the ones above
+  // the image are transparent
+  for (int y = 0; y < std::min(radius, rows); y++) {
+    step(sums, src + (size_t)y * src_stride, nullptr, nullptr, row_bytes,
+         reciprocal);
+  }
+
+  for (int y = 0; y < rows; y++) {
+    const int enter = y + radius;
+    const int leave = y - radius - 1;
+    step(sums, enter < rows ? src + (size_t)enter * src_stride : nullptr,
+         leave >= 0 ? src + (size_t)leave * src_stride : nullptr,
+         dst + (size_t)y * dst_stride, row_bytes, reciprocal);
+  }
+}
+
+// Transposes |src|, |width| x |height| pixels of |channels| bytes, into
+// |dst|, |height| x |width| pixels, in blocks that stay in the cache.
+static void transpose(const uint8_t* src,
+                      int src_stride,
+                      uint8_t* dst,
+                      int dst_stride,
+                      int width,
+                      int height,
+                      int channels) {
+  const int block = 32;
+  for (int y0 = 0; y0 < height; y0 += block) {
+    for (int x0 = 0; x0 < width; x0 += block) {
+      const int y1 = std::min(y0 + block, height);
+      const int x1 = std::min(x0 + block, width);
+      for (int y = y0; y < y1; y++) {
+        const uint8_t* row = src + (size_t)y * src_stride;
+        for (int x = x0; x < x1; x++) {
+          memcpy(dst + (size_t)x * dst_stride + (size_t)y * channels,
+                 row + (size_t)x * channels, channels);
+        }
+      }
+    }
+  }
+}
+
+int splash_blur_get_extent(double sigma) {
+  return sigma > 0 ? (int)ceil(3 * sigma) : 0;
+}
+
+bool splash_blur(uint8_t* pixels,
+                 int width,
+                 int height,
+                 int stride,
+                 int channels,
+                 double sigma) {
+  if (pixels == nullptr || width <= 0 || height <= 0 ||
+      (channels != 1 && channels != 4) || stride < width * channels ||
+      !(sigma >= 0)) {
+    return false;
+  }
+  if (sigma == 0) {
+    return true;
+  }
+
+  SplashBoxStepFunc step = box_step_scalar;
+#ifdef SPLASH_BLUR_X86
+  if (__builtin_cpu_supports("sse4.1")) {
+    step = box_step_sse41;
+  }
+#endif
+
+  int sizes[SPLASH_BLUR_PASSES];
+  compute_box_sizes(sigma, sizes);
+
+  try {
+    // The transposed image has |width| rows of |height| pixels
+    const int row_bytes = width * channels;
+    const int column_bytes = height * channels;
+    std::vector<uint8_t> a((size_t)row_bytes * height);
+    std::vector<uint8_t> b(a.size());
+    std::vector<int32_t> sums(std::max(row_bytes, column_bytes));
+
+    // Horizontal passes, down the columns of the transposed image
+    transpose(pixels, stride, a.data(), column_bytes, width, height,
+              channels);
+    box_pass(step, a.data(), column_bytes, b.data(), column_bytes,
+             column_bytes, width, sizes[0], sums.data());
+    box_pass(step, b.data(), column_bytes, a.data(), column_bytes,
+             column_bytes, width, sizes[1], sums.data());
+    box_pass(step, a.data(), column_bytes, b.data(), column_bytes,
+             column_bytes, width, sizes[2], sums.data());
+    transpose(b.data(), column_bytes, a.data(), row_bytes, height, width,
+              channels);
+
+    // Vertical passes, the last one back into the image
+    box_pass(step, a.data(), row_bytes, b.data(), row_bytes, row_bytes,
+             height, sizes[0], sums.data());
+    box_pass(step, b.data(), row_bytes, a.data(), row_bytes, row_bytes,
+             height, sizes[1], sums.data());
+    box_pass(step, a.data(), row_bytes, pixels, stride, row_bytes, height,
+             sizes[2], sums.data());
+  } catch (const std::bad_alloc&) {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,32 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_BLUR_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_BLUR_H_
+
+#include <stdint.h>
+
+// Gaussian blur approximated by three successive box blurs.
+//
+// Every box blur is a running sum down the columns, so its cost does not
+// depend on the radius, computed for a whole row of channels at once with
+// SSE4.1 when the CPU supports it. The horizontal passes run the same way
+// over the transposed image.
+//
+// Like splash_scaler, this only depends on the C++ standard library.
+
+// Blurs |pixels|, |width| x |height| pixels of |channels| bytes (1 for an
+// alpha mask, 4 for premultiplied ARGB) with |stride| bytes per row, in
+// place. |sigma| is the standard deviation of the gaussian, in pixels.
+// Pixels outside of the image count as transparent.
+//
+// Returns false if the arguments are invalid or memory runs out, |pixels|
+// is then left untouched.
+bool splash_blur(uint8_t* pixels,
+                 int width,
+                 int height,
+                 int stride,
+                 int channels,
+                 double sigma);
+
+// Returns how far, in pixels, a blur of |sigma| visibly spreads an image.
+int splash_blur_get_extent(double sigma);
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_BLUR_H_
@@ -0,0 +1,180 @@
+#include "splash_cache.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define SPLASH_CACHE_VERSION 1
+
+// Offset of the pixels in a cache file, keeps them page aligned when mapped.
+#define SPLASH_CACHE_DATA_OFFSET 4096
+
+// On-disk header, in the byte order of the machine that wrote it. A cache
+// is never shared between machines.
+struct SplashCacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  int32_t width;
+  int32_t height;
+  int32_t stride;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SplashCacheHeader) == 32,
+              "The cache header is 32 bytes long");
+
+static const cairo_user_data_key_t mapping_key = {0};
+
+guint64 splash_cache_make_key(guint64 asset_hash,
+                              int scale,
+                              gboolean composited,
+                              gboolean dark_theme) {
+  const guint64 fields[5] = {SPLASH_CACHE_RENDERER_VERSION, asset_hash,
+                             (guint64)scale, (guint64)(composited ? 1 : 0),
+                             (guint64)(dark_theme ? 1 : 0)};
+  const guint8* bytes = reinterpret_cast<const guint8*>(fields);
+
+  // 64-bit FNV-1a
+  guint64 hash = 0xCBF29CE484222325ull;
+  for (gsize i = 0; i < sizeof(fields); i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+gchar* splash_cache_get_path(guint64 key) {
+  // The splash is shown before the application sets its name, fall back to
+  // the executable name
+  g_autofree gchar* app_id = nullptr;
+  if (g_get_prgname() != nullptr) {
+    app_id = g_strdup(g_get_prgname());
+  } else {
+    g_autofree gchar* executable = g_file_read_link("/proc/self/exe", nullptr);
+    if (executable != nullptr) {
+      app_id = g_path_get_basename(executable);
+    }
+  }
+  if (app_id == nullptr) {
+    return nullptr;
+  }
+
+  g_autofree gchar* name =
+      g_strdup_printf("splash-%016" G_GINT64_MODIFIER "x.bin", key);
+  return g_build_filename(g_get_user_cache_dir(), app_id, name, nullptr);
+}
+
+cairo_surface_t* splash_cache_load(const gchar* path,
+                                   guint64 key,
+                                   int width,
+                                   int height,
+                                   int scale) {
+  // A missing file is the usual first run, not an error
+  GMappedFile* file = g_mapped_file_new(path, FALSE, nullptr);
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  // The cached pixels are at the resolution of the display
+  width *= scale;
+  height *= scale;
+  const int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+  const gsize expected = SPLASH_CACHE_DATA_OFFSET + (gsize)stride * height;
+  guint8* contents =
+      reinterpret_cast<guint8*>(g_mapped_file_get_contents(file));
+
+  SplashCacheHeader header;
+  if (contents == nullptr || g_mapped_file_get_length(file) != expected) {
+    g_mapped_file_unref(file);
+    return nullptr;
+  }
+  memcpy(&header, contents, sizeof(header));
+  if (memcmp(header.magic, "NSSC", 4) != 0 ||
+      header.version != SPLASH_CACHE_VERSION || header.key != key ||
+      header.width != width || header.height != height ||
+      header.stride != stride) {
+    g_mapped_file_unref(file);
+    return nullptr;
+  }
+
+  cairo_surface_t* surface = cairo_image_surface_create_for_data(
+      contents + SPLASH_CACHE_DATA_OFFSET, CAIRO_FORMAT_ARGB32, width, height,
+      stride);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(surface);
+    g_mapped_file_unref(file);
+    return nullptr;
+  }
+
+  cairo_surface_set_device_scale(surface, scale, scale);
+
+  // Keep the mapping alive as long as the surface
+  cairo_surface_set_user_data(
+      surface, &mapping_key, file,
+      reinterpret_cast<cairo_destroy_func_t>(g_mapped_file_unref));
+  return surface;
+}
+
+// Removes the cache files written for other keys, they can not match again.
+static void remove_stale_files(const gchar* directory, const gchar* keep) {
+  GDir* dir = g_dir_open(directory, 0, nullptr);
+  if (dir == nullptr) {
+    return;
+  }
+
+  const gchar* name;
+  while ((name = g_dir_read_name(dir)) != nullptr) {
+    if (g_str_has_prefix(name, "splash-") && g_str_has_suffix(name, ".bin") &&
+        g_strcmp0(name, keep) != 0) {
+      g_autofree gchar* stale = g_build_filename(directory, name, nullptr);
+      g_remove(stale);
+    }
+  }
+  g_dir_close(dir);
+}
+
+gboolean splash_cache_store(const gchar* path,
+                            guint64 key,
+                            cairo_surface_t* surface,
+                            GError** error) {
+  cairo_surface_flush(surface);
+  const unsigned char* data = cairo_image_surface_get_data(surface);
+  if (data == nullptr ||
+      cairo_image_surface_get_format(surface) != CAIRO_FORMAT_ARGB32) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                "Only ARGB32 image surfaces can be cached");
+    return FALSE;
+  }
+
+  SplashCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "NSSC", 4);
+  header.version = SPLASH_CACHE_VERSION;
+  header.key = key;
+  header.width = cairo_image_surface_get_width(surface);
+  header.height = cairo_image_surface_get_height(surface);
+  header.stride = cairo_image_surface_get_stride(surface);
+
+  const gsize size =
+      SPLASH_CACHE_DATA_OFFSET + (gsize)header.stride * header.height;
+  g_autofree gchar* contents = static_cast<gchar*>(g_try_malloc0(size));
+  if (contents == nullptr) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                "Not enough memory to write the splash cache");
+    return FALSE;
+  }
+  memcpy(contents, &header, sizeof(header));
+  memcpy(contents + SPLASH_CACHE_DATA_OFFSET, data,
+         (gsize)header.stride * header.height);
+
+  g_autofree gchar* directory = g_path_get_dirname(path);
+  g_autofree gchar* name = g_path_get_basename(path);
+  if (g_mkdir_with_parents(directory, 0700) != 0) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                "Failed to create the splash cache directory %s", directory);
+    return FALSE;
+  }
+  remove_stale_files(directory, name);
+
+  return g_file_set_contents(path, contents, size, error);
+}
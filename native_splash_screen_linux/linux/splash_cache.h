@@ -0,0 +1,48 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CACHE_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CACHE_H_
+
+#include <cairo.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Persistent cache of the fully composed splash, stored in
+// `$XDG_CACHE_HOME/<app-id>/splash-<key>.bin`.
+//
+// The key covers everything the composed pixels depend on: the version of
+// the code composing them, the hash of the generated assets, the scale
+// factor, whether the screen composites transparent windows and whether the
+// dark variant of the image is shown. A file holds a small header followed
+// by the ARGB pixels at a page aligned offset, so it can be mapped and
+// painted without a copy.
+
+// Version of the composition of the splash. Bump it whenever the plugin
+// draws different pixels from the same assets, e.g. a new resampling filter
+// or image effect, so that caches written by older plugins are not reused.
+#define SPLASH_CACHE_RENDERER_VERSION 3
+
+guint64 splash_cache_make_key(guint64 asset_hash,
+                              int scale,
+                              gboolean composited,
+                              gboolean dark_theme);
+
+// Returns the cache file path for |key|, free with g_free().
+gchar* splash_cache_get_path(guint64 key);
+
+// Maps the cached surface if it exists and matches |key| and the expected
+// logical size at |scale|. The mapping is released with the returned surface.
+cairo_surface_t* splash_cache_load(const gchar* path,
+                                   guint64 key,
+                                   int width,
+                                   int height,
+                                   int scale);
+
+// Writes |surface| to |path|, removing the cache files of other keys.
+gboolean splash_cache_store(const gchar* path,
+                            guint64 key,
+                            cairo_surface_t* surface,
+                            GError** error);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CACHE_H_
@@ -0,0 +1,152 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CONFIG_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CONFIG_H_
+
+#include "include/native_splash_screen_linux/native_splash_screen_linux_plugin.h"
+#include "splash_pixels.h"
+
+// Scalar settings of the splash, read by the plugin through |SplashConfig|.
+//
+// native_splash_screen_cli generates a header of constexpr values next to
+// every flavor source, and the native_splash_screen.cmake file of the runner
+// passes the one of the built flavor as NATIVE_SPLASH_SCREEN_CONFIG_HEADER.
+// The settings are then compile-time constants and the code of the features
+// the splash does not use (animation, background rectangle, gradient, alpha
+// channel, ...) folds away. Without it they are read from the generated
+// globals, which remain the reference interface.
+
+// Settings the generated header leaves out, same as the weak definitions of
+// the plugin.
+struct SplashConfigDefaults {
+  static constexpr int image_format() { return SPLASH_PIXEL_FORMAT_ARGB32; }
+  static constexpr int image_palette_size() { return 0; }
+  static constexpr int image_tile_size() { return 0; }
+  static constexpr unsigned int image_vector_size() { return 0; }
+  static constexpr const char* image_asset() { return nullptr; }
+  static constexpr int image_variant_count() { return 0; }
+  static constexpr int image_dark_variant_count() { return 0; }
+  static constexpr unsigned int animation_size() { return 0; }
+  static constexpr unsigned long long asset_hash() { return 0; }
+  static constexpr int image_offset_x() { return 0; }
+  static constexpr int image_offset_y() { return 0; }
+  static constexpr int image_canvas_width() { return 0; }
+  static constexpr int image_canvas_height() { return 0; }
+  static constexpr unsigned int background_rect_color() { return 0x00000000; }
+  static constexpr int background_rect_width() { return 0; }
+  static constexpr int background_rect_height() { return 0; }
+  static constexpr double background_rect_radius() { return 0.0; }
+  static constexpr int background_gradient() { return 0; }
+  static constexpr unsigned int background_gradient_color() {
+    return 0x00000000;
+  }
+  static constexpr double background_gradient_angle() { return 90.0; }
+  static constexpr int spinner_size() { return 0; }
+  static constexpr unsigned int spinner_color() { return 0xFF808080; }
+  static constexpr int spinner_offset_y() { return 0; }
+  static constexpr int spinner_period() { return 1000; }
+  static constexpr int spinner_frames() { return 30; }
+  static constexpr double image_blur_radius() { return 0.0; }
+  static constexpr unsigned int image_shadow_color() { return 0x00000000; }
+  static constexpr double image_shadow_radius() { return 0.0; }
+  static constexpr int image_shadow_offset_x() { return 0; }
+  static constexpr int image_shadow_offset_y() { return 0; }
+  static constexpr bool opaque() { return false; }
+  static constexpr int shape_rect_count() { return 0; }
+};
+
+#ifdef NATIVE_SPLASH_SCREEN_CONFIG_HEADER
+#include NATIVE_SPLASH_SCREEN_CONFIG_HEADER
+
+typedef NativeSplashScreenConfig SplashConfig;
+#else
+struct SplashConfig {
+  static int width() { return native_splash_screen_width; }
+  static int height() { return native_splash_screen_height; }
+  static const char* title() { return native_splash_screen_title; }
+  static bool with_animation() { return native_splash_screen_with_animation; }
+  static unsigned int background_color() {
+    return native_splash_screen_background_color;
+  }
+  static int image_width() { return native_splash_screen_image_width; }
+  static int image_height() { return native_splash_screen_image_height; }
+  static int image_format() { return native_splash_screen_image_format; }
+  static int image_palette_size() {
+    return native_splash_screen_image_palette_size;
+  }
+  static int image_tile_size() { return native_splash_screen_image_tile_size; }
+  static unsigned int image_vector_size() {
+    return native_splash_screen_image_vector_size;
+  }
+  static const char* image_asset() { return native_splash_screen_image_asset; }
+  static int image_variant_count() {
+    return native_splash_screen_image_variant_count;
+  }
+  static int image_dark_variant_count() {
+    return native_splash_screen_image_dark_variant_count;
+  }
+  static unsigned int animation_size() {
+    return native_splash_screen_animation_size;
+  }
+  static unsigned long long asset_hash() {
+    return native_splash_screen_asset_hash;
+  }
+  static int image_offset_x() { return native_splash_screen_image_offset_x; }
+  static int image_offset_y() { return native_splash_screen_image_offset_y; }
+  static int image_canvas_width() {
+    return native_splash_screen_image_canvas_width;
+  }
+  static int image_canvas_height() {
+    return native_splash_screen_image_canvas_height;
+  }
+  static unsigned int background_rect_color() {
+    return native_splash_screen_background_rect_color;
+  }
+  static int background_rect_width() {
+    return native_splash_screen_background_rect_width;
+  }
+  static int background_rect_height() {
+    return native_splash_screen_background_rect_height;
+  }
+  static double background_rect_radius() {
+    return native_splash_screen_background_rect_radius;
+  }
+  static int background_gradient() {
+    return native_splash_screen_background_gradient;
+  }
+  static unsigned int background_gradient_color() {
+    return native_splash_screen_background_gradient_color;
+  }
+  static double background_gradient_angle() {
+    return native_splash_screen_background_gradient_angle;
+  }
+  static int spinner_size() { return native_splash_screen_spinner_size; }
+  static unsigned int spinner_color() {
+    return native_splash_screen_spinner_color;
+  }
+  static int spinner_offset_y() {
+    return native_splash_screen_spinner_offset_y;
+  }
+  static int spinner_period() { return native_splash_screen_spinner_period; }
+  static int spinner_frames() { return native_splash_screen_spinner_frames; }
+  static double image_blur_radius() {
+    return native_splash_screen_image_blur_radius;
+  }
+  static unsigned int image_shadow_color() {
+    return native_splash_screen_image_shadow_color;
+  }
+  static double image_shadow_radius() {
+    return native_splash_screen_image_shadow_radius;
+  }
+  static int image_shadow_offset_x() {
+    return native_splash_screen_image_shadow_offset_x;
+  }
+  static int image_shadow_offset_y() {
+    return native_splash_screen_image_shadow_offset_y;
+  }
+  static bool opaque() { return native_splash_screen_opaque; }
+  static int shape_rect_count() {
+    return native_splash_screen_shape_rect_count;
+  }
+};
+#endif
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_CONFIG_H_
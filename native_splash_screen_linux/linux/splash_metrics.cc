@@ -0,0 +1,57 @@
+#include "splash_metrics.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+struct SplashMetric {
+  gchar* name;
+  gint64 value;
+};
+
+static GArray* metrics = nullptr;
+
+void splash_metrics_record(const gchar* name, gint64 value) {
+  if (metrics == nullptr) {
+    metrics = g_array_new(FALSE, FALSE, sizeof(SplashMetric));
+  }
+
+  for (guint i = 0; i < metrics->len; i++) {
+    SplashMetric* metric = &g_array_index(metrics, SplashMetric, i);
+    if (g_strcmp0(metric->name, name) == 0) {
+      metric->value = value;
+      return;
+    }
+  }
+
+  SplashMetric metric = {g_strdup(name), value};
+  g_array_append_val(metrics, metric);
+}
+
+void splash_metrics_foreach(SplashMetricsFunc func, gpointer user_data) {
+  if (metrics == nullptr) {
+    return;
+  }
+
+  for (guint i = 0; i < metrics->len; i++) {
+    SplashMetric* metric = &g_array_index(metrics, SplashMetric, i);
+    func(metric->name, metric->value, user_data);
+  }
+}
+
+gint64 splash_metrics_get_rss() {
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm == nullptr) {
+    return -1;
+  }
+
+  // The second field is the number of resident pages
+  long size = 0;
+  long resident = 0;
+  int fields = fscanf(statm, "%ld %ld", &size, &resident);
+  fclose(statm);
+  if (fields != 2) {
+    return -1;
+  }
+
+  return (gint64)resident * sysconf(_SC_PAGESIZE);
+}
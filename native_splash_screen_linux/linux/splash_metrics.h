@@ -0,0 +1,27 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_METRICS_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_METRICS_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Named counters recorded by the splash (memory usage, timings, ...),
+// reported to Dart through the `getMetrics` method.
+
+// Records |value| under |name|, replacing any previous value.
+void splash_metrics_record(const gchar* name, gint64 value);
+
+typedef void (*SplashMetricsFunc)(const gchar* name,
+                                  gint64 value,
+                                  gpointer user_data);
+
+// Calls |func| for every recorded metric, in recording order.
+void splash_metrics_foreach(SplashMetricsFunc func, gpointer user_data);
+
+// Returns the resident set size of the process in bytes, or -1 if it can
+// not be read.
+gint64 splash_metrics_get_rss();
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_METRICS_H_
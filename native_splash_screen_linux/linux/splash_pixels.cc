@@ -0,0 +1,133 @@
+#include "splash_pixels.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPLASH_PIXELS_X86 1
+#endif
+
+// Looks up 4 indices per iteration, the compiler keeps the table in cache and
+// the loads independent.
+static void expand_palette_scalar(const uint8_t* indices,
+                                  size_t count,
+                                  const uint32_t* table,
+                                  uint32_t* out) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    out[i + 0] = table[indices[i + 0]];
+    out[i + 1] = table[indices[i + 1]];
+    out[i + 2] = table[indices[i + 2]];
+    out[i + 3] = table[indices[i + 3]];
+  }
+  for (; i < count; i++) {
+    out[i] = table[indices[i]];
+  }
+}
+
+#ifdef SPLASH_PIXELS_X86
+// Widens 8 indices to 32 bits and gathers their palette entries at once.
+__attribute__((target("avx2"))) static void expand_palette_avx2(
+    const uint8_t* indices,
+    size_t count,
+    const uint32_t* table,
+    uint32_t* out) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i packed =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i));
+    __m256i offsets = _mm256_cvtepu8_epi32(packed);
+    __m256i pixels = _mm256_i32gather_epi32(
+        reinterpret_cast<const int*>(table), offsets, 4);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), pixels);
+  }
+  expand_palette_scalar(indices + i, count - i, table, out + i);
+}
+#endif
+
+void splash_pixels_expand_palette(const uint8_t* indices,
+                                  size_t count,
+                                  const uint32_t* palette,
+                                  int palette_size,
+                                  uint32_t* out) {
+  splash_pixels_expand_palette_full(indices, count, palette, palette_size, out,
+                                    true);
+}
+
+void splash_pixels_expand_palette_full(const uint8_t* indices,
+                                       size_t count,
+                                       const uint32_t* palette,
+                                       int palette_size,
+                                       uint32_t* out,
+                                       bool simd) {
+  // A full 256 entries table lets every byte value be looked up unchecked
+  uint32_t table[256];
+  memset(table, 0, sizeof(table));
+  if (palette_size > 256) {
+    palette_size = 256;
+  }
+  if (palette != nullptr && palette_size > 0) {
+    memcpy(table, palette, palette_size * sizeof(uint32_t));
+  }
+
+#ifdef SPLASH_PIXELS_X86
+  if (simd && __builtin_cpu_supports("avx2")) {
+    expand_palette_avx2(indices, count, table, out);
+    return;
+  }
+#else
+  (void)simd;
+#endif
+
+  expand_palette_scalar(indices, count, table, out);
+}
+
+void splash_pixels_decode_tiles(const uint32_t* map,
+                                int tile_size,
+                                const uint8_t* tiles,
+                                const uint32_t* colors,
+                                int color_count,
+                                int width,
+                                int height,
+                                uint8_t* out,
+                                int stride) {
+  if (tile_size <= 0) {
+    return;
+  }
+
+  const size_t tile_stride = (size_t)tile_size * 4;
+  const size_t tile_bytes = tile_stride * tile_size;
+  const int columns = (width + tile_size - 1) / tile_size;
+  const int rows = (height + tile_size - 1) / tile_size;
+
+  for (int ty = 0; ty < rows; ty++) {
+    const int y0 = ty * tile_size;
+    const int h = height - y0 < tile_size ? height - y0 : tile_size;
+
+    for (int tx = 0; tx < columns; tx++) {
+      const int x0 = tx * tile_size;
+      const int w = width - x0 < tile_size ? width - x0 : tile_size;
+      const uint32_t entry = map[(size_t)ty * columns + tx];
+      uint8_t* dst = out + (size_t)y0 * stride + (size_t)x0 * 4;
+
+      if (entry & SPLASH_TILE_SOLID) {
+        const uint32_t index = entry & ~SPLASH_TILE_SOLID;
+        const uint32_t color =
+            (int)index < color_count ? colors[index] : 0x00000000;
+        for (int y = 0; y < h; y++) {
+          uint32_t* row = reinterpret_cast<uint32_t*>(dst + (size_t)y * stride);
+          for (int x = 0; x < w; x++) {
+            row[x] = color;
+          }
+        }
+        continue;
+      }
+
+      const uint8_t* src = tiles + (size_t)entry * tile_bytes;
+      for (int y = 0; y < h; y++) {
+        memcpy(dst + (size_t)y * stride, src + (size_t)y * tile_stride,
+               (size_t)w * 4);
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_PIXELS_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_PIXELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Pixel kernels used to decode the embedded splash assets.
+//
+// These only depend on the C++ standard library so they can be reused by
+// every decoding path (embedded, mapped or cached assets).
+
+// Pixel formats of the embedded image data
+enum SplashPixelFormat {
+  // 4 bytes per pixel, B G R A in memory
+  SPLASH_PIXEL_FORMAT_ARGB32 = 0,
+  // 1 byte per pixel, indices into an ARGB palette of up to 256 entries
+  SPLASH_PIXEL_FORMAT_INDEXED8 = 1,
+  // Square ARGB tiles from a blob shared by every flavor, laid out by a map
+  SPLASH_PIXEL_FORMAT_TILED = 2,
+  // Display list of vector operations, drawn at the scale of the display
+  SPLASH_PIXEL_FORMAT_VECTOR = 3,
+};
+
+// Set on tile map entries that fill their tile with a single color, the low
+// bits then index the color table instead of the tile blob.
+#define SPLASH_TILE_SOLID 0x80000000u
+
+// Expands |count| palette indices into ARGB pixels.
+//
+// |palette| holds |palette_size| entries, indices past its end expand to
+// transparent pixels. Uses AVX2 gathers when the CPU supports them.
+void splash_pixels_expand_palette(const uint8_t* indices,
+                                  size_t count,
+                                  const uint32_t* palette,
+                                  int palette_size,
+                                  uint32_t* out);
+
+// Same as splash_pixels_expand_palette(), with the AVX2 gathers only when
+// |simd| is true and the CPU supports them. Meant for tests.
+void splash_pixels_expand_palette_full(const uint8_t* indices,
+                                       size_t count,
+                                       const uint32_t* palette,
+                                       int palette_size,
+                                       uint32_t* out,
+                                       bool simd);
+
+// Assembles a tiled image into |out|, a |width| x |height| ARGB buffer with
+// |stride| bytes per row.
+//
+// |map| holds one entry per |tile_size| x |tile_size| tile, row by row. An
+// entry is either the index of a tile in |tiles|, or SPLASH_TILE_SOLID ored
+// with the index of its color in |colors|. Tiles on the right and bottom
+// edges are clipped to the image.
+void splash_pixels_decode_tiles(const uint32_t* map,
+                                int tile_size,
+                                const uint8_t* tiles,
+                                const uint32_t* colors,
+                                int color_count,
+                                int width,
+                                int height,
+                                uint8_t* out,
+                                int stride);
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_PIXELS_H_
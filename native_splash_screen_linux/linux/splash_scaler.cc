@@ -0,0 +1,439 @@
+#include "splash_scaler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPLASH_SCALER_X86 1
+#endif
+
+// Weights are fixed-point with 14 fractional bits, so a tap times a pixel
+// fits in 16 bits signed arithmetic on either side of the product
+#define SPLASH_SCALER_WEIGHT_BITS 14
+#define SPLASH_SCALER_WEIGHT_ONE (1 << SPLASH_SCALER_WEIGHT_BITS)
+
+// Images with fewer output pixels are scaled on the calling thread, where
+// starting threads would cost more than it saves
+#define SPLASH_SCALER_PARALLEL_PIXELS (256 * 256)
+#define SPLASH_SCALER_MAX_THREADS 8
+
+// Source pixels contributing to every output pixel of one dimension. Each
+// output pixel reads |taps| consecutive source pixels from |first|, the
+// windows never go past the edge of the source.
+struct SplashContributions {
+  int taps;
+  std::vector<int> first;
+  std::vector<int16_t> weights;
+};
+
+static double filter_support(SplashScaleFilter filter) {
+  switch (filter) {
+    case SPLASH_SCALE_FILTER_BOX:
+      return 0.5;
+    case SPLASH_SCALE_FILTER_BILINEAR:
+      return 1.0;
+    case SPLASH_SCALE_FILTER_LANCZOS2:
+      return 2.0;
+  }
+  return 1.0;
+}
+
+static double filter_weight(SplashScaleFilter filter, double x) {
+  x = fabs(x);
+  switch (filter) {
+    case SPLASH_SCALE_FILTER_BOX:
+      return x < 0.5 ? 1.0 : 0.0;
+    case SPLASH_SCALE_FILTER_BILINEAR:
+      return x < 1.0 ? 1.0 - x : 0.0;
+    case SPLASH_SCALE_FILTER_LANCZOS2: {
+      if (x < 1e-8) {
+        return 1.0;
+      }
+      if (x >= 2.0) {
+        return 0.0;
+      }
+      const double px = M_PI * x;
+      return 2.0 * sin(px) * sin(px / 2.0) / (px * px);
+    }
+  }
+  return 0.0;
+}
+
+// Computes the normalized fixed-point weights mapping |src_size| pixels to
+// |dst_size| pixels. When shrinking, the filter is stretched to cover every
+// source pixel.
+static void compute_contributions(int src_size,
+                                  int dst_size,
+                                  SplashScaleFilter filter,
+                                  SplashContributions* out) {
+  const double scale = (double)dst_size / src_size;
+  const double filter_scale = scale < 1.0 ? 1.0 / scale : 1.0;
+  const double support = filter_support(filter) * filter_scale;
+
+  const int taps = std::min((int)ceil(support * 2.0) + 2, src_size);
+  out->taps = taps;
+  out->first.assign(dst_size, 0);
+  out->weights.assign((size_t)dst_size * taps, 0);
+
+  std::vector<double> values(taps);
+  for (int i = 0; i < dst_size; i++) {
+    const double center = (i + 0.5) / scale;
+    const int left = std::max((int)floor(center - support), 0);
+    const int right = std::min((int)ceil(center + support), left + taps);
+    const int first = std::min(left, src_size - taps);
+
+    std::fill(values.begin(), values.end(), 0.0);
+    double sum = 0.0;
+    for (int j = left; j < right && j < src_size; j++) {
+      const double value =
+          filter_weight(filter, (j + 0.5 - center) / filter_scale);
+      values[j - first] = value;
+      sum += value;
+    }
+
+    // Nothing under the filter, fall back to the nearest source pixel
+    if (sum == 0.0) {
+      const int nearest = std::min((int)center, src_size - 1);
+      values[nearest - first] = 1.0;
+      sum = 1.0;
+    }
+
+    int16_t* weights = &out->weights[(size_t)i * taps];
+    int total = 0;
+    int largest = 0;
+    for (int k = 0; k < taps; k++) {
+      weights[k] = (int16_t)lround(values[k] / sum * SPLASH_SCALER_WEIGHT_ONE);
+      total += weights[k];
+      if (weights[k] > weights[largest]) {
+        largest = k;
+      }
+    }
+
+    // Rounding must not change the brightness of flat areas
+    weights[largest] += SPLASH_SCALER_WEIGHT_ONE - total;
+    out->first[i] = first;
+  }
+}
+
+// Rounds a fixed-point channel sum back to a byte.
+static inline uint8_t clamp_channel(int value) {
+  value = (value + SPLASH_SCALER_WEIGHT_ONE / 2) >> SPLASH_SCALER_WEIGHT_BITS;
+  return (uint8_t)std::min(std::max(value, 0), 255);
+}
+
+// Stores a pixel, keeping the colors premultiplied: negative lobes can
+// otherwise push a color above its alpha.
+static inline void store_pixel(uint8_t* out, const int* sums) {
+  const uint8_t alpha = clamp_channel(sums[3]);
+  for (int c = 0; c < 3; c++) {
+    out[c] = std::min(clamp_channel(sums[c]), alpha);
+  }
+  out[3] = alpha;
+}
+
+// Computes output pixel |x| of a horizontal pass over |row|.
+static inline void resample_row_pixel(const uint8_t* row,
+                                      const SplashContributions& columns,
+                                      int x,
+                                      uint8_t* out) {
+  const int taps = columns.taps;
+  const uint8_t* pixel = row + (size_t)columns.first[x] * 4;
+  const int16_t* weights = &columns.weights[(size_t)x * taps];
+  int sums[4] = {0, 0, 0, 0};
+  for (int k = 0; k < taps; k++) {
+    for (int c = 0; c < 4; c++) {
+      sums[c] += pixel[k * 4 + c] * weights[k];
+    }
+  }
+  store_pixel(out + (size_t)x * 4, sums);
+}
+
+static void resample_rows_scalar(const uint8_t* src,
+                                 int src_stride,
+                                 uint8_t* dst,
+                                 int dst_stride,
+                                 int width,
+                                 const SplashContributions& columns,
+                                 int begin,
+                                 int end) {
+  for (int y = begin; y < end; y++) {
+    const uint8_t* row = src + (size_t)y * src_stride;
+    uint8_t* out = dst + (size_t)y * dst_stride;
+    for (int x = 0; x < width; x++) {
+      resample_row_pixel(row, columns, x, out);
+    }
+  }
+}
+
+static void resample_columns_scalar(const uint8_t* src,
+                                    int src_stride,
+                                    uint8_t* dst,
+                                    int dst_stride,
+                                    int width,
+                                    const SplashContributions& rows,
+                                    int begin,
+                                    int end) {
+  const int taps = rows.taps;
+  for (int y = begin; y < end; y++) {
+    const uint8_t* first = src + (size_t)rows.first[y] * src_stride;
+    const int16_t* weights = &rows.weights[(size_t)y * taps];
+    uint8_t* out = dst + (size_t)y * dst_stride;
+
+    for (int x = 0; x < width; x++) {
+      int sums[4] = {0, 0, 0, 0};
+      for (int k = 0; k < taps; k++) {
+        const uint8_t* pixel = first + (size_t)k * src_stride + (size_t)x * 4;
+        for (int c = 0; c < 4; c++) {
+          sums[c] += pixel[c] * weights[k];
+        }
+      }
+      store_pixel(out + (size_t)x * 4, sums);
+    }
+  }
+}
+
+#ifdef SPLASH_SCALER_X86
+// Rounds 4 vectors of fixed-point sums back to 16 premultiplied bytes.
+__attribute__((target("sse4.1"))) static inline __m128i pack_pixels(
+    __m128i p0,
+    __m128i p1,
+    __m128i p2,
+    __m128i p3) {
+  const __m128i half = _mm_set1_epi32(SPLASH_SCALER_WEIGHT_ONE / 2);
+  p0 = _mm_srai_epi32(_mm_add_epi32(p0, half), SPLASH_SCALER_WEIGHT_BITS);
+  p1 = _mm_srai_epi32(_mm_add_epi32(p1, half), SPLASH_SCALER_WEIGHT_BITS);
+  p2 = _mm_srai_epi32(_mm_add_epi32(p2, half), SPLASH_SCALER_WEIGHT_BITS);
+  p3 = _mm_srai_epi32(_mm_add_epi32(p3, half), SPLASH_SCALER_WEIGHT_BITS);
+  const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(p0, p1),
+                                         _mm_packs_epi32(p2, p3));
+
+  // Broadcast every alpha over its pixel and clamp the colors to it
+  const __m128i alpha = _mm_shuffle_epi8(
+      bytes, _mm_set_epi8(15, 15, 15, 15, 11, 11, 11, 11, 7, 7, 7, 7, 3, 3, 3,
+                          3));
+  return _mm_min_epu8(bytes, alpha);
+}
+
+// Widens one pixel to 4 lanes and accumulates it times |weight|.
+__attribute__((target("sse4.1"))) static inline __m128i accumulate_pixel(
+    __m128i sum,
+    const uint8_t* pixel,
+    __m128i weight) {
+  int value;
+  memcpy(&value, pixel, sizeof(value));
+  const __m128i lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(value));
+  return _mm_add_epi32(sum, _mm_mullo_epi32(lanes, weight));
+}
+
+__attribute__((target("sse4.1"))) static void resample_rows_sse41(
+    const uint8_t* src,
+    int src_stride,
+    uint8_t* dst,
+    int dst_stride,
+    int width,
+    const SplashContributions& columns,
+    int begin,
+    int end) {
+  const int taps = columns.taps;
+  for (int y = begin; y < end; y++) {
+    const uint8_t* row = src + (size_t)y * src_stride;
+    uint8_t* out = dst + (size_t)y * dst_stride;
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+      __m128i sums[4];
+      for (int i = 0; i < 4; i++) {
+        const uint8_t* pixel = row + (size_t)columns.first[x + i] * 4;
+        const int16_t* weights = &columns.weights[(size_t)(x + i) * taps];
+        sums[i] = _mm_setzero_si128();
+        for (int k = 0; k < taps; k++) {
+          sums[i] = accumulate_pixel(sums[i], pixel + k * 4,
+                                     _mm_set1_epi32(weights[k]));
+        }
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (size_t)x * 4),
+                       pack_pixels(sums[0], sums[1], sums[2], sums[3]));
+    }
+
+    // Remaining pixels of the row
+    for (; x < width; x++) {
+      resample_row_pixel(row, columns, x, out);
+    }
+  }
+}
+
+__attribute__((target("sse4.1"))) static void resample_columns_sse41(
+    const uint8_t* src,
+    int src_stride,
+    uint8_t* dst,
+    int dst_stride,
+    int width,
+    const SplashContributions& rows,
+    int begin,
+    int end) {
+  const int taps = rows.taps;
+  for (int y = begin; y < end; y++) {
+    const uint8_t* first = src + (size_t)rows.first[y] * src_stride;
+    const int16_t* weights = &rows.weights[(size_t)y * taps];
+    uint8_t* out = dst + (size_t)y * dst_stride;
+
+    // 4 pixels at a time, the 16 channels are multiplied as 16-bit lanes and
+    // the high and low halves of the products interleaved back to 32 bits
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+      __m128i sum0 = _mm_setzero_si128();
+      __m128i sum1 = _mm_setzero_si128();
+      __m128i sum2 = _mm_setzero_si128();
+      __m128i sum3 = _mm_setzero_si128();
+      for (int k = 0; k < taps; k++) {
+        const __m128i weight = _mm_set1_epi16(weights[k]);
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+            first + (size_t)k * src_stride + (size_t)x * 4));
+        const __m128i lo = _mm_cvtepu8_epi16(pixels);
+        const __m128i hi = _mm_cvtepu8_epi16(_mm_srli_si128(pixels, 8));
+
+        const __m128i lo_low = _mm_mullo_epi16(lo, weight);
+        const __m128i lo_high = _mm_mulhi_epi16(lo, weight);
+        const __m128i hi_low = _mm_mullo_epi16(hi, weight);
+        const __m128i hi_high = _mm_mulhi_epi16(hi, weight);
+        sum0 = _mm_add_epi32(sum0, _mm_unpacklo_epi16(lo_low, lo_high));
+        sum1 = _mm_add_epi32(sum1, _mm_unpackhi_epi16(lo_low, lo_high));
+        sum2 = _mm_add_epi32(sum2, _mm_unpacklo_epi16(hi_low, hi_high));
+        sum3 = _mm_add_epi32(sum3, _mm_unpackhi_epi16(hi_low, hi_high));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (size_t)x * 4),
+                       pack_pixels(sum0, sum1, sum2, sum3));
+    }
+
+    // Remaining pixels of the row
+    for (; x < width; x++) {
+      int sums[4] = {0, 0, 0, 0};
+      for (int k = 0; k < taps; k++) {
+        const uint8_t* pixel = first + (size_t)k * src_stride + (size_t)x * 4;
+        for (int c = 0; c < 4; c++) {
+          sums[c] += pixel[c] * weights[k];
+        }
+      }
+      store_pixel(out + (size_t)x * 4, sums);
+    }
+  }
+}
+#endif
+
+typedef void (*SplashResampleFunc)(const uint8_t* src,
+                                   int src_stride,
+                                   uint8_t* dst,
+                                   int dst_stride,
+                                   int width,
+                                   const SplashContributions& contributions,
+                                   int begin,
+                                   int end);
+
+// Runs |func| over rows [0, |count|) split in |threads| bands, the calling
+// thread takes the first band. Bands whose thread cannot be started run on
+// the calling thread too.
+static void run_in_bands(SplashResampleFunc func,
+                         const uint8_t* src,
+                         int src_stride,
+                         uint8_t* dst,
+                         int dst_stride,
+                         int width,
+                         const SplashContributions& contributions,
+                         int count,
+                         int threads) {
+  const int band = (count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  int begin = band;
+  try {
+    workers.reserve(threads);
+    for (; begin < count; begin += band) {
+      workers.emplace_back(func, src, src_stride, dst, dst_stride, width,
+                           std::cref(contributions), begin,
+                           std::min(begin + band, count));
+    }
+  } catch (...) {
+  }
+
+  func(src, src_stride, dst, dst_stride, width, contributions, 0,
+       std::min(band, count));
+  if (begin < count) {
+    func(src, src_stride, dst, dst_stride, width, contributions, begin, count);
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+bool splash_scaler_resample(const uint8_t* src,
+                            int src_width,
+                            int src_height,
+                            int src_stride,
+                            uint8_t* dst,
+                            int dst_width,
+                            int dst_height,
+                            int dst_stride,
+                            SplashScaleFilter filter) {
+  int threads = 1;
+  if ((long)dst_width * dst_height >= SPLASH_SCALER_PARALLEL_PIXELS) {
+    threads = std::min((int)std::thread::hardware_concurrency(),
+                       SPLASH_SCALER_MAX_THREADS);
+    threads = std::max(threads, 1);
+  }
+
+  return splash_scaler_resample_full(src, src_width, src_height, src_stride,
+                                     dst, dst_width, dst_height, dst_stride,
+                                     filter, threads, true);
+}
+
+bool splash_scaler_resample_full(const uint8_t* src,
+                                 int src_width,
+                                 int src_height,
+                                 int src_stride,
+                                 uint8_t* dst,
+                                 int dst_width,
+                                 int dst_height,
+                                 int dst_stride,
+                                 SplashScaleFilter filter,
+                                 int threads,
+                                 bool simd) {
+  if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0 ||
+      threads <= 0) {
+    return false;
+  }
+
+  SplashResampleFunc rows_func = resample_rows_scalar;
+  SplashResampleFunc columns_func = resample_columns_scalar;
+#ifdef SPLASH_SCALER_X86
+  if (simd && __builtin_cpu_supports("sse4.1")) {
+    rows_func = resample_rows_sse41;
+    columns_func = resample_columns_sse41;
+  }
+#else
+  (void)simd;
+#endif
+
+  try {
+    SplashContributions columns;
+    SplashContributions rows;
+    compute_contributions(src_width, dst_width, filter, &columns);
+    compute_contributions(src_height, dst_height, filter, &rows);
+
+    // Horizontal pass into a buffer of |dst_width| x |src_height| pixels,
+    // then vertical pass into the destination
+    const int tmp_stride = dst_width * 4;
+    std::vector<uint8_t> tmp((size_t)tmp_stride * src_height);
+    run_in_bands(rows_func, src, src_stride, tmp.data(), tmp_stride,
+                 dst_width, columns, src_height, threads);
+    run_in_bands(columns_func, tmp.data(), tmp_stride, dst, dst_stride,
+                 dst_width, rows, dst_height, threads);
+  } catch (const std::bad_alloc&) {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,56 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCALER_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCALER_H_
+
+#include <stdint.h>
+
+// Resampling of premultiplied ARGB images.
+//
+// The image is scaled in two separable passes, horizontally then vertically,
+// with fixed-point weights computed once per output row and column. Both
+// passes use SSE4.1 when the CPU supports it, and large images are split in
+// bands across the available cores.
+//
+// Like splash_pixels, this only depends on the C++ standard library.
+
+enum SplashScaleFilter {
+  // Area average, the sharpest choice when shrinking by 2 or more
+  SPLASH_SCALE_FILTER_BOX = 0,
+  // Tent filter over the 2 nearest pixels
+  SPLASH_SCALE_FILTER_BILINEAR = 1,
+  // Windowed sinc over the 4 nearest pixels, keeps edges sharp
+  SPLASH_SCALE_FILTER_LANCZOS2 = 2,
+};
+
+// Resamples |src|, |src_width| x |src_height| pixels with |src_stride| bytes
+// per row, into |dst|, |dst_width| x |dst_height| pixels with |dst_stride|
+// bytes per row. Pixels are 4 bytes, B G R A in memory, premultiplied.
+//
+// Returns false if the sizes are invalid or memory runs out, |dst| is then
+// left untouched.
+bool splash_scaler_resample(const uint8_t* src,
+                            int src_width,
+                            int src_height,
+                            int src_stride,
+                            uint8_t* dst,
+                            int dst_width,
+                            int dst_height,
+                            int dst_stride,
+                            SplashScaleFilter filter);
+
+// Same as splash_scaler_resample(), split in |threads| bands and with the
+// SIMD kernels only when |simd| is true and the CPU supports them, where
+// splash_scaler_resample() picks both from the image size and the CPU. Meant
+// for benchmarks and tests.
+bool splash_scaler_resample_full(const uint8_t* src,
+                                 int src_width,
+                                 int src_height,
+                                 int src_stride,
+                                 uint8_t* dst,
+                                 int dst_width,
+                                 int dst_height,
+                                 int dst_stride,
+                                 SplashScaleFilter filter,
+                                 int threads,
+                                 bool simd);
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCALER_H_
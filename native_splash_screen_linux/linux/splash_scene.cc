@@ -0,0 +1,342 @@
+#include "splash_scene.h"
+
+#include <math.h>
+
+struct _SplashLayer {
+  SplashScene* scene;
+  gchar* name;
+
+  cairo_rectangle_int_t bounds;
+  cairo_matrix_t transform;
+  double opacity;
+  gboolean visible;
+
+  // Content cache, re-rendered only when |content_dirty| is set.
+  gboolean cached;
+  gboolean content_dirty;
+  cairo_surface_t* cache;
+
+  SplashLayerPaintFunc paint;
+  gpointer user_data;
+  GDestroyNotify destroy;
+};
+
+struct _SplashScene {
+  int width;
+  int height;
+  GPtrArray* layers;
+  cairo_region_t* damage;
+};
+
+static void splash_layer_free(gpointer data) {
+  SplashLayer* layer = static_cast<SplashLayer*>(data);
+  if (layer->cache != nullptr) {
+    cairo_surface_destroy(layer->cache);
+  }
+  if (layer->destroy != nullptr && layer->user_data != nullptr) {
+    layer->destroy(layer->user_data);
+  }
+  g_free(layer->name);
+  g_free(layer);
+}
+
+// Computes the area covered by |rect|, in layer space, in scene coordinates.
+static void splash_layer_map_rect(SplashLayer* layer,
+                                  const cairo_rectangle_int_t* rect,
+                                  cairo_rectangle_int_t* extents) {
+  const int left = layer->bounds.x + rect->x;
+  const int top = layer->bounds.y + rect->y;
+  const double xs[2] = {(double)left, (double)(left + rect->width)};
+  const double ys[2] = {(double)top, (double)(top + rect->height)};
+
+  double min_x = G_MAXDOUBLE, min_y = G_MAXDOUBLE;
+  double max_x = -G_MAXDOUBLE, max_y = -G_MAXDOUBLE;
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 2; j++) {
+      double x = xs[i];
+      double y = ys[j];
+      cairo_matrix_transform_point(&layer->transform, &x, &y);
+      min_x = MIN(min_x, x);
+      min_y = MIN(min_y, y);
+      max_x = MAX(max_x, x);
+      max_y = MAX(max_y, y);
+    }
+  }
+
+  extents->x = (int)floor(min_x);
+  extents->y = (int)floor(min_y);
+  extents->width = (int)ceil(max_x) - extents->x;
+  extents->height = (int)ceil(max_y) - extents->y;
+}
+
+// Computes the area covered by the layer in scene coordinates.
+static void splash_layer_get_extents(SplashLayer* layer,
+                                     cairo_rectangle_int_t* extents) {
+  const cairo_rectangle_int_t rect = {0, 0, layer->bounds.width,
+                                      layer->bounds.height};
+  splash_layer_map_rect(layer, &rect, extents);
+}
+
+// Adds the current extents of the layer to the scene damage.
+static void splash_layer_damage(SplashLayer* layer) {
+  if (!layer->visible || layer->opacity <= 0.0) {
+    return;
+  }
+
+  cairo_rectangle_int_t extents;
+  splash_layer_get_extents(layer, &extents);
+  cairo_region_union_rectangle(layer->scene->damage, &extents);
+}
+
+SplashScene* splash_scene_new(int width, int height) {
+  SplashScene* scene = g_new0(SplashScene, 1);
+  scene->width = width;
+  scene->height = height;
+  scene->layers = g_ptr_array_new_with_free_func(splash_layer_free);
+  scene->damage = cairo_region_create();
+  return scene;
+}
+
+void splash_scene_free(SplashScene* scene) {
+  if (scene == nullptr) {
+    return;
+  }
+  g_ptr_array_unref(scene->layers);
+  cairo_region_destroy(scene->damage);
+  g_free(scene);
+}
+
+SplashLayer* splash_scene_add_layer(SplashScene* scene,
+                                    const gchar* name,
+                                    const cairo_rectangle_int_t* bounds,
+                                    SplashLayerPaintFunc paint,
+                                    gpointer user_data,
+                                    GDestroyNotify destroy) {
+  SplashLayer* layer = g_new0(SplashLayer, 1);
+  layer->scene = scene;
+  layer->name = g_strdup(name);
+  layer->bounds = *bounds;
+  cairo_matrix_init_identity(&layer->transform);
+  layer->opacity = 1.0;
+  layer->visible = TRUE;
+  layer->cached = TRUE;
+  layer->content_dirty = TRUE;
+  layer->paint = paint;
+  layer->user_data = user_data;
+  layer->destroy = destroy;
+
+  g_ptr_array_add(scene->layers, layer);
+  splash_layer_damage(layer);
+  return layer;
+}
+
+SplashLayer* splash_scene_get_layer(SplashScene* scene, const gchar* name) {
+  for (guint i = 0; i < scene->layers->len; i++) {
+    SplashLayer* layer =
+        static_cast<SplashLayer*>(g_ptr_array_index(scene->layers, i));
+    if (g_strcmp0(layer->name, name) == 0) {
+      return layer;
+    }
+  }
+  return nullptr;
+}
+
+void splash_scene_foreach_layer(SplashScene* scene,
+                                SplashLayerFunc func,
+                                gpointer user_data) {
+  for (guint i = 0; i < scene->layers->len; i++) {
+    func(static_cast<SplashLayer*>(g_ptr_array_index(scene->layers, i)),
+         user_data);
+  }
+}
+
+const gchar* splash_layer_get_name(SplashLayer* layer) {
+  return layer->name;
+}
+
+void splash_layer_set_cached(SplashLayer* layer, gboolean cached) {
+  if (layer->cached == cached) {
+    return;
+  }
+  layer->cached = cached;
+  if (!cached && layer->cache != nullptr) {
+    cairo_surface_destroy(layer->cache);
+    layer->cache = nullptr;
+  }
+  layer->content_dirty = TRUE;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_set_bounds(SplashLayer* layer,
+                             const cairo_rectangle_int_t* bounds) {
+  if (layer->bounds.x == bounds->x && layer->bounds.y == bounds->y &&
+      layer->bounds.width == bounds->width &&
+      layer->bounds.height == bounds->height) {
+    return;
+  }
+
+  // A size change needs a new cache, a move only needs repainting.
+  if (layer->bounds.width != bounds->width ||
+      layer->bounds.height != bounds->height) {
+    layer->content_dirty = TRUE;
+  }
+
+  splash_layer_damage(layer);
+  layer->bounds = *bounds;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_set_opacity(SplashLayer* layer, double opacity) {
+  opacity = CLAMP(opacity, 0.0, 1.0);
+  if (layer->opacity == opacity) {
+    return;
+  }
+
+  splash_layer_damage(layer);
+  layer->opacity = opacity;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_set_transform(SplashLayer* layer,
+                                const cairo_matrix_t* transform) {
+  splash_layer_damage(layer);
+  layer->transform = *transform;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_set_visible(SplashLayer* layer, gboolean visible) {
+  if (layer->visible == visible) {
+    return;
+  }
+
+  splash_layer_damage(layer);
+  layer->visible = visible;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_invalidate(SplashLayer* layer) {
+  layer->content_dirty = TRUE;
+  splash_layer_damage(layer);
+}
+
+void splash_layer_invalidate_rect(SplashLayer* layer,
+                                  const cairo_rectangle_int_t* rect) {
+  if (layer->cached) {
+    splash_layer_invalidate(layer);
+    return;
+  }
+  if (!layer->visible || layer->opacity <= 0.0) {
+    return;
+  }
+
+  cairo_rectangle_int_t extents;
+  splash_layer_map_rect(layer, rect, &extents);
+  cairo_region_union_rectangle(layer->scene->damage, &extents);
+}
+
+cairo_region_t* splash_scene_take_damage(SplashScene* scene) {
+  cairo_region_t* damage = scene->damage;
+  scene->damage = cairo_region_create();
+
+  // Nothing outside of the scene can ever be painted.
+  cairo_rectangle_int_t area = {0, 0, scene->width, scene->height};
+  cairo_region_intersect_rectangle(damage, &area);
+  return damage;
+}
+
+gboolean splash_scene_has_damage(SplashScene* scene) {
+  return !cairo_region_is_empty(scene->damage);
+}
+
+// Re-renders the layer content into its cache if it changed.
+//
+// The cache has the resolution of the target, so HiDPI content is not
+// downsampled into it.
+static void splash_layer_update_cache(SplashLayer* layer, cairo_t* target) {
+  const int width = layer->bounds.width;
+  const int height = layer->bounds.height;
+
+  double scale_x, scale_y;
+  cairo_surface_get_device_scale(cairo_get_target(target), &scale_x, &scale_y);
+  const int pixel_width = (int)ceil(width * scale_x);
+  const int pixel_height = (int)ceil(height * scale_y);
+
+  if (layer->cache != nullptr &&
+      (cairo_image_surface_get_width(layer->cache) != pixel_width ||
+       cairo_image_surface_get_height(layer->cache) != pixel_height)) {
+    cairo_surface_destroy(layer->cache);
+    layer->cache = nullptr;
+  }
+
+  if (layer->cache == nullptr) {
+    layer->cache = cairo_surface_create_similar_image(
+        cairo_get_target(target), CAIRO_FORMAT_ARGB32, pixel_width,
+        pixel_height);
+    cairo_surface_set_device_scale(layer->cache, scale_x, scale_y);
+    layer->content_dirty = TRUE;
+  }
+
+  if (!layer->content_dirty) {
+    return;
+  }
+
+  cairo_t* cr = cairo_create(layer->cache);
+  cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint(cr);
+  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+  layer->paint(cr, width, height, layer->user_data);
+  cairo_destroy(cr);
+
+  layer->content_dirty = FALSE;
+}
+
+void splash_scene_draw(SplashScene* scene, cairo_t* cr) {
+  double x1, y1, x2, y2;
+  cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+  cairo_region_t* clip = cairo_region_create();
+  cairo_rectangle_int_t clip_rect = {
+      (int)floor(x1), (int)floor(y1), (int)ceil(x2) - (int)floor(x1),
+      (int)ceil(y2) - (int)floor(y1)};
+  cairo_region_union_rectangle(clip, &clip_rect);
+
+  for (guint i = 0; i < scene->layers->len; i++) {
+    SplashLayer* layer =
+        static_cast<SplashLayer*>(g_ptr_array_index(scene->layers, i));
+    if (!layer->visible || layer->opacity <= 0.0 || layer->bounds.width <= 0 ||
+        layer->bounds.height <= 0) {
+      continue;
+    }
+
+    cairo_rectangle_int_t extents;
+    splash_layer_get_extents(layer, &extents);
+    if (cairo_region_contains_rectangle(clip, &extents) ==
+        CAIRO_REGION_OVERLAP_OUT) {
+      continue;
+    }
+
+    cairo_save(cr);
+    cairo_transform(cr, &layer->transform);
+    cairo_translate(cr, layer->bounds.x, layer->bounds.y);
+    cairo_rectangle(cr, 0, 0, layer->bounds.width, layer->bounds.height);
+    cairo_clip(cr);
+
+    if (layer->cached) {
+      splash_layer_update_cache(layer, cr);
+      cairo_set_source_surface(cr, layer->cache, 0, 0);
+      cairo_paint_with_alpha(cr, layer->opacity);
+    } else if (layer->opacity < 1.0) {
+      cairo_push_group(cr);
+      layer->paint(cr, layer->bounds.width, layer->bounds.height,
+                   layer->user_data);
+      cairo_pop_group_to_source(cr);
+      cairo_paint_with_alpha(cr, layer->opacity);
+    } else {
+      layer->paint(cr, layer->bounds.width, layer->bounds.height,
+                   layer->user_data);
+    }
+
+    cairo_restore(cr);
+  }
+
+  cairo_region_destroy(clip);
+}
@@ -0,0 +1,81 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCENE_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCENE_H_
+
+#include <cairo.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// A small retained scene for the splash window.
+//
+// The scene owns an ordered list of layers (background, logo, spinner, ...).
+// Every layer has bounds, an opacity and a transform, and renders its content
+// once into a cached surface. Changing a layer property only records damage;
+// the next draw repaints the damaged union and re-renders the caches of the
+// layers whose content was invalidated.
+
+typedef struct _SplashScene SplashScene;
+typedef struct _SplashLayer SplashLayer;
+
+// Paints the layer content in layer space, i.e. with (0, 0) at the top-left
+// corner of the layer bounds and a clip of |width| x |height|.
+typedef void (*SplashLayerPaintFunc)(cairo_t* cr,
+                                     int width,
+                                     int height,
+                                     gpointer user_data);
+
+SplashScene* splash_scene_new(int width, int height);
+void splash_scene_free(SplashScene* scene);
+
+// Appends a layer on top of the existing ones. The scene owns the layer,
+// |destroy| is called on |user_data| when the scene is freed.
+SplashLayer* splash_scene_add_layer(SplashScene* scene,
+                                    const gchar* name,
+                                    const cairo_rectangle_int_t* bounds,
+                                    SplashLayerPaintFunc paint,
+                                    gpointer user_data,
+                                    GDestroyNotify destroy);
+
+SplashLayer* splash_scene_get_layer(SplashScene* scene, const gchar* name);
+
+typedef void (*SplashLayerFunc)(SplashLayer* layer, gpointer user_data);
+
+// Calls |func| on every layer, from the bottom to the top.
+void splash_scene_foreach_layer(SplashScene* scene,
+                                SplashLayerFunc func,
+                                gpointer user_data);
+
+const gchar* splash_layer_get_name(SplashLayer* layer);
+
+// Uncached layers call their paint function on every draw instead of going
+// through a cached surface. Useful for layers that already blit from their
+// own surfaces (sprite atlases, frame buffers).
+void splash_layer_set_cached(SplashLayer* layer, gboolean cached);
+void splash_layer_set_bounds(SplashLayer* layer,
+                             const cairo_rectangle_int_t* bounds);
+void splash_layer_set_opacity(SplashLayer* layer, double opacity);
+void splash_layer_set_transform(SplashLayer* layer,
+                                const cairo_matrix_t* transform);
+void splash_layer_set_visible(SplashLayer* layer, gboolean visible);
+
+// Marks the layer content as changed so its cache is re-rendered.
+void splash_layer_invalidate(SplashLayer* layer);
+
+// Marks |rect|, in layer space, as changed. Uncached layers only get that
+// area repainted, cached ones re-render their whole cache.
+void splash_layer_invalidate_rect(SplashLayer* layer,
+                                  const cairo_rectangle_int_t* rect);
+
+// Returns the union of all damage recorded since the last call, in scene
+// coordinates, and resets the accumulator. Free with cairo_region_destroy().
+cairo_region_t* splash_scene_take_damage(SplashScene* scene);
+
+// Returns TRUE if damage has been recorded since the last take.
+gboolean splash_scene_has_damage(SplashScene* scene);
+
+// Paints every visible layer intersecting the current clip of |cr|.
+void splash_scene_draw(SplashScene* scene, cairo_t* cr);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SCENE_H_
@@ -0,0 +1,106 @@
+#include "splash_spinner.h"
+
+#include <math.h>
+
+struct _SplashSpinner {
+  int size;
+  int frame_count;
+  int columns;
+  cairo_surface_t* atlas;
+};
+
+// Length of the arc, and number of segments its fading tail is drawn with.
+#define SPLASH_SPINNER_ARC (1.5 * G_PI)
+#define SPLASH_SPINNER_SEGMENTS 24
+
+// Draws the spinner turned by |angle| around the center of a |size| square:
+// an arc whose opacity fades from its head to its tail.
+static void draw_spinner(cairo_t* cr,
+                         int size,
+                         unsigned int color,
+                         double angle) {
+  const double line_width = MAX(size / 10.0, 1.0);
+  const double radius = (size - line_width) / 2.0;
+  const double red = ((color >> 16) & 0xFF) / 255.0;
+  const double green = ((color >> 8) & 0xFF) / 255.0;
+  const double blue = (color & 0xFF) / 255.0;
+  const double alpha = ((color >> 24) & 0xFF) / 255.0;
+
+  cairo_set_line_width(cr, line_width);
+  cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+  const double step = SPLASH_SPINNER_ARC / SPLASH_SPINNER_SEGMENTS;
+  for (int i = 0; i < SPLASH_SPINNER_SEGMENTS; i++) {
+    const double start = angle - SPLASH_SPINNER_ARC + i * step;
+    cairo_set_source_rgba(cr, red, green, blue,
+                          alpha * (i + 1) / SPLASH_SPINNER_SEGMENTS);
+    cairo_arc(cr, size / 2.0, size / 2.0, radius, start, start + step);
+    cairo_stroke(cr);
+  }
+
+  // Round head
+  cairo_set_source_rgba(cr, red, green, blue, alpha);
+  cairo_arc(cr, size / 2.0 + radius * cos(angle),
+            size / 2.0 + radius * sin(angle), line_width / 2.0, 0, 2 * G_PI);
+  cairo_fill(cr);
+}
+
+SplashSpinner* splash_spinner_new(int size,
+                                  unsigned int color,
+                                  int frame_count,
+                                  int scale) {
+  if (size <= 0 || frame_count <= 0 || scale <= 0) {
+    return nullptr;
+  }
+
+  // Square-ish grid of cells, keeps the atlas within the surface limits
+  const int columns = (int)ceil(sqrt((double)frame_count));
+  const int rows = (frame_count + columns - 1) / columns;
+  cairo_surface_t* atlas = cairo_image_surface_create(
+      CAIRO_FORMAT_ARGB32, columns * size * scale, rows * size * scale);
+  if (cairo_surface_status(atlas) != CAIRO_STATUS_SUCCESS) {
+    cairo_surface_destroy(atlas);
+    return nullptr;
+  }
+  cairo_surface_set_device_scale(atlas, scale, scale);
+
+  cairo_t* cr = cairo_create(atlas);
+  for (int frame = 0; frame < frame_count; frame++) {
+    cairo_save(cr);
+    cairo_translate(cr, (frame % columns) * size, (frame / columns) * size);
+    cairo_rectangle(cr, 0, 0, size, size);
+    cairo_clip(cr);
+    draw_spinner(cr, size, color, 2 * G_PI * frame / frame_count - G_PI / 2);
+    cairo_restore(cr);
+  }
+  cairo_destroy(cr);
+  cairo_surface_flush(atlas);
+
+  SplashSpinner* spinner = g_new0(SplashSpinner, 1);
+  spinner->size = size;
+  spinner->frame_count = frame_count;
+  spinner->columns = columns;
+  spinner->atlas = atlas;
+  return spinner;
+}
+
+void splash_spinner_free(SplashSpinner* spinner) {
+  if (spinner == nullptr) {
+    return;
+  }
+  cairo_surface_destroy(spinner->atlas);
+  g_free(spinner);
+}
+
+int splash_spinner_get_frame_count(SplashSpinner* spinner) {
+  return spinner->frame_count;
+}
+
+void splash_spinner_paint_frame(SplashSpinner* spinner,
+                                cairo_t* cr,
+                                int frame) {
+  const int x = (frame % spinner->columns) * spinner->size;
+  const int y = (frame / spinner->columns) * spinner->size;
+  cairo_set_source_surface(cr, spinner->atlas, -x, -y);
+  cairo_rectangle(cr, 0, 0, spinner->size, spinner->size);
+  cairo_fill(cr);
+}
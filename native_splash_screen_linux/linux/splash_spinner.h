@@ -0,0 +1,36 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SPINNER_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SPINNER_H_
+
+#include <cairo.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// An indeterminate loading spinner, drawn once per rotation step into an
+// atlas of pre-rotated frames.
+//
+// Showing a frame is a plain copy of one atlas cell at whole pixels, which
+// pixman does without any filtering, so every tick costs the same few
+// microseconds on software rendered sessions as well.
+typedef struct _SplashSpinner SplashSpinner;
+
+// Draws the |frame_count| frames of a |size| x |size| spinner of the ARGB
+// |color| at |scale| device pixels per logical pixel. Returns nullptr if the
+// atlas can not be allocated.
+SplashSpinner* splash_spinner_new(int size,
+                                  unsigned int color,
+                                  int frame_count,
+                                  int scale);
+
+void splash_spinner_free(SplashSpinner* spinner);
+
+int splash_spinner_get_frame_count(SplashSpinner* spinner);
+
+// Paints |frame| with its top-left corner at (0, 0) of |cr|.
+void splash_spinner_paint_frame(SplashSpinner* spinner,
+                                cairo_t* cr,
+                                int frame);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_SPINNER_H_
@@ -0,0 +1,86 @@
+#include "splash_theme.h"
+
+#include <gio/gio.h>
+#include <gtk/gtk.h>
+
+// Values of the `color-scheme` setting of the portal.
+enum {
+  kColorSchemeDefault = 0,
+  kColorSchemePreferDark = 1,
+  kColorSchemePreferLight = 2,
+};
+
+// The portal answers within a few milliseconds when it runs, the splash
+// must not wait on one that does not.
+#define SPLASH_THEME_PORTAL_TIMEOUT_MS 100
+
+// Reads the `color-scheme` of the settings portal, or returns -1 when it is
+// not available. The session bus connection is shared with the application,
+// which would open it anyway.
+static int read_portal_color_scheme() {
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GDBusConnection) connection =
+      g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, &error);
+  if (connection == nullptr) {
+    return -1;
+  }
+
+  // Not started on demand, the desktop runs it when it provides one
+  g_autoptr(GVariant) reply = g_dbus_connection_call_sync(
+      connection, "org.freedesktop.portal.Desktop",
+      "/org/freedesktop/portal/desktop", "org.freedesktop.portal.Settings",
+      "Read",
+      g_variant_new("(ss)", "org.freedesktop.appearance", "color-scheme"),
+      G_VARIANT_TYPE("(v)"), G_DBUS_CALL_FLAGS_NO_AUTO_START,
+      SPLASH_THEME_PORTAL_TIMEOUT_MS, nullptr, &error);
+  if (reply == nullptr) {
+    return -1;
+  }
+
+  // Older portals wrap the value in one more variant
+  g_autoptr(GVariant) value = nullptr;
+  g_variant_get(reply, "(v)", &value);
+  while (value != nullptr &&
+         g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT)) {
+    GVariant* inner = g_variant_get_variant(value);
+    g_variant_unref(value);
+    value = inner;
+  }
+  if (value == nullptr ||
+      !g_variant_is_of_type(value, G_VARIANT_TYPE_UINT32)) {
+    return -1;
+  }
+  return (int)g_variant_get_uint32(value);
+}
+
+gboolean splash_theme_prefers_dark() {
+  switch (read_portal_color_scheme()) {
+    case kColorSchemePreferDark:
+      return TRUE;
+    case kColorSchemePreferLight:
+      return FALSE;
+    case kColorSchemeDefault:
+    default:
+      break;
+  }
+
+  GtkSettings* settings = gtk_settings_get_default();
+  if (settings == nullptr) {
+    return FALSE;
+  }
+
+  gboolean prefer_dark = FALSE;
+  g_autofree gchar* theme_name = nullptr;
+  g_object_get(settings, "gtk-application-prefer-dark-theme", &prefer_dark,
+               "gtk-theme-name", &theme_name, nullptr);
+  if (prefer_dark) {
+    return TRUE;
+  }
+
+  // Dark variants of themes are named like `Adwaita-dark`
+  if (theme_name == nullptr) {
+    return FALSE;
+  }
+  g_autofree gchar* lower = g_ascii_strdown(theme_name, -1);
+  return g_str_has_suffix(lower, "-dark");
+}
@@ -0,0 +1,19 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_THEME_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_THEME_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Color scheme preferred by the desktop, so the splash can show the image
+// variant matching it before the window is mapped.
+
+// Returns TRUE if the desktop prefers a dark appearance: the `color-scheme`
+// of the settings portal, or without an answer from it, the
+// `gtk-application-prefer-dark-theme` setting and a `-dark` GTK theme.
+// GTK must be initialized.
+gboolean splash_theme_prefers_dark();
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_THEME_H_
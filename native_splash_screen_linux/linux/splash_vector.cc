@@ -0,0 +1,363 @@
+#include "splash_vector.h"
+
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+// Embedded header, every field is little-endian.
+struct SplashVectorHeader {
+  char magic[4];
+  uint32_t version;
+  int32_t width;
+  int32_t height;
+  uint32_t ops_size;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SplashVectorHeader) == 24,
+              "The vector image header is 24 bytes long");
+
+// Deepest nesting of saved states and groups, guards the state stack.
+#define SPLASH_VECTOR_MAX_DEPTH 64
+
+// Largest width or height accepted, same as the other embedded images.
+#define SPLASH_VECTOR_MAX_EXTENT 4096
+
+// Cursor over the operations, every read past their end marks it as failed
+// and returns 0.
+struct SplashVectorReader {
+  const guint8* data;
+  gsize size;
+  gsize position;
+  gboolean failed;
+};
+
+static gboolean can_read(SplashVectorReader* reader, gsize count) {
+  if (reader->failed || count > reader->size - reader->position) {
+    reader->failed = TRUE;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static guint8 read_u8(SplashVectorReader* reader) {
+  if (!can_read(reader, 1)) {
+    return 0;
+  }
+  return reader->data[reader->position++];
+}
+
+static uint32_t read_u32(SplashVectorReader* reader) {
+  uint32_t value = 0;
+  if (can_read(reader, sizeof(value))) {
+    memcpy(&value, reader->data + reader->position, sizeof(value));
+    reader->position += sizeof(value);
+  }
+  return value;
+}
+
+static double read_f32(SplashVectorReader* reader) {
+  float value = 0;
+  if (can_read(reader, sizeof(value))) {
+    memcpy(&value, reader->data + reader->position, sizeof(value));
+    reader->position += sizeof(value);
+  }
+  if (!isfinite(value)) {
+    reader->failed = TRUE;
+    return 0;
+  }
+  return value;
+}
+
+static void read_matrix(SplashVectorReader* reader, cairo_matrix_t* matrix) {
+  const double xx = read_f32(reader);
+  const double yx = read_f32(reader);
+  const double xy = read_f32(reader);
+  const double yy = read_f32(reader);
+  const double x0 = read_f32(reader);
+  const double y0 = read_f32(reader);
+  cairo_matrix_init(matrix, xx, yx, xy, yy, x0, y0);
+}
+
+static void add_color_stop(cairo_pattern_t* pattern,
+                           double offset,
+                           uint32_t argb) {
+  cairo_pattern_add_color_stop_rgba(
+      pattern, offset, ((argb >> 16) & 0xFF) / 255.0,
+      ((argb >> 8) & 0xFF) / 255.0, (argb & 0xFF) / 255.0,
+      ((argb >> 24) & 0xFF) / 255.0);
+}
+
+// Reads the operands of a SPLASH_VECTOR_OP_LINEAR or SPLASH_VECTOR_OP_RADIAL
+// operation into a new pattern. Returns nullptr if they are malformed.
+static cairo_pattern_t* read_gradient(SplashVectorReader* reader, guint8 op) {
+  cairo_pattern_t* pattern;
+  if (op == SPLASH_VECTOR_OP_LINEAR) {
+    const double x0 = read_f32(reader);
+    const double y0 = read_f32(reader);
+    const double x1 = read_f32(reader);
+    const double y1 = read_f32(reader);
+    pattern = cairo_pattern_create_linear(x0, y0, x1, y1);
+  } else {
+    // The focal point is the center of a zero radius start circle
+    const double fx = read_f32(reader);
+    const double fy = read_f32(reader);
+    const double cx = read_f32(reader);
+    const double cy = read_f32(reader);
+    const double radius = read_f32(reader);
+    pattern = cairo_pattern_create_radial(fx, fy, 0, cx, cy, radius);
+  }
+
+  cairo_matrix_t matrix;
+  read_matrix(reader, &matrix);
+  const guint8 extend = read_u8(reader);
+  const uint32_t count = read_u32(reader);
+  if (reader->failed || extend > CAIRO_EXTEND_PAD ||
+      count > (reader->size - reader->position) / 8) {
+    reader->failed = TRUE;
+    cairo_pattern_destroy(pattern);
+    return nullptr;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    const double offset = read_f32(reader);
+    add_color_stop(pattern, offset, read_u32(reader));
+  }
+
+  // The list stores the pattern to user space matrix, cairo wants the other
+  // way around
+  if (cairo_matrix_invert(&matrix) != CAIRO_STATUS_SUCCESS ||
+      cairo_pattern_status(pattern) != CAIRO_STATUS_SUCCESS) {
+    reader->failed = TRUE;
+    cairo_pattern_destroy(pattern);
+    return nullptr;
+  }
+  cairo_pattern_set_matrix(pattern, &matrix);
+  cairo_pattern_set_extend(pattern, (cairo_extend_t)extend);
+  return pattern;
+}
+
+static gboolean read_header(const guint8* data,
+                            gsize size,
+                            SplashVectorHeader* header,
+                            GError** error) {
+  if (data == nullptr || size < sizeof(SplashVectorHeader)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Splash vector image is too short");
+    return FALSE;
+  }
+
+  memcpy(header, data, sizeof(*header));
+  if (memcmp(header->magic, "NSSV", 4) != 0) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Not a splash vector image");
+    return FALSE;
+  }
+  if (header->version != SPLASH_VECTOR_VERSION) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                "Unsupported splash vector image version %u",
+                header->version);
+    return FALSE;
+  }
+
+  if (header->width <= 0 || header->height <= 0 ||
+      header->width > SPLASH_VECTOR_MAX_EXTENT ||
+      header->height > SPLASH_VECTOR_MAX_EXTENT ||
+      header->ops_size > size - sizeof(*header)) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Invalid splash vector image header");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+gboolean splash_vector_get_size(const guint8* data,
+                                gsize size,
+                                int* width,
+                                int* height,
+                                GError** error) {
+  SplashVectorHeader header;
+  if (!read_header(data, size, &header, error)) {
+    return FALSE;
+  }
+  *width = header.width;
+  *height = header.height;
+  return TRUE;
+}
+
+// Kinds of the entries of the state stack, a group also saves the state.
+enum SplashVectorState {
+  SPLASH_VECTOR_STATE_SAVE,
+  SPLASH_VECTOR_STATE_GROUP,
+};
+
+gboolean splash_vector_render(const guint8* data,
+                              gsize size,
+                              cairo_t* cr,
+                              GError** error) {
+  SplashVectorHeader header;
+  if (!read_header(data, size, &header, error)) {
+    return FALSE;
+  }
+
+  SplashVectorReader reader = {data + sizeof(header), header.ops_size, 0,
+                               FALSE};
+  guint8 stack[SPLASH_VECTOR_MAX_DEPTH];
+  int depth = 0;
+
+  cairo_save(cr);
+  cairo_new_path(cr);
+  while (!reader.failed && reader.position < reader.size) {
+    const guint8 op = read_u8(&reader);
+    switch (op) {
+      case SPLASH_VECTOR_OP_MOVE_TO: {
+        const double x = read_f32(&reader);
+        const double y = read_f32(&reader);
+        cairo_move_to(cr, x, y);
+        break;
+      }
+      case SPLASH_VECTOR_OP_LINE_TO: {
+        const double x = read_f32(&reader);
+        const double y = read_f32(&reader);
+        cairo_line_to(cr, x, y);
+        break;
+      }
+      case SPLASH_VECTOR_OP_CURVE_TO: {
+        double points[6];
+        for (double& point : points) {
+          point = read_f32(&reader);
+        }
+        cairo_curve_to(cr, points[0], points[1], points[2], points[3],
+                       points[4], points[5]);
+        break;
+      }
+      case SPLASH_VECTOR_OP_CLOSE_PATH:
+        cairo_close_path(cr);
+        break;
+      case SPLASH_VECTOR_OP_SAVE:
+      case SPLASH_VECTOR_OP_PUSH_GROUP:
+        if (depth == SPLASH_VECTOR_MAX_DEPTH) {
+          reader.failed = TRUE;
+          break;
+        }
+        if (op == SPLASH_VECTOR_OP_SAVE) {
+          stack[depth++] = SPLASH_VECTOR_STATE_SAVE;
+          cairo_save(cr);
+        } else {
+          stack[depth++] = SPLASH_VECTOR_STATE_GROUP;
+          cairo_push_group(cr);
+        }
+        break;
+      case SPLASH_VECTOR_OP_RESTORE:
+        if (depth == 0 || stack[depth - 1] != SPLASH_VECTOR_STATE_SAVE) {
+          reader.failed = TRUE;
+          break;
+        }
+        depth--;
+        cairo_restore(cr);
+        break;
+      case SPLASH_VECTOR_OP_POP_GROUP: {
+        const double alpha = read_f32(&reader);
+        if (reader.failed || depth == 0 ||
+            stack[depth - 1] != SPLASH_VECTOR_STATE_GROUP) {
+          reader.failed = TRUE;
+          break;
+        }
+        depth--;
+        cairo_pop_group_to_source(cr);
+        cairo_paint_with_alpha(cr, CLAMP(alpha, 0.0, 1.0));
+        break;
+      }
+      case SPLASH_VECTOR_OP_TRANSFORM: {
+        cairo_matrix_t matrix;
+        read_matrix(&reader, &matrix);
+        cairo_matrix_t inverse = matrix;
+        if (reader.failed ||
+            cairo_matrix_invert(&inverse) != CAIRO_STATUS_SUCCESS) {
+          reader.failed = TRUE;
+          break;
+        }
+        cairo_transform(cr, &matrix);
+        break;
+      }
+      case SPLASH_VECTOR_OP_SOLID: {
+        const uint32_t argb = read_u32(&reader);
+        cairo_set_source_rgba(cr, ((argb >> 16) & 0xFF) / 255.0,
+                              ((argb >> 8) & 0xFF) / 255.0,
+                              (argb & 0xFF) / 255.0,
+                              ((argb >> 24) & 0xFF) / 255.0);
+        break;
+      }
+      case SPLASH_VECTOR_OP_LINEAR:
+      case SPLASH_VECTOR_OP_RADIAL: {
+        cairo_pattern_t* pattern = read_gradient(&reader, op);
+        if (pattern != nullptr) {
+          cairo_set_source(cr, pattern);
+          cairo_pattern_destroy(pattern);
+        }
+        break;
+      }
+      case SPLASH_VECTOR_OP_FILL: {
+        const guint8 flags = read_u8(&reader);
+        if (reader.failed) {
+          break;
+        }
+        cairo_set_fill_rule(cr, flags & SPLASH_VECTOR_FILL_EVEN_ODD
+                                    ? CAIRO_FILL_RULE_EVEN_ODD
+                                    : CAIRO_FILL_RULE_WINDING);
+        if (flags & SPLASH_VECTOR_FILL_PRESERVE) {
+          cairo_fill_preserve(cr);
+        } else {
+          cairo_fill(cr);
+        }
+        break;
+      }
+      case SPLASH_VECTOR_OP_STROKE: {
+        const double width = read_f32(&reader);
+        const guint8 cap = read_u8(&reader);
+        const guint8 join = read_u8(&reader);
+        const double miter_limit = read_f32(&reader);
+        if (reader.failed || cap > CAIRO_LINE_CAP_SQUARE ||
+            join > CAIRO_LINE_JOIN_BEVEL) {
+          reader.failed = TRUE;
+          break;
+        }
+        cairo_set_line_width(cr, width);
+        cairo_set_line_cap(cr, (cairo_line_cap_t)cap);
+        cairo_set_line_join(cr, (cairo_line_join_t)join);
+        cairo_set_miter_limit(cr, miter_limit);
+        cairo_stroke(cr);
+        break;
+      }
+      default:
+        reader.failed = TRUE;
+        break;
+    }
+  }
+
+  // Unwinds what a malformed list left open
+  while (depth > 0) {
+    if (stack[--depth] == SPLASH_VECTOR_STATE_GROUP) {
+      cairo_pattern_destroy(cairo_pop_group(cr));
+    } else {
+      cairo_restore(cr);
+    }
+  }
+  cairo_new_path(cr);
+  const cairo_status_t status = cairo_status(cr);
+  cairo_restore(cr);
+
+  if (reader.failed) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "Malformed splash vector image at byte %" G_GSIZE_FORMAT,
+                sizeof(header) + reader.position);
+    return FALSE;
+  }
+  if (status != CAIRO_STATUS_SUCCESS) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                "Failed to draw the splash vector image: %s",
+                cairo_status_to_string(status));
+    return FALSE;
+  }
+  return TRUE;
+}
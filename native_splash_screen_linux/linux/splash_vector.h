@@ -0,0 +1,67 @@
+#ifndef FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_VECTOR_H_
+#define FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_VECTOR_H_
+
+#include <cairo.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// A vector image compiled by native_splash_screen_cli from an SVG file, as a
+// display list of cairo operations.
+//
+// The blob starts with a 24 bytes little-endian header:
+//
+//   magic "NSSV", version, width, height, operations size, reserved
+//
+// followed by the operations, each an opcode byte and its little-endian
+// operands (f32 coordinates, u32 ARGB colors, u8 enums). Coordinates are in
+// logical pixels of the width x height image, so replaying the list on a
+// context scaled by the display scale draws it sharp at any resolution.
+#define SPLASH_VECTOR_VERSION 1
+
+enum SplashVectorOp {
+  SPLASH_VECTOR_OP_MOVE_TO = 1,     // x, y
+  SPLASH_VECTOR_OP_LINE_TO = 2,     // x, y
+  SPLASH_VECTOR_OP_CURVE_TO = 3,    // x1, y1, x2, y2, x3, y3
+  SPLASH_VECTOR_OP_CLOSE_PATH = 4,  //
+  SPLASH_VECTOR_OP_SAVE = 5,        //
+  SPLASH_VECTOR_OP_RESTORE = 6,     //
+  SPLASH_VECTOR_OP_TRANSFORM = 7,   // xx, yx, xy, yy, x0, y0
+  SPLASH_VECTOR_OP_SOLID = 8,       // ARGB color
+  // x0, y0, x1, y1, pattern matrix, extend, stop count, stops
+  SPLASH_VECTOR_OP_LINEAR = 9,
+  // fx, fy, cx, cy, r, pattern matrix, extend, stop count, stops
+  SPLASH_VECTOR_OP_RADIAL = 10,
+  SPLASH_VECTOR_OP_FILL = 11,        // SplashVectorFillFlags
+  SPLASH_VECTOR_OP_STROKE = 12,      // width, cap, join, miter limit
+  SPLASH_VECTOR_OP_PUSH_GROUP = 13,  //
+  SPLASH_VECTOR_OP_POP_GROUP = 14,   // alpha
+};
+
+enum SplashVectorFillFlags {
+  SPLASH_VECTOR_FILL_EVEN_ODD = 1 << 0,
+  // Keeps the path for the stroke that follows
+  SPLASH_VECTOR_FILL_PRESERVE = 1 << 1,
+};
+
+// Reads the logical size of the image. Returns FALSE if |data| is not a
+// display list this version can replay.
+gboolean splash_vector_get_size(const guint8* data,
+                                gsize size,
+                                int* width,
+                                int* height,
+                                GError** error);
+
+// Replays the display list on |cr|, whose user space is mapped to the
+// logical pixels of the image. The state of |cr| is restored afterwards.
+//
+// Returns FALSE if the list is malformed, in which case it may have been
+// partly drawn.
+gboolean splash_vector_render(const guint8* data,
+                              gsize size,
+                              cairo_t* cr,
+                              GError** error);
+
+G_END_DECLS
+
+#endif  // FLUTTER_PLUGIN_NATIVE_SPLASH_SCREEN_LINUX_SPLASH_VECTOR_H_
@@ -0,0 +1,316 @@
+// Checks that splash_asset accepts well formed `.nss` files and rejects
+// truncated, inconsistent or corrupted ones with an error.
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "splash_asset.h"
+#include "splash_pixels.h"
+
+namespace {
+
+// Header fields, in file order, after the magic.
+struct AssetFields {
+  uint32_t version = SPLASH_ASSET_VERSION;
+  uint32_t format = SPLASH_PIXEL_FORMAT_ARGB32;
+  uint32_t compression = SPLASH_ASSET_COMPRESSION_NONE;
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t offset_x = 0;
+  int32_t offset_y = 0;
+  int32_t canvas_width = 0;
+  int32_t canvas_height = 0;
+  uint32_t palette_size = 0;
+  uint32_t data_offset = 0;
+  uint32_t data_size = 0;
+  uint32_t raw_size = 0;
+  uint32_t checksum = 0;
+  uint32_t reserved = 0;
+};
+
+static_assert(sizeof(AssetFields) == 60,
+              "The fields follow the magic in the 64 bytes header");
+
+uint32_t fnv1a(const std::vector<uint8_t>& data) {
+  uint32_t hash = 0x811C9DC5u;
+  for (uint8_t byte : data) {
+    hash = (hash ^ byte) * 0x01000193u;
+  }
+  return hash;
+}
+
+std::vector<uint8_t> compress(const std::vector<uint8_t>& data) {
+  GConverter* converter = G_CONVERTER(
+      g_zlib_compressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB, -1));
+  std::vector<uint8_t> out(data.size() * 2 + 64);
+  gsize bytes_read = 0;
+  gsize bytes_written = 0;
+  GConverterResult result = g_converter_convert(
+      converter, data.data(), data.size(), out.data(), out.size(),
+      G_CONVERTER_INPUT_AT_END, &bytes_read, &bytes_written, nullptr);
+  g_object_unref(converter);
+  out.resize(result == G_CONVERTER_FINISHED ? bytes_written : 0);
+  return out;
+}
+
+// A file holding |pixels|, |fields| only needs the image description and
+// the compression.
+struct Asset {
+  AssetFields fields;
+  std::vector<uint32_t> palette;
+  std::vector<uint8_t> pixels;
+
+  // Lays out a valid file, compressing |pixels| if needed.
+  std::vector<uint8_t> build() {
+    return build(fields.compression == SPLASH_ASSET_COMPRESSION_ZLIB
+                     ? compress(pixels)
+                     : pixels);
+  }
+
+  // Lays out a file storing |data| in place of the pixels.
+  std::vector<uint8_t> build(const std::vector<uint8_t>& data) {
+    fields.palette_size = (uint32_t)palette.size();
+    fields.data_offset = (uint32_t)((64 + palette.size() * 4 + 4095) & ~4095);
+    fields.data_size = (uint32_t)data.size();
+    fields.raw_size = (uint32_t)pixels.size();
+    fields.checksum = fnv1a(data);
+
+    std::vector<uint8_t> file(fields.data_offset + data.size(), 0);
+    memcpy(file.data(), "NSSA", 4);
+    memcpy(file.data() + 4, &fields, sizeof(fields));
+    if (!palette.empty()) {
+      memcpy(file.data() + 64, palette.data(), palette.size() * 4);
+    }
+    if (!data.empty()) {
+      memcpy(file.data() + fields.data_offset, data.data(), data.size());
+    }
+    return file;
+  }
+};
+
+// Overwrites the header field at |offset| in AssetFields.
+void patch(std::vector<uint8_t>* file, size_t offset, uint32_t value) {
+  memcpy(file->data() + 4 + offset, &value, sizeof(value));
+}
+
+Asset argb_asset(int width, int height) {
+  Asset asset;
+  asset.fields.width = width;
+  asset.fields.height = height;
+  asset.fields.canvas_width = width * 2;
+  asset.fields.canvas_height = height * 2;
+  asset.fields.offset_x = width / 2;
+  asset.fields.offset_y = height / 2;
+  asset.pixels.resize((size_t)width * height * 4);
+  for (size_t i = 0; i < asset.pixels.size(); i++) {
+    asset.pixels[i] = (uint8_t)(i * 7 + i / 13);
+  }
+  return asset;
+}
+
+Asset indexed_asset(int width, int height, int palette_size) {
+  Asset asset;
+  asset.fields.format = SPLASH_PIXEL_FORMAT_INDEXED8;
+  asset.fields.width = width;
+  asset.fields.height = height;
+  for (int i = 0; i < palette_size; i++) {
+    asset.palette.push_back(0xFF000000u | (uint32_t)i * 0x010203u);
+  }
+  asset.pixels.resize((size_t)width * height);
+  for (size_t i = 0; i < asset.pixels.size(); i++) {
+    asset.pixels[i] = (uint8_t)(i % palette_size);
+  }
+  return asset;
+}
+
+// Parses |file| and checks that it matches |asset|.
+bool check_loads(const char* name,
+                 const std::vector<uint8_t>& file,
+                 const Asset& asset) {
+  GError* error = nullptr;
+  SplashAsset* loaded =
+      splash_asset_new_from_data(file.data(), file.size(), &error);
+  if (loaded == nullptr) {
+    fprintf(stderr, "FAIL %s: rejected with \"%s\"\n", name, error->message);
+    g_error_free(error);
+    return false;
+  }
+
+  const SplashImage* image = splash_asset_get_image(loaded);
+  const AssetFields& fields = asset.fields;
+  const bool match =
+      image->format == (int)fields.format && image->width == fields.width &&
+      image->height == fields.height && image->offset_x == fields.offset_x &&
+      image->offset_y == fields.offset_y &&
+      image->canvas_width == fields.canvas_width &&
+      image->canvas_height == fields.canvas_height &&
+      image->palette_size == (int)asset.palette.size() &&
+      (asset.palette.empty()
+           ? image->palette == nullptr
+           : memcmp(image->palette, asset.palette.data(),
+                    asset.palette.size() * 4) == 0) &&
+      memcmp(image->pixels, asset.pixels.data(), asset.pixels.size()) == 0;
+  splash_asset_free(loaded);
+  if (!match) {
+    fprintf(stderr, "FAIL %s: image differs from the file\n", name);
+  }
+  return match;
+}
+
+// Parses |file| and checks that it is rejected with an error.
+bool check_rejects(const char* name, const std::vector<uint8_t>& file) {
+  GError* error = nullptr;
+  SplashAsset* loaded =
+      splash_asset_new_from_data(file.data(), file.size(), &error);
+  if (loaded != nullptr || error == nullptr) {
+    fprintf(stderr, "FAIL %s: %s\n", name,
+            loaded != nullptr ? "accepted" : "rejected without an error");
+    splash_asset_free(loaded);
+    return false;
+  }
+  g_error_free(error);
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  int failures = 0;
+
+  // Well formed files
+  Asset argb = argb_asset(37, 21);
+  const std::vector<uint8_t> argb_file = argb.build();
+  failures += !check_loads("ARGB", argb_file, argb);
+
+  Asset indexed = indexed_asset(50, 9, 256);
+  failures += !check_loads("indexed", indexed.build(), indexed);
+
+  Asset zlib = argb_asset(64, 48);
+  zlib.fields.compression = SPLASH_ASSET_COMPRESSION_ZLIB;
+  const std::vector<uint8_t> zlib_file = zlib.build();
+  failures += !check_loads("zlib", zlib_file, zlib);
+
+  // Truncated files
+  failures += !check_rejects("empty file", {});
+  failures += !check_rejects(
+      "truncated header",
+      std::vector<uint8_t>(argb_file.begin(), argb_file.begin() + 63));
+  failures += !check_rejects(
+      "truncated data",
+      std::vector<uint8_t>(argb_file.begin(), argb_file.end() - 1));
+
+  // Header inconsistent with the file
+  std::vector<uint8_t> file = argb_file;
+  file[0] = 'X';
+  failures += !check_rejects("bad magic", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, version), SPLASH_ASSET_VERSION + 1);
+  failures += !check_rejects("unsupported version", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, format), SPLASH_PIXEL_FORMAT_VECTOR + 1);
+  failures += !check_rejects("unknown pixel format", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, width), (uint32_t)-37);
+  failures += !check_rejects("negative width", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, compression),
+        SPLASH_ASSET_COMPRESSION_ZLIB + 1);
+  failures += !check_rejects("unknown compression", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, data_size), argb.fields.data_size + 4);
+  failures += !check_rejects("data size past the end of file", file);
+
+  // The offset and size would wrap around in 32 bits
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, data_offset), 0xFFFFFFFCu);
+  failures += !check_rejects("data offset past the end of file", file);
+
+  file = argb_file;
+  patch(&file, offsetof(AssetFields, raw_size), argb.fields.raw_size - 4);
+  failures += !check_rejects("raw size not matching the image", file);
+
+  Asset large_palette = indexed_asset(8, 8, 256);
+  large_palette.palette.push_back(0xFFFFFFFFu);
+  failures += !check_rejects("palette of 257 entries", large_palette.build());
+
+  Asset overlapping = indexed_asset(8, 8, 256);
+  file = overlapping.build();
+  patch(&file, offsetof(AssetFields, data_offset), 64);
+  failures += !check_rejects("data overlapping the palette", file);
+
+  // Corrupted data
+  file = argb_file;
+  file.back() ^= 0x01;
+  failures += !check_rejects("checksum mismatch", file);
+
+  Asset corrupted = argb_asset(8, 8);
+  corrupted.fields.compression = SPLASH_ASSET_COMPRESSION_ZLIB;
+  failures += !check_rejects(
+      "invalid zlib data",
+      corrupted.build(std::vector<uint8_t>(corrupted.pixels.size(), 0x5A)));
+
+  std::vector<uint8_t> stream = compress(corrupted.pixels);
+  stream.resize(stream.size() / 2);
+  failures += !check_rejects("truncated zlib data", corrupted.build(stream));
+
+  // Inflates to more bytes than the image holds
+  stream = compress(corrupted.pixels);
+  corrupted.pixels.resize(corrupted.pixels.size() / 2);
+  corrupted.fields.height /= 2;
+  failures += !check_rejects("zlib data longer than the image",
+                             corrupted.build(stream));
+
+  // Files are mapped by path
+  gchar* path = nullptr;
+  GError* error = nullptr;
+  gint fd = g_file_open_tmp("splash_asset_test-XXXXXX.nss", &path, &error);
+  if (fd < 0 || !g_file_set_contents(path,
+                                     reinterpret_cast<const gchar*>(
+                                         zlib_file.data()),
+                                     zlib_file.size(), &error)) {
+    fprintf(stderr, "FAIL temporary file: %s\n", error->message);
+    g_clear_error(&error);
+    failures++;
+  } else {
+    SplashAsset* opened = splash_asset_open(path, &error);
+    if (opened == nullptr ||
+        memcmp(splash_asset_get_image(opened)->pixels, zlib.pixels.data(),
+               zlib.pixels.size()) != 0) {
+      fprintf(stderr, "FAIL mapped file: %s\n",
+              error != nullptr ? error->message : "image differs");
+      g_clear_error(&error);
+      failures++;
+    }
+    splash_asset_free(opened);
+  }
+  if (fd >= 0) {
+    close(fd);
+    g_unlink(path);
+  }
+  g_free(path);
+
+  if (splash_asset_open("/nonexistent/splash.nss", &error) != nullptr ||
+      error == nullptr) {
+    fprintf(stderr, "FAIL missing file: no error\n");
+    failures++;
+  }
+  g_clear_error(&error);
+
+  if (failures > 0) {
+    return 1;
+  }
+  printf("splash_asset: valid files load, invalid ones are rejected\n");
+  return 0;
+}
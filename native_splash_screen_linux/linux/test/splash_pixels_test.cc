@@ -0,0 +1,182 @@
+// Checks that the AVX2 and scalar palette expanders produce the same pixels,
+// and that tiled images are assembled and clipped like their source.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "splash_pixels.h"
+
+namespace {
+
+// Expands |indices| one at a time, the way the kernels are documented to.
+std::vector<uint32_t> expand_reference(const std::vector<uint8_t>& indices,
+                                       const uint32_t* palette,
+                                       int palette_size) {
+  std::vector<uint32_t> pixels(indices.size());
+  for (size_t i = 0; i < indices.size(); i++) {
+    pixels[i] = palette != nullptr && indices[i] < palette_size
+                    ? palette[indices[i]]
+                    : 0x00000000;
+  }
+  return pixels;
+}
+
+// Expands |indices| into a buffer with a guard pixel past its end, and
+// returns false if the guard was written.
+bool expand(const std::vector<uint8_t>& indices,
+            const uint32_t* palette,
+            int palette_size,
+            bool simd,
+            std::vector<uint32_t>* pixels) {
+  pixels->assign(indices.size() + 1, 0xABABABABu);
+  splash_pixels_expand_palette_full(indices.data(), indices.size(), palette,
+                                    palette_size, pixels->data(), simd);
+  const bool guard_intact = pixels->back() == 0xABABABABu;
+  pixels->pop_back();
+  return guard_intact;
+}
+
+int check_palette(std::mt19937* random) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint32_t> palette(300);
+  for (uint32_t& color : palette) {
+    color = (*random)();
+  }
+
+  int failures = 0;
+  for (int palette_size : {0, 1, 17, 255, 256, 300}) {
+    // Every tail length of the 8 wide gathers, then a large odd run
+    std::vector<size_t> counts;
+    for (size_t count = 0; count <= 40; count++) {
+      counts.push_back(count);
+    }
+    counts.push_back(4099);
+
+    for (size_t count : counts) {
+      std::vector<uint8_t> indices(count);
+      for (uint8_t& index : indices) {
+        index = (uint8_t)byte(*random);
+      }
+      // Palettes larger than 256 entries are clamped
+      const std::vector<uint32_t> expected = expand_reference(
+          indices, palette.data(), palette_size > 256 ? 256 : palette_size);
+
+      for (bool simd : {false, true}) {
+        std::vector<uint32_t> actual;
+        if (!expand(indices, palette.data(), palette_size, simd, &actual) ||
+            actual != expected) {
+          fprintf(stderr,
+                  "FAIL palette of %d, %zu indices: %s expander differs from "
+                  "the reference\n",
+                  palette_size, count, simd ? "AVX2" : "scalar");
+          failures++;
+        }
+      }
+    }
+  }
+
+  // Without a palette every index expands to transparent
+  std::vector<uint8_t> indices = {0, 1, 2, 3, 4, 5, 6, 7, 8, 255};
+  for (bool simd : {false, true}) {
+    std::vector<uint32_t> actual;
+    if (!expand(indices, nullptr, 16, simd, &actual) ||
+        actual != std::vector<uint32_t>(indices.size(), 0)) {
+      fprintf(stderr, "FAIL missing palette: %s expander is not transparent\n",
+              simd ? "AVX2" : "scalar");
+      failures++;
+    }
+  }
+  return failures;
+}
+
+int check_tiles(std::mt19937* random) {
+  static const struct {
+    int width;
+    int height;
+    int tile_size;
+  } kSizes[] = {
+      {1, 1, 8}, {8, 8, 8}, {70, 45, 16}, {33, 64, 32}, {100, 3, 7},
+  };
+  static const uint32_t kColors[] = {0xFF102030u, 0x80402010u, 0x00000000u};
+  const int color_count = (int)(sizeof(kColors) / sizeof(kColors[0]));
+
+  int failures = 0;
+  for (const auto& size : kSizes) {
+    const int tile_size = size.tile_size;
+    const int columns = (size.width + tile_size - 1) / tile_size;
+    const int rows = (size.height + tile_size - 1) / tile_size;
+    const size_t tile_pixels = (size_t)tile_size * tile_size;
+
+    // Every other tile is solid, some of them with a color past the table
+    std::vector<uint32_t> map((size_t)columns * rows);
+    std::vector<uint32_t> tiles;
+    for (size_t i = 0; i < map.size(); i++) {
+      if (i % 2 == 1) {
+        map[i] = SPLASH_TILE_SOLID | (uint32_t)(i / 2 % (color_count + 2));
+        continue;
+      }
+      map[i] = (uint32_t)(tiles.size() / tile_pixels);
+      for (size_t p = 0; p < tile_pixels; p++) {
+        tiles.push_back((*random)());
+      }
+    }
+
+    // Pixel by pixel, transparent for colors past the table
+    std::vector<uint32_t> expected((size_t)size.width * size.height);
+    for (int y = 0; y < size.height; y++) {
+      for (int x = 0; x < size.width; x++) {
+        const uint32_t entry =
+            map[(size_t)(y / tile_size) * columns + x / tile_size];
+        uint32_t color;
+        if (entry & SPLASH_TILE_SOLID) {
+          const uint32_t index = entry & ~SPLASH_TILE_SOLID;
+          color = (int)index < color_count ? kColors[index] : 0x00000000;
+        } else {
+          color = tiles[entry * tile_pixels +
+                        (size_t)(y % tile_size) * tile_size + x % tile_size];
+        }
+        expected[(size_t)y * size.width + x] = color;
+      }
+    }
+
+    // Rows are padded so that writes past the clipped edges show up
+    const int stride = size.width * 4 + 12;
+    std::vector<uint8_t> out((size_t)stride * size.height, 0xAB);
+    splash_pixels_decode_tiles(
+        map.data(), tile_size, reinterpret_cast<const uint8_t*>(tiles.data()),
+        kColors, color_count, size.width, size.height, out.data(), stride);
+
+    bool match = true;
+    for (int y = 0; y < size.height && match; y++) {
+      const uint8_t* row = out.data() + (size_t)y * stride;
+      match = memcmp(row, expected.data() + (size_t)y * size.width,
+                     (size_t)size.width * 4) == 0;
+      for (int i = size.width * 4; i < stride && match; i++) {
+        match = row[i] == 0xAB;
+      }
+    }
+    if (!match) {
+      fprintf(stderr, "FAIL %dx%d in %d pixels tiles: differs from the map\n",
+              size.width, size.height, tile_size);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  int failures = check_palette(&random) + check_tiles(&random);
+
+  if (failures > 0) {
+    return 1;
+  }
+  printf("splash_pixels: palette expanders and tile decoder match\n");
+  return 0;
+}
@@ -0,0 +1,112 @@
+// Times splash_scaler on the sizes a splash image is resampled at, with every
+// filter, with and without SIMD and over several thread counts.
+//
+// Usage: splash_scaler_benchmark [iterations]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "splash_scaler.h"
+
+namespace {
+
+// Returns the median time of |iterations| runs, in microseconds.
+double time_resample(const std::vector<uint8_t>& src,
+                     int src_width,
+                     int src_height,
+                     std::vector<uint8_t>* dst,
+                     int dst_width,
+                     int dst_height,
+                     SplashScaleFilter filter,
+                     int threads,
+                     bool simd,
+                     int iterations) {
+  std::vector<double> times;
+  for (int i = 0; i < iterations; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    splash_scaler_resample_full(src.data(), src_width, src_height,
+                                src_width * 4, dst->data(), dst_width,
+                                dst_height, dst_width * 4, filter, threads,
+                                simd);
+    const auto end = std::chrono::steady_clock::now();
+    times.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::max(atoi(argv[1]), 1) : 15;
+
+  // Logical size of a typical splash image to its 1.25x, 1.5x and 2x
+  // variants, and a 2x asset shrunk back to 1x
+  static const struct {
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+  } kSizes[] = {
+      {256, 256, 320, 320},
+      {400, 300, 600, 450},
+      {500, 500, 1000, 1000},
+      {1000, 1000, 500, 500},
+      {1920, 1080, 2880, 1620},
+  };
+  static const struct {
+    SplashScaleFilter filter;
+    const char* name;
+  } kFilters[] = {
+      {SPLASH_SCALE_FILTER_BOX, "box"},
+      {SPLASH_SCALE_FILTER_BILINEAR, "bilinear"},
+      {SPLASH_SCALE_FILTER_LANCZOS2, "lanczos2"},
+  };
+  static const int kThreads[] = {1, 2, 4, 8};
+
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int> byte(0, 255);
+
+  printf("%-22s %-9s %12s", "size", "filter", "scalar (us)");
+  for (int threads : kThreads) {
+    printf(" %9s%-3d", "simd x", threads);
+  }
+  printf("\n");
+
+  for (const auto& size : kSizes) {
+    std::vector<uint8_t> src((size_t)size.src_width * size.src_height * 4);
+    for (size_t i = 0; i < src.size(); i += 4) {
+      const int alpha = byte(random);
+      for (int c = 0; c < 3; c++) {
+        src[i + c] = (uint8_t)(byte(random) * alpha / 255);
+      }
+      src[i + 3] = (uint8_t)alpha;
+    }
+    std::vector<uint8_t> dst((size_t)size.dst_width * size.dst_height * 4);
+
+    char label[32];
+    snprintf(label, sizeof(label), "%dx%d -> %dx%d", size.src_width,
+             size.src_height, size.dst_width, size.dst_height);
+    for (const auto& filter : kFilters) {
+      printf("%-22s %-9s %12.0f", label, filter.name,
+             time_resample(src, size.src_width, size.src_height, &dst,
+                           size.dst_width, size.dst_height, filter.filter, 1,
+                           false, iterations));
+      for (int threads : kThreads) {
+        printf(" %12.0f",
+               time_resample(src, size.src_width, size.src_height, &dst,
+                             size.dst_width, size.dst_height, filter.filter,
+                             threads, true, iterations));
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,143 @@
+// Checks that the SIMD kernels and the bands of splash_scaler produce the
+// same pixels as the scalar kernels on a single thread.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "splash_scaler.h"
+
+namespace {
+
+// Fills |pixels| with random premultiplied pixels, and a few transparent and
+// opaque runs so that the clamping to alpha is exercised.
+void fill_pixels(std::vector<uint8_t>* pixels, std::mt19937* random) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (size_t i = 0; i < pixels->size(); i += 4) {
+    int alpha = byte(*random);
+    if (i % 97 < 12) {
+      alpha = 0;
+    } else if (i % 89 < 12) {
+      alpha = 255;
+    }
+    for (int c = 0; c < 3; c++) {
+      (*pixels)[i + c] = (uint8_t)(alpha == 0 ? 0 : byte(*random) % (alpha + 1));
+    }
+    (*pixels)[i + 3] = (uint8_t)alpha;
+  }
+}
+
+const char* filter_name(SplashScaleFilter filter) {
+  switch (filter) {
+    case SPLASH_SCALE_FILTER_BOX:
+      return "box";
+    case SPLASH_SCALE_FILTER_BILINEAR:
+      return "bilinear";
+    case SPLASH_SCALE_FILTER_LANCZOS2:
+      return "lanczos2";
+  }
+  return "unknown";
+}
+
+// Resamples with |threads| and |simd|, into a destination whose rows are
+// padded, and returns false if the padding was written.
+bool resample(const std::vector<uint8_t>& src,
+              int src_width,
+              int src_height,
+              int dst_width,
+              int dst_height,
+              SplashScaleFilter filter,
+              int threads,
+              bool simd,
+              std::vector<uint8_t>* dst) {
+  const int dst_stride = dst_width * 4 + 12;
+  dst->assign((size_t)dst_stride * dst_height, 0xAB);
+  if (!splash_scaler_resample_full(src.data(), src_width, src_height,
+                                   src_width * 4, dst->data(), dst_width,
+                                   dst_height, dst_stride, filter, threads,
+                                   simd)) {
+    return false;
+  }
+  for (int y = 0; y < dst_height; y++) {
+    for (int i = dst_width * 4; i < dst_stride; i++) {
+      if ((*dst)[(size_t)y * dst_stride + i] != 0xAB) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  static const struct {
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+  } kSizes[] = {
+      {1, 1, 3, 3},         {7, 5, 13, 11},       {64, 64, 128, 128},
+      {101, 67, 150, 100},  {300, 200, 601, 401}, {640, 480, 213, 161},
+      {512, 512, 511, 513}, {33, 900, 67, 450},
+  };
+  static const SplashScaleFilter kFilters[] = {
+      SPLASH_SCALE_FILTER_BOX,
+      SPLASH_SCALE_FILTER_BILINEAR,
+      SPLASH_SCALE_FILTER_LANCZOS2,
+  };
+
+  std::mt19937 random(1234);
+  int failures = 0;
+  for (const auto& size : kSizes) {
+    std::vector<uint8_t> src((size_t)size.src_width * size.src_height * 4);
+    fill_pixels(&src, &random);
+
+    for (SplashScaleFilter filter : kFilters) {
+      std::vector<uint8_t> expected;
+      std::vector<uint8_t> actual;
+      if (!resample(src, size.src_width, size.src_height, size.dst_width,
+                    size.dst_height, filter, 1, false, &expected)) {
+        fprintf(stderr, "FAIL %dx%d -> %dx%d %s: scalar resampling failed\n",
+                size.src_width, size.src_height, size.dst_width,
+                size.dst_height, filter_name(filter));
+        failures++;
+        continue;
+      }
+
+      for (int threads : {1, 3, 8}) {
+        if (!resample(src, size.src_width, size.src_height, size.dst_width,
+                      size.dst_height, filter, threads, true, &actual) ||
+            actual != expected) {
+          fprintf(stderr,
+                  "FAIL %dx%d -> %dx%d %s: %d threads with SIMD differ from "
+                  "the scalar kernels\n",
+                  size.src_width, size.src_height, size.dst_width,
+                  size.dst_height, filter_name(filter), threads);
+          failures++;
+        }
+      }
+    }
+  }
+
+  // Invalid sizes leave the destination untouched
+  uint8_t pixel[4] = {1, 2, 3, 4};
+  uint8_t out[4] = {0, 0, 0, 0};
+  if (splash_scaler_resample(pixel, 0, 1, 4, out, 1, 1, 4,
+                             SPLASH_SCALE_FILTER_BOX) ||
+      splash_scaler_resample_full(pixel, 1, 1, 4, out, 1, 1, 4,
+                                  SPLASH_SCALE_FILTER_BOX, 0, true) ||
+      memcmp(out, "\0\0\0\0", 4) != 0) {
+    fprintf(stderr, "FAIL invalid sizes are not rejected\n");
+    failures++;
+  }
+
+  if (failures > 0) {
+    return 1;
+  }
+  printf("splash_scaler: SIMD and scalar kernels match\n");
+  return 0;
+}
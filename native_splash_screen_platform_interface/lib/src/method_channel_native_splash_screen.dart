@@ -16,4 +16,17 @@ class MethodChannelNativeSplashScreen extends NativeSplashScreenPlatform {
       "effect": animation.name,
     });
   }
+
+  @override
+  Future<Map<String, int>> getMetrics() async {
+    try {
+      final metrics = await _channel.invokeMapMethod<String, int>(
+        'getMetrics',
+      );
+      return metrics ?? <String, int>{};
+    } on MissingPluginException {
+      // Platforms that do not record any metrics
+      return <String, int>{};
+    }
+  }
 }
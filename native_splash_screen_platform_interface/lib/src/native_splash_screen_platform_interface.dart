@@ -27,4 +27,10 @@ abstract class NativeSplashScreenPlatform extends PlatformInterface {
   Future<void> close({required CloseAnimation animation}) {
     throw UnimplementedError('close() has not been implemented.');
   }
+
+  /// Returns the metrics recorded by the native splash screen, such as
+  /// the resident memory before and after its resources were released.
+  Future<Map<String, int>> getMetrics() {
+    throw UnimplementedError('getMetrics() has not been implemented.');
+  }
 }
@@ -28,6 +28,13 @@ extern const uint32_t* native_splash_screen_image_pixels;
 extern int native_splash_screen_image_width;
 extern int native_splash_screen_image_height;
 
+// Placement of the image inside its canvas, once its transparent borders
+// have been trimmed
+extern int native_splash_screen_image_offset_x;
+extern int native_splash_screen_image_offset_y;
+extern int native_splash_screen_image_canvas_width;
+extern int native_splash_screen_image_canvas_height;
+
 // Function declarations for splash screen operations
 FLUTTER_PLUGIN_EXPORT void ShowSplashScreen();
 FLUTTER_PLUGIN_EXPORT void CloseSplashScreen(const std::string& effect);
@@ -133,31 +133,40 @@ static void RenderSplashContent(uint32_t* pixels) {
   if (!pixels || !native_splash_screen_image_pixels)
     return;
 
+  // Center the untrimmed canvas, then place the image inside of it
   int x_offset =
-      (native_splash_screen_width - native_splash_screen_image_width) / 2;
+      (native_splash_screen_width - native_splash_screen_image_canvas_width) /
+          2 +
+      native_splash_screen_image_offset_x;
   int y_offset =
-      (native_splash_screen_height - native_splash_screen_image_height) / 2;
+      (native_splash_screen_height - native_splash_screen_image_canvas_height) /
+          2 +
+      native_splash_screen_image_offset_y;
   if (x_offset < 0)
     x_offset = 0;
   if (y_offset < 0)
     y_offset = 0;
 
-  for (int y = 0; y < native_splash_screen_image_height; y++) {
-    for (int x = 0; x < native_splash_screen_image_width; x++) {
-      int dst_x = x + x_offset;
-      int dst_y = y + y_offset;
-      if (dst_x >= native_splash_screen_width ||
-          dst_y >= native_splash_screen_height)
-        continue;
-
-      int src_index = y * native_splash_screen_image_width + x;
-      int dst_index = dst_y * native_splash_screen_width + dst_x;
-
-      uint32_t srcPixel = native_splash_screen_image_pixels[src_index];
+  // Clip the image rectangle to the window once, instead of per pixel
+  int copy_width = native_splash_screen_image_width;
+  int copy_height = native_splash_screen_image_height;
+  if (x_offset + copy_width > native_splash_screen_width)
+    copy_width = native_splash_screen_width - x_offset;
+  if (y_offset + copy_height > native_splash_screen_height)
+    copy_height = native_splash_screen_height - y_offset;
+
+  for (int y = 0; y < copy_height; y++) {
+    const uint32_t* src =
+        native_splash_screen_image_pixels + y * native_splash_screen_image_width;
+    uint32_t* dst =
+        pixels + (y + y_offset) * native_splash_screen_width + x_offset;
+
+    for (int x = 0; x < copy_width; x++) {
+      uint32_t srcPixel = src[x];
       if (((srcPixel >> 24) & 0xFF) == 0)
         continue;
 
-      pixels[dst_index] = ConvertARGBtoPremultipliedBGRA(srcPixel);
+      dst[x] = ConvertARGBtoPremultipliedBGRA(srcPixel);
     }
   }
 }